@@ -3,6 +3,7 @@
 HEADERS +=  \
         io/qabstractfileengine_p.h \
         io/qbuffer.h \
+        io/qcompressiondevice_p.h \
         io/qdataurl_p.h \
         io/qdebug.h \
         io/qdebug_p.h \
@@ -48,6 +49,7 @@ HEADERS +=  \
 SOURCES += \
         io/qabstractfileengine.cpp \
         io/qbuffer.cpp \
+        io/qcompressiondevice.cpp \
         io/qdataurl.cpp \
         io/qtldurl.cpp \
         io/qdebug.cpp \
@@ -0,0 +1,536 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qcompressiondevice_p.h"
+#include "private/qiodevice_p.h"
+
+#include <limits>
+
+#include <zlib.h>
+
+QT_BEGIN_NAMESPACE
+
+enum { DefaultBufferSize = 64 * 1024 };
+
+class QCompressionDevicePrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QCompressionDevice)
+
+public:
+    QCompressionDevicePrivate()
+        : device(nullptr), format(QCompressionDevice::Zlib), level(Z_DEFAULT_COMPRESSION),
+          bufferSize(DefaultBufferSize), bufferUsed(0), streamOpen(false),
+          streamEnded(false), outputPending(false), openedDevice(false)
+    {
+        memset(&zstream, 0, sizeof(zstream));
+    }
+
+    int windowBits() const;
+    bool deflateStep(int flush);
+    bool writeBuffer();
+    void setZlibError(int ret);
+
+    QIODevice *device;
+    QCompressionDevice::Format format;
+    int level;
+    int bufferSize;
+
+    // compressed data: read from the device when decompressing and
+    // waiting to be written to the device when compressing
+    QByteArray buffer;
+    int bufferUsed;
+
+    z_stream zstream;
+    bool streamOpen;
+    bool streamEnded;
+    bool outputPending;
+    bool openedDevice;
+};
+
+int QCompressionDevicePrivate::windowBits() const
+{
+    switch (format) {
+    case QCompressionDevice::Zlib:
+        return MAX_WBITS;
+    case QCompressionDevice::Gzip:
+        return MAX_WBITS + 16;
+    case QCompressionDevice::RawDeflate:
+        return -MAX_WBITS;
+    }
+    Q_UNREACHABLE();
+    return MAX_WBITS;
+}
+
+void QCompressionDevicePrivate::setZlibError(int ret)
+{
+    Q_Q(QCompressionDevice);
+    if (zstream.msg)
+        q->setErrorString(QString::fromLatin1(zstream.msg));
+    else if (ret == Z_MEM_ERROR)
+        q->setErrorString(QCompressionDevice::tr("Not enough memory"));
+    else
+        q->setErrorString(QCompressionDevice::tr("Invalid compressed data"));
+}
+
+/*
+    Writes out the compressed data collected in the buffer.
+*/
+bool QCompressionDevicePrivate::writeBuffer()
+{
+    Q_Q(QCompressionDevice);
+    const char *data = buffer.constData();
+    while (bufferUsed > 0) {
+        const qint64 written = device->write(data, bufferUsed);
+        if (written <= 0) {
+            q->setErrorString(device->errorString());
+            return false;
+        }
+        data += written;
+        bufferUsed -= int(written);
+    }
+    return true;
+}
+
+/*
+    Runs deflate() once over the pending input, writing the buffer out
+    whenever it fills up. Returns false on error.
+*/
+bool QCompressionDevicePrivate::deflateStep(int flush)
+{
+    zstream.next_out = reinterpret_cast<Bytef *>(buffer.data()) + bufferUsed;
+    zstream.avail_out = uInt(bufferSize - bufferUsed);
+    const int ret = deflate(&zstream, flush);
+    bufferUsed = bufferSize - int(zstream.avail_out);
+    if (ret == Z_STREAM_ERROR) {
+        setZlibError(ret);
+        return false;
+    }
+    if (ret == Z_STREAM_END)
+        streamEnded = true;
+    if (bufferUsed == bufferSize || (flush != Z_NO_FLUSH && zstream.avail_out != 0))
+        return writeBuffer();
+    return true;
+}
+
+/*!
+    \class QCompressionDevice
+    \inmodule QtCore
+    \internal
+    \reentrant
+    \brief The QCompressionDevice class compresses or decompresses the data
+    of another QIODevice as it is written or read.
+
+    QCompressionDevice wraps a QIODevice, such as a QFile, a QTcpSocket or a
+    QNetworkReply. Data written to a QCompressionDevice opened in
+    \l{QIODevice::}{WriteOnly} mode is compressed and written to the
+    underlying device. Data read from a QCompressionDevice opened in
+    \l{QIODevice::}{ReadOnly} mode is read from the underlying device and
+    decompressed. Unlike qCompress() and qUncompress(), neither the
+    compressed nor the uncompressed data has to be in memory all at once,
+    so payloads of any size can be processed with a fixed amount of memory.
+
+    The \l Format passed to the constructor selects the framing of the
+    compressed data. All formats use the deflate algorithm. Note that the
+    output of qCompress() is a zlib stream prefixed with the size of the
+    uncompressed data in four bytes; QCompressionDevice reads and writes
+    the zlib stream only.
+
+    The device can be used with QDataStream and QTextStream like any other
+    QIODevice:
+
+    \code
+    QFile file("data.gz");
+    QCompressionDevice compressor(&file, QCompressionDevice::Gzip);
+    compressor.open(QIODevice::WriteOnly);
+    QDataStream out(&compressor);
+    out << bigMap;
+    compressor.close();
+    \endcode
+
+    The compressed data is only complete after close() has been called.
+    flush() writes out all the data compressed so far without ending the
+    stream, for instance to send it over a network connection.
+
+    QCompressionDevice is sequential: it cannot be opened in
+    \l{QIODevice::}{ReadWrite} or \l{QIODevice::}{Append} mode, and it does
+    not support seek().
+
+    \sa qCompress(), qUncompress()
+*/
+
+/*!
+    \enum QCompressionDevice::Format
+
+    This enum describes the framing of the compressed data.
+
+    \value Zlib         A zlib stream, as described in RFC 1950.
+    \value Gzip         A gzip member, as described in RFC 1952. This is the
+                        format of \c .gz files and of the \c gzip HTTP
+                        content encoding.
+    \value RawDeflate   Deflate data without a header or checksum, as
+                        described in RFC 1951. This is the format of the
+                        entries of a ZIP archive.
+*/
+
+/*!
+    Constructs a QCompressionDevice that compresses data into, or
+    decompresses data from, \a device, using the given \a format and
+    \a parent.
+
+    QCompressionDevice does not take ownership of \a device.
+
+    \sa open()
+*/
+QCompressionDevice::QCompressionDevice(QIODevice *device, Format format, QObject *parent)
+    : QIODevice(*new QCompressionDevicePrivate, parent)
+{
+    Q_D(QCompressionDevice);
+    d->device = device;
+    d->format = format;
+}
+
+/*!
+    Destroys the QCompressionDevice, closing it first if necessary.
+*/
+QCompressionDevice::~QCompressionDevice()
+{
+    close();
+}
+
+/*!
+    Returns the device that the compressed data is read from or written to.
+*/
+QIODevice *QCompressionDevice::device() const
+{
+    Q_D(const QCompressionDevice);
+    return d->device;
+}
+
+/*!
+    Returns the format of the compressed data.
+*/
+QCompressionDevice::Format QCompressionDevice::format() const
+{
+    Q_D(const QCompressionDevice);
+    return d->format;
+}
+
+/*!
+    Sets the compression level to \a level, which ranges from 0 (no
+    compression) to 9 (most compression). The default, -1, lets zlib pick a
+    level that trades speed for size (currently 6).
+
+    The level only applies to compression, and must be set before the
+    device is opened.
+
+    \sa compressionLevel()
+*/
+void QCompressionDevice::setCompressionLevel(int level)
+{
+    Q_D(QCompressionDevice);
+    if (isOpen()) {
+        qWarning("QCompressionDevice::setCompressionLevel: Device is already open");
+        return;
+    }
+    d->level = qBound(-1, level, 9);
+}
+
+/*!
+    Returns the compression level.
+
+    \sa setCompressionLevel()
+*/
+int QCompressionDevice::compressionLevel() const
+{
+    Q_D(const QCompressionDevice);
+    return d->level;
+}
+
+/*!
+    Sets the size of the buffer for the compressed data to \a size bytes. The
+    default is 64 KiB.
+
+    When compressing, the compressed data is written to the underlying device
+    in pieces of this size. When decompressing, it is read from the device in
+    pieces of this size. The buffer size must be set before the device is
+    opened.
+
+    \sa bufferSize()
+*/
+void QCompressionDevice::setBufferSize(int size)
+{
+    Q_D(QCompressionDevice);
+    if (isOpen()) {
+        qWarning("QCompressionDevice::setBufferSize: Device is already open");
+        return;
+    }
+    d->bufferSize = qMax(size, 1);
+}
+
+/*!
+    Returns the size of the buffer for the compressed data.
+
+    \sa setBufferSize()
+*/
+int QCompressionDevice::bufferSize() const
+{
+    Q_D(const QCompressionDevice);
+    return d->bufferSize;
+}
+
+/*!
+    \reimp
+
+    Opens the device for compression if \a mode is
+    \l{QIODevice::}{WriteOnly}, and for decompression if it is
+    \l{QIODevice::}{ReadOnly}. If the underlying device is not open yet, it
+    is opened in the same mode, and closed again by close().
+*/
+bool QCompressionDevice::open(OpenMode mode)
+{
+    Q_D(QCompressionDevice);
+    if (isOpen()) {
+        qWarning("QCompressionDevice::open: Device is already open");
+        return false;
+    }
+    if (!d->device) {
+        qWarning("QCompressionDevice::open: No device");
+        return false;
+    }
+    const OpenMode direction = mode & ReadWrite;
+    if (direction == ReadWrite || direction == NotOpen || (mode & Append)) {
+        qWarning("QCompressionDevice::open: Only ReadOnly or WriteOnly is supported");
+        return false;
+    }
+
+    const OpenMode deviceMode = direction | (mode & Unbuffered);
+    if (!d->device->isOpen()) {
+        if (!d->device->open(deviceMode)) {
+            setErrorString(d->device->errorString());
+            return false;
+        }
+        d->openedDevice = true;
+    } else if ((d->device->openMode() & direction) != direction) {
+        qWarning("QCompressionDevice::open: The device is not open in a compatible mode");
+        return false;
+    }
+
+    int ret;
+    if (direction == ReadOnly)
+        ret = inflateInit2(&d->zstream, d->windowBits());
+    else
+        ret = deflateInit2(&d->zstream, d->level, Z_DEFLATED, d->windowBits(), 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) {
+        d->setZlibError(ret);
+        if (d->openedDevice) {
+            d->device->close();
+            d->openedDevice = false;
+        }
+        return false;
+    }
+
+    d->streamOpen = true;
+    d->streamEnded = false;
+    d->outputPending = false;
+    d->buffer.resize(d->bufferSize);
+    d->bufferUsed = 0;
+    if (direction == ReadOnly)
+        connect(d->device, &QIODevice::readyRead, this, &QIODevice::readyRead);
+    return QIODevice::open(mode);
+}
+
+/*!
+    \reimp
+
+    Ends the compressed stream, writes out all of the compressed data, and
+    closes the device. The underlying device is closed as well if open()
+    opened it.
+*/
+void QCompressionDevice::close()
+{
+    Q_D(QCompressionDevice);
+    if (!isOpen())
+        return;
+
+    if (openMode() & WriteOnly) {
+        d->zstream.next_in = nullptr;
+        d->zstream.avail_in = 0;
+        while (!d->streamEnded) {
+            if (!d->deflateStep(Z_FINISH))
+                break;
+        }
+        deflateEnd(&d->zstream);
+    } else {
+        disconnect(d->device, &QIODevice::readyRead, this, &QIODevice::readyRead);
+        inflateEnd(&d->zstream);
+    }
+    memset(&d->zstream, 0, sizeof(d->zstream));
+    d->streamOpen = false;
+    d->buffer.clear();
+    d->bufferUsed = 0;
+
+    QIODevice::close();
+    if (d->openedDevice) {
+        d->device->close();
+        d->openedDevice = false;
+    }
+}
+
+/*!
+    \reimp
+
+    Returns \c true: compressed data can only be read or written in order.
+*/
+bool QCompressionDevice::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+
+    When decompressing, returns \c true once the end of the compressed
+    stream has been reached and all of the data has been read, or when the
+    underlying device has no more data to decompress.
+*/
+bool QCompressionDevice::atEnd() const
+{
+    Q_D(const QCompressionDevice);
+    if (!QIODevice::atEnd())
+        return false;
+    if (!(openMode() & ReadOnly))
+        return true;
+    return d->streamEnded
+            || (!d->outputPending && d->zstream.avail_in == 0 && d->device->atEnd());
+}
+
+/*!
+    Writes all of the data compressed so far to the underlying device, so
+    that it can be decompressed by the receiver without waiting for the
+    end of the stream. Returns \c true on success.
+
+    This only affects a device opened for writing. Flushing often makes the
+    compression less effective.
+*/
+bool QCompressionDevice::flush()
+{
+    Q_D(QCompressionDevice);
+    if (!(openMode() & WriteOnly) || d->streamEnded)
+        return false;
+
+    d->zstream.next_in = nullptr;
+    d->zstream.avail_in = 0;
+    do {
+        if (!d->deflateStep(Z_SYNC_FLUSH))
+            return false;
+    } while (d->zstream.avail_out == 0);
+    return true;
+}
+
+/*!
+    \reimp
+*/
+qint64 QCompressionDevice::readData(char *data, qint64 maxlen)
+{
+    Q_D(QCompressionDevice);
+    qint64 total = 0;
+    while (total < maxlen && !d->streamEnded) {
+        if (d->zstream.avail_in == 0 && !d->outputPending) {
+            const qint64 read = d->device->read(d->buffer.data(), d->bufferSize);
+            if (read < 0) {
+                setErrorString(d->device->errorString());
+                return total ? total : qint64(-1);
+            }
+            if (read == 0) {
+                if (d->device->atEnd() && !d->device->isSequential()) {
+                    setErrorString(tr("Unexpected end of compressed data"));
+                    return total ? total : qint64(-1);
+                }
+                break; // wait for readyRead()
+            }
+            d->zstream.next_in = reinterpret_cast<Bytef *>(d->buffer.data());
+            d->zstream.avail_in = uInt(read);
+        }
+
+        const uInt chunk = uInt(qMin<qint64>(maxlen - total, std::numeric_limits<uInt>::max()));
+        d->zstream.next_out = reinterpret_cast<Bytef *>(data + total);
+        d->zstream.avail_out = chunk;
+        const int ret = inflate(&d->zstream, Z_NO_FLUSH);
+        total += chunk - d->zstream.avail_out;
+        d->outputPending = d->zstream.avail_out == 0;
+
+        if (ret == Z_STREAM_END) {
+            d->streamEnded = true;
+        } else if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR
+                   || ret == Z_STREAM_ERROR) {
+            d->setZlibError(ret);
+            return total ? total : qint64(-1);
+        }
+    }
+    return total;
+}
+
+/*!
+    \reimp
+*/
+qint64 QCompressionDevice::writeData(const char *data, qint64 len)
+{
+    Q_D(QCompressionDevice);
+    if (d->streamEnded)
+        return -1;
+
+    qint64 remaining = len;
+    while (remaining > 0) {
+        const uInt chunk = uInt(qMin<qint64>(remaining, std::numeric_limits<uInt>::max()));
+        d->zstream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        d->zstream.avail_in = chunk;
+        while (d->zstream.avail_in > 0) {
+            if (!d->deflateStep(Z_NO_FLUSH))
+                return -1;
+        }
+        data += chunk;
+        remaining -= chunk;
+    }
+    return len;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qcompressiondevice_p.cpp"
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QCOMPRESSIONDEVICE_P_H
+#define QCOMPRESSIONDEVICE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qiodevice.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QCompressionDevicePrivate;
+
+class Q_CORE_EXPORT QCompressionDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        Zlib,
+        Gzip,
+        RawDeflate
+    };
+    Q_ENUM(Format)
+
+    explicit QCompressionDevice(QIODevice *device, Format format = Zlib, QObject *parent = nullptr);
+    ~QCompressionDevice();
+
+    QIODevice *device() const;
+    Format format() const;
+
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
+    void setBufferSize(int size);
+    int bufferSize() const;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    bool atEnd() const override;
+
+    bool flush();
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    Q_DECLARE_PRIVATE(QCompressionDevice)
+    Q_DISABLE_COPY(QCompressionDevice)
+};
+
+QT_END_NAMESPACE
+
+#endif // QCOMPRESSIONDEVICE_P_H
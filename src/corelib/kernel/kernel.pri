@@ -8,6 +8,7 @@ HEADERS += \
         kernel/qdeadlinetimer_p.h \
         kernel/qelapsedtimer.h \
         kernel/qeventloop.h\
+        kernel/qeventloopinstrumentation_p.h \
         kernel/qpointer.h \
         kernel/qcorecmdlineargs_p.h \
         kernel/qcoreapplication.h \
@@ -52,6 +53,7 @@ SOURCES += \
         kernel/qdeadlinetimer.cpp \
         kernel/qelapsedtimer.cpp \
         kernel/qeventloop.cpp \
+        kernel/qeventloopinstrumentation.cpp \
         kernel/qcoreapplication.cpp \
         kernel/qcoreevent.cpp \
         kernel/qmetaobject.cpp \
@@ -60,6 +60,7 @@
 #include <qthread.h>
 #include <qthreadstorage.h>
 #include <private/qthread_p.h>
+#include <private/qeventloopinstrumentation_p.h>
 #if QT_CONFIG(thread)
 #include <qthreadpool.h>
 #endif
@@ -366,7 +367,10 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    uint count = currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    if (currentThreadData->postEventList.hasPendingInboxEvents())
+        ++count;
+    return count;
 }
 
 QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = 0;
@@ -522,6 +526,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        drainPostEventInbox(threadData);
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -853,6 +858,9 @@ void QCoreApplicationPrivate::init()
 #endif
 
 #ifndef QT_NO_QOBJECT
+    if (qEnvironmentVariableIntValue("QT_EVENT_LOOP_INSTRUMENTATION") > 0)
+        qt_setEventLoopInstrumentationEnabled(true);
+
     // use the event dispatcher created by the app programmer (if any)
     Q_ASSERT(!eventDispatcher);
     eventDispatcher = threadData->eventDispatcher.load();
@@ -1087,10 +1095,23 @@ bool QCoreApplication::notifyInternal2(QObject *receiver, QEvent *event)
     QObjectPrivate *d = receiver->d_func();
     QThreadData *threadData = d->threadData;
     QScopedScopeLevelCounter scopeLevelCounter(threadData);
-    if (!selfRequired)
+    if (qt_eventLoopInstrumentationActive()) {
+        // the receiver may be gone once the event is delivered
+        const int type = event->type();
+        const QByteArray className = receiver->metaObject()->className();
+        QElapsedTimer timer;
+        timer.start();
+        if (!selfRequired)
+            result = doNotify(receiver, event);
+        else
+            result = self ? self->notify(receiver, event) : false;
+        qt_recordEventLoopMeasurement(QEventLoopEventDelivery, timer.nsecsElapsed(),
+                                      type, className.constData());
+    } else if (!selfRequired) {
         result = doNotify(receiver, event);
-    else
+    } else {
         result = self ? self->notify(receiver, event) : false;
+    }
 
     QInternal::activateCallbacks(QInternal::EventHandledCallback, cbdata);
     return result;
@@ -1541,6 +1562,30 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Posting to an object in another thread only needs a push onto the
+    // receiver thread's inbox. DeferredDelete events take the locked path
+    // below, since they need the bookkeeping done there.
+    if (event->type() != QEvent::DeferredDelete && data != QThreadData::current(false)) {
+        QPostEventQueue *queue = data->postEventList.ensureInbox();
+        quint32 position;
+        if (queue->claim(&position)) {
+            // moveToThread() closes the inbox before changing the thread
+            // data and collects whatever was claimed until then, so if the
+            // object is still here, the event moves along with it.
+            if (data->postEventList.isInboxOpen() && data == *pdata) {
+                Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+                event->posted = true;
+                queue->publish(position, QPostEvent(receiver, event, priority));
+
+                QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+                if (dispatcher)
+                    dispatcher->wakeUp();
+                return;
+            }
+            queue->publish(position, QPostEvent());
+        }
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1560,6 +1605,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the events posted from other threads ahead of this one
+    QCoreApplicationPrivate::drainPostEventInbox(data);
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1704,6 +1752,15 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    drainPostEventInbox(data);
+
+    if (qt_eventLoopInstrumentationActive() && !receiver && !event_type) {
+        const int depth = data->postEventList.size() - data->postEventList.startOffset;
+        // the instrumentation callback may post events
+        locker.unlock();
+        qt_recordEventLoopMeasurement(QEventLoopPostedEventQueueDepth, depth);
+        locker.relock();
+    }
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1840,6 +1897,37 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     cleanup.exceptionCaught = false;
 }
 
+/*!
+  \internal
+  Moves the events that other threads pushed onto the inbox of \a data
+  into its sorted post event list, compressing them as postEvent() would
+  have. The post event list mutex of \a data must be locked.
+*/
+void QCoreApplicationPrivate::drainPostEventInbox(QThreadData *data)
+{
+    QPostEventQueue *queue = data->postEventList.inbox.loadAcquire();
+    if (!queue || queue->isEmpty())
+        return;
+
+    // the dispatcher must not go to sleep before these are sent
+    data->canWait = false;
+
+    QCoreApplication *app = QCoreApplication::self;
+    queue->consume([data, app](const QPostEvent &pe) {
+        // compressEvent() may delete the event, which must not find it
+        // posted, as it is not in the list yet
+        pe.event->posted = false;
+        if (pe.receiver->d_func()->postedEvents
+            && app && app->compressEvent(pe.event, pe.receiver, &data->postEventList)) {
+            Q_TRACE(QCoreApplication_postEvent_event_compressed, pe.receiver, pe.event);
+            return;
+        }
+        data->postEventList.addEvent(pe);
+        pe.event->posted = true;
+        ++pe.receiver->d_func()->postedEvents;
+    });
+}
+
 /*!
     \since 4.3
 
@@ -1863,6 +1951,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    QCoreApplicationPrivate::drainPostEventInbox(data);
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1926,6 +2015,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    drainPostEventInbox(data);
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
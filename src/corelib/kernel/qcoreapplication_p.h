@@ -125,6 +125,7 @@ public:
     static bool threadRequiresCoreApplication();
 
     static void sendPostedEvents(QObject *receiver, int event_type, QThreadData *data);
+    static void drainPostEventInbox(QThreadData *data);
 
     static void checkReceiverThread(QObject *receiver);
     void cleanupThreadData();
@@ -50,6 +50,7 @@
 #include <private/qthread_p.h>
 #include <private/qcoreapplication_p.h>
 #include <private/qcore_unix_p.h>
+#include <private/qeventloopinstrumentation_p.h>
 
 #include <errno.h>
 #include <stdio.h>
@@ -59,6 +60,11 @@
 #  include <sys/eventfd.h>
 #endif
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+#  include <sys/epoll.h>
+#  include <sys/timerfd.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -223,15 +229,32 @@ int QThreadPipe::check(const pollfd &pfd)
 }
 
 QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    : epollFd(-1), timerFd(-1), epollEdgeTriggered(false), timerFdArmed(false)
+#endif
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Can not continue without a thread pipe");
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    // 1 selects level-triggered epoll, 2 edge-triggered; anything else keeps poll(2)
+    const int epollMode = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL");
+    if (epollMode == 1 || epollMode == 2)
+        initEpoll(epollMode == 2);
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
     // cleanup timers
     qDeleteAll(timerList);
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (timerFd >= 0)
+        qt_safe_close(timerFd);
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
 }
 
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
@@ -258,35 +281,39 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
         auto it = socketNotifiers.find(pfd.fd);
         Q_ASSERT(it != socketNotifiers.end());
 
-        const QSocketNotifierSetUNIX &sn_set = it.value();
-
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
-
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+        markPendingSocketNotifiers(it.key(), it.value(), pfd.revents);
+    }
 
-            if (!notifier)
-                continue;
+    pollfds.clear();
+}
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers(int fd, const QSocketNotifierSetUNIX &sn_set,
+                                                             short revents)
+{
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+
+        if (!notifier)
+            continue;
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     fd, socketType(n.type));
+            notifier->setEnabled(false);
         }
-    }
 
-    pollfds.clear();
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
 }
 
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
@@ -308,6 +335,171 @@ int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
     return n_activated;
 }
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+static uint32_t epollEventsFor(const QSocketNotifierSetUNIX &sn_set, bool edgeTriggered)
+{
+    uint32_t events = 0;
+    if (sn_set.notifiers[QSocketNotifier::Read])
+        events |= EPOLLIN;
+    if (sn_set.notifiers[QSocketNotifier::Write])
+        events |= EPOLLOUT;
+    if (sn_set.notifiers[QSocketNotifier::Exception])
+        events |= EPOLLPRI;
+    if (edgeTriggered)
+        events |= EPOLLET;
+    return events;
+}
+
+static short pollEventsFromEpoll(uint32_t events)
+{
+    short revents = 0;
+    if (events & EPOLLIN)
+        revents |= POLLIN;
+    if (events & EPOLLOUT)
+        revents |= POLLOUT;
+    if (events & EPOLLPRI)
+        revents |= POLLPRI;
+    if (events & EPOLLERR)
+        revents |= POLLERR;
+    if (events & EPOLLHUP)
+        revents |= POLLHUP;
+    return revents;
+}
+
+static bool epollAdd(int epollFd, int fd, uint32_t events)
+{
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+bool QEventDispatcherUNIXPrivate::initEpoll(bool edgeTriggered)
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        qErrnoWarning("QEventDispatcherUNIX: Unable to create epoll instance, using poll");
+        return false;
+    }
+
+    // the timer list computes relative timeouts from CLOCK_MONOTONIC; a
+    // timerfd keeps the nanosecond resolution that epoll_wait's
+    // millisecond timeout would lose for PreciseTimer
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd == -1 || !epollAdd(epollFd, timerFd, EPOLLIN)
+        || !epollAdd(epollFd, threadPipe.fds[0], EPOLLIN)) {
+        qErrnoWarning("QEventDispatcherUNIX: Unable to set up epoll, using poll");
+        if (timerFd >= 0)
+            qt_safe_close(timerFd);
+        qt_safe_close(epollFd);
+        timerFd = epollFd = -1;
+        return false;
+    }
+
+    epollEdgeTriggered = edgeTriggered;
+    return true;
+}
+
+void QEventDispatcherUNIXPrivate::updateEpollRegistration(int fd, const QSocketNotifierSetUNIX &sn_set,
+                                                          bool wasRegistered)
+{
+    if (sn_set.isEmpty()) {
+        // the descriptor may already be closed, in which case the kernel
+        // has dropped it from the interest list on its own
+        if (!unpollableFds.removeOne(fd))
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    if (unpollableFds.contains(fd))
+        return;
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = epollEventsFor(sn_set, epollEdgeTriggered);
+    ev.data.fd = fd;
+
+    int op = wasRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+        return;
+
+    // a descriptor that was closed and reused without unregistering its
+    // notifiers leaves the interest list out of sync with socketNotifiers
+    if (errno == ENOENT || errno == EEXIST) {
+        op = (errno == ENOENT) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+            return;
+    }
+
+    if (errno == EPERM)
+        unpollableFds.append(fd);
+    else
+        qErrnoWarning("QSocketNotifier: Unable to watch socket %d with epoll", fd);
+}
+
+int QEventDispatcherUNIXPrivate::processEpollEvents(timespec *tm, QEventLoopIterationTimer &iterationTimer)
+{
+    int timeout = -1;
+    if (!unpollableFds.isEmpty() || (tm && tm->tv_sec == 0 && tm->tv_nsec == 0)) {
+        timeout = 0;
+    } else if (tm) {
+        itimerspec spec;
+        memset(&spec, 0, sizeof(spec));
+        spec.it_value = *tm;
+        if (timerfd_settime(timerFd, 0, &spec, nullptr) == 0) {
+            timerFdArmed = true;
+        } else {
+            // fall back to the millisecond timeout, rounded up so that
+            // timers are not activated early
+            timeout = int(tm->tv_sec * 1000 + (tm->tv_nsec + 999999) / 1000000);
+        }
+    } else if (timerFdArmed) {
+        // no timers are due: make sure a stale expiry does not wake us up
+        const itimerspec disarm = {};
+        timerfd_settime(timerFd, 0, &disarm, nullptr);
+        timerFdArmed = false;
+    }
+
+    epoll_event events[256];
+    iterationTimer.aboutToBlock();
+    const int count = epoll_wait(epollFd, events, sizeof(events) / sizeof(events[0]), timeout);
+    iterationTimer.awake();
+    if (count == -1) {
+        if (errno != EINTR)
+            perror("epoll_wait");
+        return 0;
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < count; ++i) {
+        const int fd = events[i].data.fd;
+
+        if (fd == threadPipe.fds[0]) {
+            pollfd pfd = threadPipe.prepare();
+            pfd.revents = pollEventsFromEpoll(events[i].events);
+            nevents += threadPipe.check(pfd);
+        } else if (fd == timerFd) {
+            quint64 expirations;
+            while (::read(timerFd, &expirations, sizeof(expirations)) == -1 && errno == EINTR) {}
+            timerFdArmed = false;
+        } else {
+            auto it = socketNotifiers.constFind(fd);
+            if (it != socketNotifiers.cend())
+                markPendingSocketNotifiers(fd, it.value(), pollEventsFromEpoll(events[i].events));
+        }
+    }
+
+    for (int fd : qAsConst(unpollableFds)) {
+        auto it = socketNotifiers.constFind(fd);
+        if (it != socketNotifiers.cend())
+            markPendingSocketNotifiers(fd, it.value(), POLLIN | POLLOUT);
+    }
+
+    return nevents + activateSocketNotifiers();
+}
+#endif // QT_EVENTDISPATCHER_UNIX_EPOLL
+
 QEventDispatcherUNIX::QEventDispatcherUNIX(QObject *parent)
     : QAbstractEventDispatcher(*new QEventDispatcherUNIXPrivate, parent)
 { }
@@ -405,6 +597,9 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 #endif
 
     Q_D(QEventDispatcherUNIX);
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    const bool wasRegistered = d->socketNotifiers.contains(sockfd);
+#endif
     QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
 
     if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
@@ -412,6 +607,11 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
                  Q_FUNC_INFO, sockfd, socketType(type));
 
     sn_set.notifiers[type] = notifier;
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (d->epollFd >= 0)
+        d->updateEpollRegistration(sockfd, sn_set, wasRegistered);
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -452,6 +652,11 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 
     sn_set.notifiers[type] = nullptr;
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (d->epollFd >= 0)
+        d->updateEpollRegistration(sockfd, sn_set, true);
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -460,6 +665,7 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
 {
     Q_D(QEventDispatcherUNIX);
     d->interrupt.store(0);
+    QEventLoopIterationTimer iterationTimer;
 
     // we are awake, broadcast it
     emit awake();
@@ -485,6 +691,19 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
+    int nevents = 0;
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    // with epoll the registrations live in the kernel, so there is no
+    // per-iteration pollfd array to rebuild
+    if (d->epollFd >= 0 && include_notifiers) {
+        nevents += d->processEpollEvents(tm, iterationTimer);
+        if (include_timers)
+            nevents += d->activateTimers();
+        return (nevents > 0);
+    }
+#endif
+
     d->pollfds.clear();
     d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
@@ -495,9 +714,11 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
 
-    int nevents = 0;
+    iterationTimer.aboutToBlock();
+    const int pollResult = qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm);
+    iterationTimer.awake();
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+    switch (pollResult) {
     case -1:
         perror("qt_safe_poll");
         break;
@@ -58,9 +58,14 @@
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll) && QT_CONFIG(timerfd)
+#  define QT_EVENTDISPATCHER_UNIX_EPOLL
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
+class QEventLoopIterationTimer;
 
 struct Q_CORE_EXPORT QSocketNotifierSetUNIX final
 {
@@ -137,9 +142,16 @@ public:
     int activateTimers();
 
     void markPendingSocketNotifiers();
+    void markPendingSocketNotifiers(int fd, const QSocketNotifierSetUNIX &sn_set, short revents);
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    bool initEpoll(bool edgeTriggered);
+    void updateEpollRegistration(int fd, const QSocketNotifierSetUNIX &sn_set, bool wasRegistered);
+    int processEpollEvents(timespec *tm, QEventLoopIterationTimer &iterationTimer);
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
@@ -148,6 +160,18 @@ public:
 
     QTimerInfoList timerList;
     QAtomicInt interrupt; // bool
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    // epoll(7) backend, selected with QT_EVENT_DISPATCHER_EPOLL;
+    // epollFd is -1 when the poll(2) backend is in use
+    int epollFd;
+    int timerFd;
+    bool epollEdgeTriggered;
+    bool timerFdArmed;
+    // descriptors epoll refuses (EPERM, e.g. regular files); poll(2)
+    // reports these as always readable and writable
+    QVector<int> unpollableFds;
+#endif
 };
 
 inline QSocketNotifierSetUNIX::QSocketNotifierSetUNIX() Q_DECL_NOTHROW
@@ -0,0 +1,205 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qeventloopinstrumentation_p.h"
+
+#include <qalgorithms.h>
+#include <qmutex.h>
+
+#include <qtcore_tracepoints_p.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The event loops measure their work only while qt_eventLoopInstrumentationEnabled
+    is set, so that the cost of the instrumentation is a relaxed load and a branch
+    otherwise. The measurements of all threads go to a single set of histograms:
+    taking a mutex is cheap next to the delivery of an event or a pass of an event
+    loop, and keeps the statistics simple to read from any thread.
+*/
+QBasicAtomicInt qt_eventLoopInstrumentationEnabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+struct QEventLoopInstrumentationData
+{
+    QEventLoopInstrumentationData()
+        : callback(nullptr)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (QEventLoopHistogram &histogram : statistics.measurements)
+            histogram = QEventLoopHistogram();
+        statistics.eventTypes.clear();
+        statistics.receiverClasses.clear();
+    }
+
+    QBasicMutex mutex;
+    QEventLoopStatistics statistics;
+    QEventLoopInstrumentationCallback callback;
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QEventLoopInstrumentationData, instrumentationData)
+
+int QEventLoopHistogram::bucketOf(quint64 value) Q_DECL_NOTHROW
+{
+    const int bucket = 64 - int(qCountLeadingZeroBits(value));
+    return qMin(bucket, int(BucketCount) - 1);
+}
+
+quint64 QEventLoopHistogram::bucketUpperBound(int bucket) Q_DECL_NOTHROW
+{
+    if (bucket >= BucketCount - 1)
+        return std::numeric_limits<quint64>::max();
+    return (Q_UINT64_C(1) << bucket) - 1;
+}
+
+void QEventLoopHistogram::add(quint64 value) Q_DECL_NOTHROW
+{
+    ++count;
+    total += value;
+    maximum = qMax(maximum, value);
+    ++buckets[bucketOf(value)];
+}
+
+quint64 QEventLoopHistogram::percentile(int percent) const Q_DECL_NOTHROW
+{
+    if (!count)
+        return 0;
+    // the rank of the value, rounded up
+    const quint64 rank = (count * quint64(qBound(0, percent, 100)) + 99) / 100;
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank && seen)
+            return qMin(bucketUpperBound(bucket), maximum);
+    }
+    return maximum;
+}
+
+void qt_recordEventLoopMeasurement(QEventLoopMeasurement measurement, quint64 value,
+                                   int eventType, const char *className)
+{
+    Q_TRACE(QEventLoopInstrumentation_measurement, int(measurement), value, eventType,
+            className ? className : "");
+
+    QEventLoopInstrumentationData *data = instrumentationData();
+    if (!data)
+        return;
+
+    QEventLoopInstrumentationCallback callback;
+    {
+        QMutexLocker locker(&data->mutex);
+        QEventLoopStatistics &statistics = data->statistics;
+        statistics.measurements[measurement].add(value);
+        if (measurement == QEventLoopEventDelivery) {
+            statistics.eventTypes[eventType].add(value);
+            // raw data only to look up the classes seen already
+            const QByteArray name = QByteArray::fromRawData(className, int(qstrlen(className)));
+            auto it = statistics.receiverClasses.find(name);
+            if (it == statistics.receiverClasses.end())
+                it = statistics.receiverClasses.insert(QByteArray(className), QEventLoopHistogram());
+            it->add(value);
+        }
+        callback = data->callback;
+    }
+    if (callback)
+        callback(measurement, value, eventType, className);
+}
+
+/*!
+    \internal
+
+    Starts recording the event loop measurements if \a enabled is true,
+    stops it otherwise. The statistics recorded so far are kept.
+*/
+void qt_setEventLoopInstrumentationEnabled(bool enabled)
+{
+    qt_eventLoopInstrumentationEnabled.store(enabled ? 1 : 0);
+}
+
+/*!
+    \internal
+
+    Sets the \a callback called with each measurement, in the thread it was
+    taken in, or removes it if \a callback is null.
+*/
+void qt_setEventLoopInstrumentationCallback(QEventLoopInstrumentationCallback callback)
+{
+    if (QEventLoopInstrumentationData *data = instrumentationData()) {
+        QMutexLocker locker(&data->mutex);
+        data->callback = callback;
+    }
+}
+
+/*!
+    \internal
+
+    Returns the statistics recorded since the last call to
+    qt_resetEventLoopStatistics().
+*/
+QEventLoopStatistics qt_eventLoopStatistics()
+{
+    QEventLoopInstrumentationData *data = instrumentationData();
+    if (!data)
+        return QEventLoopStatistics();
+    QMutexLocker locker(&data->mutex);
+    return data->statistics;
+}
+
+/*!
+    \internal
+
+    Clears the recorded statistics.
+*/
+void qt_resetEventLoopStatistics()
+{
+    if (QEventLoopInstrumentationData *data = instrumentationData()) {
+        QMutexLocker locker(&data->mutex);
+        data->reset();
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QEVENTLOOPINSTRUMENTATION_P_H
+#define QEVENTLOOPINSTRUMENTATION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qhash.h>
+
+QT_BEGIN_NAMESPACE
+
+// Distribution of the values of one measurement: bucket 0 counts the zeros,
+// bucket i the values in [2^(i-1), 2^i), and the last one everything above.
+struct Q_CORE_EXPORT QEventLoopHistogram
+{
+    enum { BucketCount = 40 };
+
+    quint64 count;
+    quint64 total;
+    quint64 maximum;
+    quint64 buckets[BucketCount];
+
+    void add(quint64 value) Q_DECL_NOTHROW;
+    // upper bound of the bucket holding the given percentile of the values
+    quint64 percentile(int percent) const Q_DECL_NOTHROW;
+
+    static int bucketOf(quint64 value) Q_DECL_NOTHROW;
+    static quint64 bucketUpperBound(int bucket) Q_DECL_NOTHROW;
+};
+
+enum QEventLoopMeasurement {
+    // nanoseconds spent delivering an event, event filters and nested
+    // deliveries included
+    QEventLoopEventDelivery,
+    // nanoseconds an event dispatcher iteration spent outside of waiting
+    // for events
+    QEventLoopIteration,
+    // number of posted events pending when a thread starts sending them
+    QEventLoopPostedEventQueueDepth,
+    // nanoseconds between the timeout of a timer and its timer event
+    QEventLoopTimerLateness,
+    QEventLoopMeasurementCount
+};
+
+struct QEventLoopStatistics
+{
+    QEventLoopHistogram measurements[QEventLoopMeasurementCount];
+    // event delivery, by event type and by class name of the receiver
+    QHash<int, QEventLoopHistogram> eventTypes;
+    QHash<QByteArray, QEventLoopHistogram> receiverClasses;
+};
+
+// Called for every measurement, in the thread it was taken in; eventType and
+// className describe the event or timer, and are 0 for the other measurements
+typedef void (*QEventLoopInstrumentationCallback)(QEventLoopMeasurement measurement, quint64 value,
+                                                  int eventType, const char *className);
+
+// Opt-in recording of how long the event loops of all threads take to do
+// their work; also enabled by setting QT_EVENT_LOOP_INSTRUMENTATION to 1.
+// Each measurement is also reported through the qtcore tracepoints.
+Q_CORE_EXPORT void qt_setEventLoopInstrumentationEnabled(bool enabled);
+Q_CORE_EXPORT void qt_setEventLoopInstrumentationCallback(QEventLoopInstrumentationCallback callback);
+Q_CORE_EXPORT QEventLoopStatistics qt_eventLoopStatistics();
+Q_CORE_EXPORT void qt_resetEventLoopStatistics();
+
+extern QBasicAtomicInt qt_eventLoopInstrumentationEnabled;
+
+inline bool qt_eventLoopInstrumentationActive() Q_DECL_NOTHROW
+{
+    return Q_UNLIKELY(qt_eventLoopInstrumentationEnabled.load() != 0);
+}
+
+void qt_recordEventLoopMeasurement(QEventLoopMeasurement measurement, quint64 value,
+                                   int eventType = 0, const char *className = nullptr);
+
+// Measures an event dispatcher iteration, leaving out the time it is blocked
+class QEventLoopIterationTimer
+{
+public:
+    QEventLoopIterationTimer() Q_DECL_NOTHROW
+        : busyTime(0), active(qt_eventLoopInstrumentationActive())
+    {
+        if (active)
+            timer.start();
+    }
+    ~QEventLoopIterationTimer()
+    {
+        if (Q_UNLIKELY(active))
+            qt_recordEventLoopMeasurement(QEventLoopIteration, busyTime + timer.nsecsElapsed());
+    }
+
+    void aboutToBlock() Q_DECL_NOTHROW
+    {
+        if (Q_UNLIKELY(active))
+            busyTime += timer.nsecsElapsed();
+    }
+    void awake() Q_DECL_NOTHROW
+    {
+        if (Q_UNLIKELY(active))
+            timer.start();
+    }
+
+private:
+    Q_DISABLE_COPY(QEventLoopIterationTimer)
+
+    QElapsedTimer timer;
+    qint64 busyTime;
+    const bool active;
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTLOOPINSTRUMENTATION_P_H
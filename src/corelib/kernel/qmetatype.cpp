@@ -42,7 +42,8 @@
 #include "qobjectdefs.h"
 #include "qdatetime.h"
 #include "qbytearray.h"
-#include "qreadwritelock.h"
+#include "qmutex.h"
+#include "qhash.h"
 #include "qstring.h"
 #include "qstringlist.h"
 #include "qvector.h"
@@ -525,47 +526,313 @@ public:
     int alias;
 };
 
+/*
+    The registry of the custom types.
+
+    Looking a type up doesn't lock anything: a registered QCustomTypeInfo
+    is never modified nor moved. Changing it publishes a modified copy
+    instead, and the old one is kept until the registry is destroyed, as
+    it may still be in use. The names are looked up in an open-addressing
+    hash table of indexes, which is replaced by a bigger copy when it gets
+    half full.
+
+    Registering types is serialized by mutex().
+*/
+class QMetaTypeCustomRegistry
+{
+public:
+    QMetaTypeCustomRegistry()
+        : size(0), names(nullptr)
+    { }
+    ~QMetaTypeCustomRegistry();
+
+    int count() const { return size.loadAcquire(); }
+    const QCustomTypeInfo *at(int index) const { return slot(index)->loadAcquire(); }
+
+    // Returns the info of the custom type \a type, or null if there is none
+    const QCustomTypeInfo *typeInfo(int type) const
+    {
+        const uint index = uint(type) - QMetaType::User;
+        return index < uint(count()) ? at(index) : nullptr;
+    }
+
+    int indexOf(const char *typeName, int length) const;
+    int indexOfFreeSlot() const;
+
+    QMutex *mutex() { return &writeMutex; }
+    int append(const QCustomTypeInfo &info);
+    void replace(int index, const QCustomTypeInfo &info);
+
+private:
+    // the first chunk holds 16 infos, and each one after that twice as many
+    // as the previous one, so that the infos never need to move
+    enum { FirstChunkBits = 4, FirstChunkSize = 1 << FirstChunkBits, ChunkCount = 27 };
+
+    struct NameIndex
+    {
+        explicit NameIndex(int capacity)
+            : mask(capacity - 1), used(0), values(new QAtomicInt[capacity]), previous(nullptr)
+        { }
+        ~NameIndex() { delete [] values; }
+
+        int mask;
+        int used;
+        QAtomicInt *values; // index + 1 of a QCustomTypeInfo, or 0 if free
+        NameIndex *previous;
+    private:
+        Q_DISABLE_COPY(NameIndex)
+    };
+
+    QAtomicPointer<const QCustomTypeInfo> *slot(int index) const
+    {
+        const uint i = uint(index) + FirstChunkSize;
+        const int chunk = 31 - qCountLeadingZeroBits(i) - FirstChunkBits;
+        return chunks[chunk].loadAcquire() + (i - (uint(FirstChunkSize) << chunk));
+    }
+
+    void addName(int index, const QByteArray &typeName);
+    static void insertName(NameIndex *index, int value, const QByteArray &typeName);
+
+    QAtomicInt size;
+    QAtomicPointer<QAtomicPointer<const QCustomTypeInfo> > chunks[ChunkCount];
+    QAtomicPointer<NameIndex> names;
+    QVector<const QCustomTypeInfo *> replacedInfos;
+    QMutex writeMutex;
+
+    Q_DISABLE_COPY(QMetaTypeCustomRegistry)
+};
+
+QMetaTypeCustomRegistry::~QMetaTypeCustomRegistry()
+{
+    for (int i = 0; i < count(); ++i)
+        delete at(i);
+    qDeleteAll(replacedInfos);
+    for (int chunk = 0; chunk < ChunkCount; ++chunk)
+        delete [] chunks[chunk].load();
+    NameIndex *index = names.load();
+    while (index) {
+        NameIndex *previous = index->previous;
+        delete index;
+        index = previous;
+    }
+}
+
+/*
+    Returns the index of the type called \a typeName, or -1 if there is none.
+*/
+int QMetaTypeCustomRegistry::indexOf(const char *typeName, int length) const
+{
+    const NameIndex *index = names.loadAcquire();
+    if (!index)
+        return -1;
+    for (uint i = qHashBits(typeName, length); ; ++i) {
+        const int value = index->values[i & index->mask].loadAcquire() - 1;
+        if (value < 0)
+            return -1;
+        // the slot is stale if the type was unregistered or its slot reused
+        const QByteArray &name = at(value)->typeName;
+        if (name.size() == length && !memcmp(typeName, name.constData(), length))
+            return value;
+    }
+}
+
+/*
+    Returns the index of an unregistered type that can be reused, or -1.
+    The mutex() must be locked.
+*/
+int QMetaTypeCustomRegistry::indexOfFreeSlot() const
+{
+    for (int i = 0; i < count(); ++i) {
+        if (at(i)->typeName.isEmpty())
+            return i;
+    }
+    return -1;
+}
+
+/*
+    Registers a copy of \a info and returns its index. The mutex() must be
+    locked.
+*/
+int QMetaTypeCustomRegistry::append(const QCustomTypeInfo &info)
+{
+    const int index = size.load();
+    const uint i = uint(index) + FirstChunkSize;
+    const int chunk = 31 - qCountLeadingZeroBits(i) - FirstChunkBits;
+    Q_ASSERT(chunk < ChunkCount);
+    if (!chunks[chunk].load())
+        chunks[chunk].storeRelease(new QAtomicPointer<const QCustomTypeInfo>[uint(FirstChunkSize) << chunk]);
+    slot(index)->storeRelease(new QCustomTypeInfo(info));
+    size.storeRelease(index + 1);
+    addName(index, info.typeName);
+    return index;
+}
+
+/*
+    Replaces the info at \a index by a copy of \a info. The old one may still
+    be used by another thread, so it is only deleted with the registry. The
+    mutex() must be locked.
+*/
+void QMetaTypeCustomRegistry::replace(int index, const QCustomTypeInfo &info)
+{
+    const QCustomTypeInfo *old = at(index);
+    slot(index)->storeRelease(new QCustomTypeInfo(info));
+    replacedInfos.append(old);
+    if (old->typeName != info.typeName)
+        addName(index, info.typeName);
+}
+
+void QMetaTypeCustomRegistry::addName(int index, const QByteArray &typeName)
+{
+    if (typeName.isEmpty())
+        return;
+    NameIndex *oldIndex = names.load();
+    if (oldIndex && 2 * (oldIndex->used + 1) <= oldIndex->mask + 1) {
+        insertName(oldIndex, index, typeName);
+        return;
+    }
+
+    // Rebuild a bigger table, leaving out the stale slots. This includes
+    // typeName, which is already stored at index.
+    int capacity = 64;
+    while (capacity < 4 * count())
+        capacity *= 2;
+    NameIndex *newIndex = new NameIndex(capacity);
+    for (int i = 0; i < count(); ++i)
+        insertName(newIndex, i, at(i)->typeName);
+    newIndex->previous = oldIndex;
+    names.storeRelease(newIndex);
+}
+
+void QMetaTypeCustomRegistry::insertName(NameIndex *index, int value, const QByteArray &typeName)
+{
+    if (typeName.isEmpty())
+        return;
+    uint i = qHashBits(typeName.constData(), typeName.size());
+    while (index->values[i & index->mask].load())
+        ++i;
+    index->values[i & index->mask].storeRelease(value + 1);
+    ++index->used;
+}
+
+/*
+    The registries of the converters, comparators and debug stream operators,
+    which are also looked up without locking: the entries are never deleted
+    before the registry, removing one only clears its function, and growing
+    the hash table replaces it by a bigger copy, keeping the old one around.
+*/
 template<typename T, typename Key>
 class QMetaTypeFunctionRegistry
 {
+    struct Entry
+    {
+        Entry(Key key, const T *function) : key(key), function(function) { }
+        const Key key;
+        QAtomicPointer<const T> function;
+    };
+
+    struct Table
+    {
+        explicit Table(int capacity)
+            : mask(capacity - 1), used(0), entries(new QAtomicPointer<Entry>[capacity]), previous(nullptr)
+        { }
+        ~Table() { delete [] entries; }
+
+        int mask;
+        int used;
+        QAtomicPointer<Entry> *entries;
+        Table *previous;
+    private:
+        Q_DISABLE_COPY(Table)
+    };
+
 public:
+    QMetaTypeFunctionRegistry() : table(nullptr) { }
     ~QMetaTypeFunctionRegistry()
     {
-        const QWriteLocker locker(&lock);
-        map.clear();
+        const QMutexLocker locker(&lock);
+        Table *t = table.load();
+        if (t) {
+            for (int i = 0; i <= t->mask; ++i)
+                delete t->entries[i].load();
+        }
+        while (t) {
+            Table *previous = t->previous;
+            delete t;
+            t = previous;
+        }
     }
 
     bool contains(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.contains(k);
+        return function(k) != nullptr;
     }
 
     bool insertIfNotContains(Key k, const T *f)
     {
-        const QWriteLocker locker(&lock);
-        const T* &fun = map[k];
-        if (fun != 0)
-            return false;
-        fun = f;
+        const QMutexLocker locker(&lock);
+        if (Entry *e = find(table.load(), k)) {
+            if (e->function.load())
+                return false;
+            e->function.storeRelease(f);
+            return true;
+        }
+
+        Table *t = table.load();
+        if (!t || 2 * (t->used + 1) > t->mask + 1) {
+            Table *newTable = new Table(t ? 2 * (t->mask + 1) : 16);
+            if (t) {
+                for (int i = 0; i <= t->mask; ++i) {
+                    if (Entry *e = t->entries[i].load())
+                        insert(newTable, e);
+                }
+            }
+            newTable->previous = t;
+            t = newTable;
+            insert(t, new Entry(k, f));
+            table.storeRelease(t);
+        } else {
+            insert(t, new Entry(k, f));
+        }
         return true;
     }
 
     const T *function(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.value(k, 0);
+        const Entry *e = find(table.loadAcquire(), k);
+        return e ? e->function.loadAcquire() : nullptr;
     }
 
     void remove(int from, int to)
     {
         const Key k(from, to);
-        const QWriteLocker locker(&lock);
-        map.remove(k);
+        const QMutexLocker locker(&lock);
+        if (Entry *e = find(table.load(), k))
+            e->function.storeRelease(nullptr);
     }
+
 private:
-    mutable QReadWriteLock lock;
-    QHash<Key, const T *> map;
+    static Entry *find(const Table *t, Key k)
+    {
+        if (!t)
+            return nullptr;
+        for (uint i = qHash(k); ; ++i) {
+            Entry *e = t->entries[i & t->mask].loadAcquire();
+            if (!e || e->key == k)
+                return e;
+        }
+    }
+
+    static void insert(Table *t, Entry *e)
+    {
+        uint i = qHash(e->key);
+        while (t->entries[i & t->mask].load())
+            ++i;
+        t->entries[i & t->mask].storeRelease(e);
+        ++t->used;
+    }
+
+    QMutex lock;
+    QAtomicPointer<Table> table;
 };
 
 typedef QMetaTypeFunctionRegistry<QtPrivate::AbstractConverterFunction,QPair<int,int> >
@@ -583,9 +850,7 @@ union CheckThatItIsPod
 };
 }
 
-Q_DECLARE_TYPEINFO(QCustomTypeInfo, Q_MOVABLE_TYPE);
-Q_GLOBAL_STATIC(QVector<QCustomTypeInfo>, customTypes)
-Q_GLOBAL_STATIC(QReadWriteLock, customTypesLock)
+Q_GLOBAL_STATIC(QMetaTypeCustomRegistry, customTypes)
 Q_GLOBAL_STATIC(QMetaTypeConverterRegistry, customTypesConversionRegistry)
 Q_GLOBAL_STATIC(QMetaTypeComparatorRegistry, customTypesComparatorRegistry)
 Q_GLOBAL_STATIC(QMetaTypeDebugStreamRegistry, customTypesDebugStreamRegistry)
@@ -828,13 +1093,14 @@ void QMetaType::registerStreamOperators(int idx, SaveOperator saveOp,
 {
     if (idx < User)
         return; //builtin types should not be registered;
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QMetaTypeCustomRegistry *ct = customTypes();
     if (!ct)
         return;
-    QWriteLocker locker(customTypesLock());
-    QCustomTypeInfo &inf = (*ct)[idx - User];
+    QMutexLocker locker(ct->mutex());
+    QCustomTypeInfo inf = *ct->at(idx - User);
     inf.saveOp = saveOp;
     inf.loadOp = loadOp;
+    ct->replace(idx - User, inf);
 }
 #endif // QT_NO_DATASTREAM
 
@@ -933,11 +1199,9 @@ const char *QMetaType::typeName(int typeId)
         return nullptr; // It can happen when someone cast int to QVariant::Type, we should not crash...
     }
 
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    QReadLocker locker(customTypesLock());
-    return ct && uint(ct->count()) > type - QMetaType::User && !ct->at(type - QMetaType::User).typeName.isEmpty()
-            ? ct->at(type - QMetaType::User).typeName.constData()
-            : nullptr;
+    const QMetaTypeCustomRegistry * const ct = customTypes();
+    const QCustomTypeInfo *info = ct ? ct->typeInfo(typeId) : nullptr;
+    return info && !info->typeName.isEmpty() ? info->typeName.constData() : nullptr;
 
 #undef QT_METATYPE_TYPEID_TYPENAME_CONVERTER
 }
@@ -957,30 +1221,21 @@ static inline int qMetaTypeStaticType(const char *typeName, int length)
 
 /*
     Similar to QMetaType::type(), but only looks in the custom set of
-    types, and doesn't lock the mutex.
-    The extra \a firstInvalidIndex parameter is an easy way to avoid
-    iterating over customTypes() a second time in registerNormalizedType().
+    types.
 */
-static int qMetaTypeCustomType_unlocked(const char *typeName, int length, int *firstInvalidIndex = 0)
+static int qMetaTypeCustomType(const char *typeName, int length)
 {
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
+    const QMetaTypeCustomRegistry * const ct = customTypes();
     if (!ct)
         return QMetaType::UnknownType;
 
-    if (firstInvalidIndex)
-        *firstInvalidIndex = -1;
-    for (int v = 0; v < ct->count(); ++v) {
-        const QCustomTypeInfo &customInfo = ct->at(v);
-        if ((length == customInfo.typeName.size())
-            && !memcmp(typeName, customInfo.typeName.constData(), length)) {
-            if (customInfo.alias >= 0)
-                return customInfo.alias;
-            return v + QMetaType::User;
-        }
-        if (firstInvalidIndex && (*firstInvalidIndex < 0) && customInfo.typeName.isEmpty())
-            *firstInvalidIndex = v;
-    }
-    return QMetaType::UnknownType;
+    const int v = ct->indexOf(typeName, length);
+    if (v < 0)
+        return QMetaType::UnknownType;
+    const QCustomTypeInfo *customInfo = ct->at(v);
+    if (customInfo->alias >= 0)
+        return customInfo->alias;
+    return v + QMetaType::User;
 }
 
 /*!
@@ -1010,21 +1265,27 @@ int QMetaType::registerType(const char *typeName, Deleter deleter,
  */
 bool QMetaType::unregisterType(int type)
 {
-    QWriteLocker locker(customTypesLock());
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QMetaTypeCustomRegistry *ct = customTypes();
+    if (!ct)
+        return false;
+    QMutexLocker locker(ct->mutex());
 
     // check if user type
-    if ((type < User) || ((type - User) >= ct->size()))
+    const QCustomTypeInfo *info = ct->typeInfo(type);
+    if (!info)
         return false;
 
     // only types without Q_DECLARE_METATYPE can be unregistered
-    if (ct->data()[type - User].flags & WasDeclaredAsMetaType)
+    if (info->flags & WasDeclaredAsMetaType)
         return false;
 
     // invalidate type and all its alias entries
     for (int v = 0; v < ct->count(); ++v) {
-        if (((v + User) == type) || (ct->at(v).alias == type))
-            ct->data()[v].typeName.clear();
+        if (((v + User) == type) || (ct->at(v)->alias == type)) {
+            QCustomTypeInfo inf = *ct->at(v);
+            inf.typeName.clear();
+            ct->replace(v, inf);
+        }
     }
     return true;
 }
@@ -1086,7 +1347,7 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
                                   QMetaType::TypedConstructor typedConstructor,
                                   int size, QMetaType::TypeFlags flags, const QMetaObject *metaObject)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QMetaTypeCustomRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty() || (!destructor && !typedDestructor) || (!constructor && !typedConstructor))
         return -1;
 
@@ -1096,11 +1357,9 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
     int previousSize = 0;
     QMetaType::TypeFlags::Int previousFlags = 0;
     if (idx == QMetaType::UnknownType) {
-        QWriteLocker locker(customTypesLock());
-        int posInVector = -1;
-        idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                           normalizedTypeName.size(),
-                                           &posInVector);
+        QMutexLocker locker(ct->mutex());
+        idx = qMetaTypeCustomType(normalizedTypeName.constData(),
+                                  normalizedTypeName.size());
         if (idx == QMetaType::UnknownType) {
             QCustomTypeInfo inf;
             inf.typeName = normalizedTypeName;
@@ -1116,28 +1375,29 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
             inf.size = size;
             inf.flags = flags;
             inf.metaObject = metaObject;
+            const int posInVector = ct->indexOfFreeSlot();
             if (posInVector == -1) {
-                idx = ct->size() + QMetaType::User;
-                ct->append(inf);
+                idx = ct->append(inf) + QMetaType::User;
             } else {
                 idx = posInVector + QMetaType::User;
-                ct->data()[posInVector] = inf;
+                ct->replace(posInVector, inf);
             }
             return idx;
         }
 
         if (idx >= QMetaType::User) {
-            previousSize = ct->at(idx - QMetaType::User).size;
-            previousFlags = ct->at(idx - QMetaType::User).flags;
+            previousSize = ct->at(idx - QMetaType::User)->size;
+            previousFlags = ct->at(idx - QMetaType::User)->flags;
 
             // Set new/additional flags in case of old library/app.
             // Ensures that older code works in conjunction with new Qt releases
             // requiring the new flags.
             if (flags != previousFlags) {
-                QCustomTypeInfo &inf = ct->data()[idx - QMetaType::User];
+                QCustomTypeInfo inf = *ct->at(idx - QMetaType::User);
                 inf.flags |= flags;
                 if (metaObject)
                     inf.metaObject = metaObject;
+                ct->replace(idx - QMetaType::User, inf);
             }
         }
     }
@@ -1256,7 +1516,7 @@ int QMetaType::registerTypedef(const char* typeName, int aliasId)
 */
 int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeName, int aliasId)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QMetaTypeCustomRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty())
         return -1;
 
@@ -1264,20 +1524,19 @@ int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeNam
                                   normalizedTypeName.size());
 
     if (idx == UnknownType) {
-        QWriteLocker locker(customTypesLock());
-        int posInVector = -1;
-        idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                               normalizedTypeName.size(),
-                                               &posInVector);
+        QMutexLocker locker(ct->mutex());
+        idx = qMetaTypeCustomType(normalizedTypeName.constData(),
+                                  normalizedTypeName.size());
 
         if (idx == UnknownType) {
             QCustomTypeInfo inf;
             inf.typeName = normalizedTypeName;
             inf.alias = aliasId;
+            const int posInVector = ct->indexOfFreeSlot();
             if (posInVector == -1)
                 ct->append(inf);
             else
-                ct->data()[posInVector] = inf;
+                ct->replace(posInVector, inf);
             return aliasId;
         }
     }
@@ -1307,9 +1566,9 @@ bool QMetaType::isRegistered(int type)
         return true;
     }
 
-    QReadLocker locker(customTypesLock());
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    return ((type >= User) && (ct && ct->count() > type - User) && !ct->at(type - User).typeName.isEmpty());
+    const QMetaTypeCustomRegistry * const ct = customTypes();
+    const QCustomTypeInfo *info = ct ? ct->typeInfo(type) : nullptr;
+    return info && !info->typeName.isEmpty();
 }
 
 template <bool tryNormalizedType>
@@ -1319,16 +1578,15 @@ static inline int qMetaTypeTypeImpl(const char *typeName, int length)
         return QMetaType::UnknownType;
     int type = qMetaTypeStaticType(typeName, length);
     if (type == QMetaType::UnknownType) {
-        QReadLocker locker(customTypesLock());
-        type = qMetaTypeCustomType_unlocked(typeName, length);
+        type = qMetaTypeCustomType(typeName, length);
 #ifndef QT_NO_QOBJECT
         if ((type == QMetaType::UnknownType) && tryNormalizedType) {
             const NS(QByteArray) normalizedTypeName = QMetaObject::normalizedType(typeName);
             type = qMetaTypeStaticType(normalizedTypeName.constData(),
                                        normalizedTypeName.size());
             if (type == QMetaType::UnknownType) {
-                type = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                                    normalizedTypeName.size());
+                type = qMetaTypeCustomType(normalizedTypeName.constData(),
+                                           normalizedTypeName.size());
             }
         }
 #endif
@@ -1587,15 +1845,11 @@ bool QMetaType::save(QDataStream &stream, int type, const void *data)
         stream << *static_cast<const NS(QUuid)*>(data);
         break;
     default: {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QMetaTypeCustomRegistry * const ct = customTypes();
         if (!ct)
             return false;
 
-        SaveOperator saveOp = 0;
-        {
-            QReadLocker locker(customTypesLock());
-            saveOp = ct->at(type - User).saveOp;
-        }
+        const SaveOperator saveOp = ct->at(type - User)->saveOp;
 
         if (!saveOp)
             return false;
@@ -1825,15 +2079,11 @@ bool QMetaType::load(QDataStream &stream, int type, void *data)
         stream >> *static_cast< NS(QUuid)*>(data);
         break;
     default: {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QMetaTypeCustomRegistry * const ct = customTypes();
         if (!ct)
             return false;
 
-        LoadOperator loadOp = 0;
-        {
-            QReadLocker locker(customTypesLock());
-            loadOp = ct->at(type - User).loadOp;
-        }
+        const LoadOperator loadOp = ct->at(type - User)->loadOp;
 
         if (!loadOp)
             return false;
@@ -1906,17 +2156,12 @@ public:
 private:
     static void *customTypeConstructor(const int type, void *where, const void *copy)
     {
-        QMetaType::Constructor ctor;
-        QMetaType::TypedConstructor tctor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-                return 0;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            ctor = typeInfo.constructor;
-            tctor = typeInfo.typedConstructor;
-        }
+        const QMetaTypeCustomRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->typeInfo(type) : nullptr;
+        if (Q_UNLIKELY(!typeInfo))
+            return 0;
+        const QMetaType::Constructor ctor = typeInfo->constructor;
+        const QMetaType::TypedConstructor tctor = typeInfo->typedConstructor;
         Q_ASSERT_X((ctor || tctor) , "void *QMetaType::construct(int type, void *where, const void *copy)", "The type was not properly registered");
         if (Q_UNLIKELY(tctor))
             return tctor(type, where, copy);
@@ -2004,17 +2249,12 @@ public:
 private:
     static void customTypeDestructor(const int type, void *where)
     {
-        QMetaType::Destructor dtor;
-        QMetaType::TypedDestructor tdtor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-                return;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            dtor = typeInfo.destructor;
-            tdtor = typeInfo.typedDestructor;
-        }
+        const QMetaTypeCustomRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->typeInfo(type) : nullptr;
+        if (Q_UNLIKELY(!typeInfo))
+            return;
+        const QMetaType::Destructor dtor = typeInfo->destructor;
+        const QMetaType::TypedDestructor tdtor = typeInfo->typedDestructor;
         Q_ASSERT_X((dtor || tdtor), "void QMetaType::destruct(int type, void *where)", "The type was not properly registered");
         if (Q_UNLIKELY(tdtor))
             return tdtor(type, where);
@@ -2078,11 +2318,9 @@ public:
 private:
     static int customTypeSizeOf(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).size;
+        const QMetaTypeCustomRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->typeInfo(type) : nullptr;
+        return Q_LIKELY(typeInfo) ? typeInfo->size : 0;
     }
 
     const int m_type;
@@ -2146,13 +2384,9 @@ private:
     const int m_type;
     static quint32 customTypeFlags(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct || type < QMetaType::User))
-            return 0;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).flags;
+        const QMetaTypeCustomRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->typeInfo(type) : nullptr;
+        return Q_LIKELY(typeInfo) ? typeInfo->flags : 0;
     }
 };
 }  // namespace
@@ -2206,13 +2440,9 @@ private:
     const int m_type;
     static const QMetaObject *customMetaObject(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct || type < QMetaType::User))
-            return 0;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).metaObject;
+        const QMetaTypeCustomRegistry * const ct = customTypes();
+        const QCustomTypeInfo *typeInfo = ct ? ct->typeInfo(type) : nullptr;
+        return Q_LIKELY(typeInfo) ? typeInfo->metaObject : 0;
     }
 };
 }  // namespace
@@ -2410,12 +2640,11 @@ public:
 private:
     void customTypeInfo(const uint type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QMetaTypeCustomRegistry * const ct = customTypes();
         if (Q_UNLIKELY(!ct))
             return;
-        QReadLocker locker(customTypesLock());
-        if (Q_LIKELY(uint(ct->count()) > type - QMetaType::User))
-            info = ct->at(type - QMetaType::User);
+        if (const QCustomTypeInfo *typeInfo = ct->typeInfo(type))
+            info = *typeInfo;
     }
 
     const uint m_type;
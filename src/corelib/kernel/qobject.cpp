@@ -68,6 +68,7 @@
 #include <private/qhooks_p.h>
 #include <qtcore_tracepoints_p.h>
 
+#include <algorithm>
 #include <new>
 
 #include <ctype.h>
@@ -77,6 +78,9 @@ QT_BEGIN_NAMESPACE
 
 static int DIRECT_CONNECTION_ONLY = 0;
 
+// Connection::coalescedEvent while queued_activate() updates the pending call
+static QMetaCallEvent *const COALESCED_EVENT_BUSY = reinterpret_cast<QMetaCallEvent *>(quintptr(1));
+
 
 QDynamicMetaObjectData::~QDynamicMetaObjectData()
 {
@@ -140,16 +144,33 @@ static int *queuedConnectionTypes(const QArgumentType *argumentTypes, int argc)
     return types.take();
 }
 
-static QBasicMutex _q_ObjectMutexPool[131];
+// Each mutex of the pool gets a cache line of its own, so that threads
+// working on unrelated objects don't bounce the same line between them.
+struct Q_DECL_ALIGN(64) QObjectMutexPoolEntry
+{
+    QBasicMutex mutex;
+};
+
+static QObjectMutexPoolEntry _q_ObjectMutexPool[131];
 
 /**
  * \internal
- * mutex to be locked when accessing the connectionlists or the senders list
+ * mutex to be locked when modifying the connectionlists or accessing the senders list
  */
 static inline QMutex *signalSlotLock(const QObject *o)
 {
     return static_cast<QMutex *>(&_q_ObjectMutexPool[
-        uint(quintptr(o)) % sizeof(_q_ObjectMutexPool)/sizeof(QBasicMutex)]);
+        uint(quintptr(o)) % sizeof(_q_ObjectMutexPool)/sizeof(QObjectMutexPoolEntry)].mutex);
+}
+
+typedef QVarLengthArray<QMutex *, 16> SignalSlotLockList;
+
+static void collectSignalSlotLocks(const QObject *o, SignalSlotLockList &mutexes)
+{
+    mutexes.append(signalSlotLock(o));
+    const QObjectList &children = o->children();
+    for (int i = 0; i < children.size(); ++i)
+        collectSignalSlotLocks(children.at(i), mutexes);
 }
 
 #if QT_VERSION < 0x60000
@@ -254,7 +275,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || threadData->postEventList.hasPendingInboxEvents())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -294,32 +315,190 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     QObjectPrivate::signalIndex (not QMetaObject::indexOfSignal).
     Negative index means connections to all signals.
 
-    This vector is protected by the object mutex (signalSlotMutexes())
+    The lists are only modified with the object mutex (signalSlotLock())
+    locked, but QMetaObject::activate() walks them without locking. To
+    make this safe, nothing that activate() can reach is deleted while
+    it is running (inUse is non-zero): disconnected connections are
+    unlinked from the lists, keeping their nextConnectionList pointer,
+    and moved to orphanedConnections; growing the vector allocates new
+    SignalLists and moves the old ones to orphanedSignalLists. Both are
+    deleted by the last function leaving the vector.
 
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
     linked list.
 */
-class QObjectConnectionListVector : public QVector<QObjectPrivate::ConnectionList>
+class QObjectConnectionListVector
 {
 public:
-    bool orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
-    bool dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
-    int inUse; //number of functions that are currently accessing this object or its connections
+    struct SignalLists
+    {
+        explicit SignalLists(int count)
+            : lists(new QObjectPrivate::ConnectionList[count]), count(count), nextInOrphanList(nullptr)
+        { }
+        ~SignalLists() { delete [] lists; }
+
+        QObjectPrivate::ConnectionList *lists;
+        int count;
+        SignalLists *nextInOrphanList;
+    private:
+        Q_DISABLE_COPY(SignalLists)
+    };
+
+    QAtomicInt orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
+    QAtomicInt dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
+    QAtomicInt inUse; //number of functions that are currently accessing this object or its connections
+    QAtomicInteger<uint> currentConnectionId; //id of the most recently added connection
     QObjectPrivate::ConnectionList allsignals;
+    QAtomicPointer<SignalLists> signalLists;
+    QAtomicPointer<QObjectPrivate::Connection> orphanedConnections;
+    QAtomicPointer<SignalLists> orphanedSignalLists;
 
     QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
+        : orphaned(false), dirty(false), inUse(0), currentConnectionId(0),
+          signalLists(nullptr), orphanedConnections(nullptr), orphanedSignalLists(nullptr)
     { }
+    ~QObjectConnectionListVector();
+
+    int count() const
+    {
+        const SignalLists *lists = signalLists.load();
+        return lists ? lists->count : 0;
+    }
+
+    const QObjectPrivate::ConnectionList &at(int at) const
+    {
+        if (at < 0)
+            return allsignals;
+        return signalLists.load()->lists[at];
+    }
 
     QObjectPrivate::ConnectionList &operator[](int at)
     {
         if (at < 0)
             return allsignals;
-        return QVector<QObjectPrivate::ConnectionList>::operator[](at);
+        return signalLists.load()->lists[at];
     }
+
+    void resize(int count);
+    QObjectPrivate::Connection *takeOrphanedConnections();
+
+private:
+    Q_DISABLE_COPY(QObjectConnectionListVector)
 };
 
+/*!
+  \internal
+  Drops the reference the connection lists hold on \a c, which must have
+  been removed from them. This destroys the functor of the connection, so
+  the signalSlotLock() mutexes must not be locked.
+ */
+static void releaseConnection(QObjectPrivate::Connection *c)
+{
+    if (c->isSlotObject) {
+        c->isSlotObject = false;
+        c->slotObj->destroyIfLastRef();
+    }
+    if (QThreadData *td = c->receiverThreadData.fetchAndStoreRelaxed(nullptr))
+        td->deref();
+    c->deref();
+}
+
+static void releaseConnections(QObjectPrivate::Connection *c)
+{
+    while (c) {
+        QObjectPrivate::Connection *next = c->nextInOrphanList;
+        releaseConnection(c);
+        c = next;
+    }
+}
+
+/*!
+  \internal
+  Returns the functor of the disconnected connection  c, to be destroyed
+  once the signalSlotLock() mutexes are unlocked, if no
+  QMetaObject::activate() can still call it. Otherwise it is destroyed when
+  the connection is released, after the emission.
+
+  The signalSlotLock() of the sender must be locked, and  connectionLists
+  marked dirty.
+ */
+static QtPrivate::QSlotObjectBase *takeDisconnectedSlotObject(QObjectConnectionListVector *connectionLists,
+                                                             QObjectPrivate::Connection *c)
+{
+    // read-modify-write, see QObjectConnectionListVector::takeOrphanedConnections()
+    if (!c->isSlotObject || connectionLists->inUse.fetchAndAddOrdered(0))
+        return nullptr;
+    c->isSlotObject = false;
+    return c->slotObj;
+}
+
+QObjectConnectionListVector::~QObjectConnectionListVector()
+{
+    Q_ASSERT(!inUse.load());
+    SignalLists *lists = orphanedSignalLists.load();
+    while (lists) {
+        SignalLists *next = lists->nextInOrphanList;
+        delete lists;
+        lists = next;
+    }
+    delete signalLists.load();
+    releaseConnections(orphanedConnections.load());
+}
+
+/*!
+  \internal
+  Makes room for \a count signals. The old lists may still be walked by
+  QMetaObject::activate(), so they are left alone until nothing uses the
+  vector anymore.
+
+  The signalSlotLock() of the owner must be locked.
+ */
+void QObjectConnectionListVector::resize(int count)
+{
+    SignalLists *oldLists = signalLists.load();
+    SignalLists *newLists = new SignalLists(count);
+    if (oldLists) {
+        for (int i = 0; i < oldLists->count; ++i) {
+            newLists->lists[i].first.store(oldLists->lists[i].first.load());
+            newLists->lists[i].last = oldLists->lists[i].last;
+        }
+        oldLists->nextInOrphanList = orphanedSignalLists.load();
+        orphanedSignalLists.store(oldLists);
+    }
+    signalLists.storeRelease(newLists);
+}
+
+/*!
+  \internal
+  Returns the connections that were removed from the lists, if no
+  QMetaObject::activate() can still be walking over them, and deletes the
+  unused SignalLists. The returned connections must be passed to
+  releaseConnections() once the signalSlotLock() of the owner is unlocked.
+
+  The signalSlotLock() of the owner must be locked.
+ */
+QObjectPrivate::Connection *QObjectConnectionListVector::takeOrphanedConnections()
+{
+    if (!orphanedConnections.load() && !orphanedSignalLists.load())
+        return nullptr;
+
+    // This must be a read-modify-write operation: either activate() takes
+    // its reference after this one in the modification order, and then it
+    // sees the lists without the orphans, or we see its reference and it
+    // sees the orphans when it leaves.
+    if (inUse.fetchAndAddOrdered(0))
+        return nullptr;
+
+    SignalLists *lists = orphanedSignalLists.fetchAndStoreRelaxed(nullptr);
+    while (lists) {
+        SignalLists *next = lists->nextInOrphanList;
+        delete lists;
+        lists = next;
+    }
+    return orphanedConnections.fetchAndStoreRelaxed(nullptr);
+}
+
 // Used by QAccessibleWidget
 bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
 {
@@ -328,15 +507,15 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c =
-                connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver == receiver)
+                if (c->receiver.load() == receiver)
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -352,14 +531,14 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
-            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
+            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver)
-                    returnValue << c->receiver;
-                c = c->nextConnectionList;
+                if (QObject *receiver = c->receiver.load())
+                    returnValue << receiver;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -389,22 +568,31 @@ QObjectList QObjectPrivate::senderList() const
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
-    if (!connectionLists)
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (!connectionLists) {
         connectionLists = new QObjectConnectionListVector();
+        this->connectionLists.storeRelease(connectionLists);
+    }
     if (signal >= connectionLists->count())
         connectionLists->resize(signal + 1);
 
+    QObjectPrivate *receiverPrivate = QObjectPrivate::get(c->receiver.load());
+    receiverPrivate->threadData->ref();
+    c->receiverThreadData.store(receiverPrivate->threadData);
+    c->id = connectionLists->currentConnectionId.load() + 1;
+    connectionLists->currentConnectionId.store(c->id);
+
     ConnectionList &connectionList = (*connectionLists)[signal];
     if (connectionList.last) {
-        connectionList.last->nextConnectionList = c;
+        connectionList.last->nextConnectionList.storeRelease(c);
     } else {
-        connectionList.first = c;
+        connectionList.first.storeRelease(c);
     }
     connectionList.last = c;
 
     cleanConnectionLists();
 
-    c->prev = &(QObjectPrivate::get(c->receiver)->senders);
+    c->prev = &receiverPrivate->senders;
     c->next = *c->prev;
     *c->prev = c;
     if (c->next)
@@ -418,9 +606,17 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
     }
 }
 
+/*!
+  \internal
+  Removes the disconnected connections from the connection lists. They are
+  not deleted yet, see QObjectConnectionListVector::takeOrphanedConnections().
+
+  The signalSlotLock() of the object must be locked.
+ */
 void QObjectPrivate::cleanConnectionLists()
 {
-    if (connectionLists->dirty && !connectionLists->inUse) {
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (connectionLists->dirty.load()) {
         // remove broken connections
         bool allConnected = false;
         for (int signal = -1; signal < connectionLists->count(); ++signal) {
@@ -432,21 +628,23 @@ void QObjectPrivate::cleanConnectionLists()
             // at the end of the cleanup.
             QObjectPrivate::Connection *last = 0;
 
-            QObjectPrivate::Connection **prev = &connectionList.first;
-            QObjectPrivate::Connection *c = *prev;
+            QAtomicPointer<QObjectPrivate::Connection> *prev = &connectionList.first;
+            QObjectPrivate::Connection *c = prev->load();
             bool connected = false; // whether the signal is still connected somewhere
             while (c) {
-                if (c->receiver) {
+                QObjectPrivate::Connection *next = c->nextConnectionList.load();
+                if (c->receiver.load()) {
                     last = c;
                     prev = &c->nextConnectionList;
-                    c = *prev;
                     connected = true;
                 } else {
-                    QObjectPrivate::Connection *next = c->nextConnectionList;
-                    *prev = next;
-                    c->deref();
-                    c = next;
+                    // activate() may be looking at c, so leave its
+                    // nextConnectionList alone
+                    prev->storeRelease(next);
+                    c->nextInOrphanList = connectionLists->orphanedConnections.load();
+                    connectionLists->orphanedConnections.store(c);
                 }
+                c = next;
             }
 
             // Correct the connection list's last pointer.
@@ -461,7 +659,7 @@ void QObjectPrivate::cleanConnectionLists()
                 allConnected = connected;
             }
         }
-        connectionLists->dirty = false;
+        connectionLists->dirty.store(false);
     }
 }
 
@@ -473,7 +671,8 @@ QMetaCallEvent::QMetaCallEvent(ushort method_offset, ushort method_relative, QOb
                                int nargs, int *types, void **args, QSemaphore *semaphore)
     : QEvent(MetaCall), slotObj_(0), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
-      callFunction_(callFunction), method_offset_(method_offset), method_relative_(method_relative)
+      callFunction_(callFunction), coalescingConnection_(nullptr),
+      method_offset_(method_offset), method_relative_(method_relative)
 { }
 
 /*!
@@ -483,7 +682,8 @@ QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO, const QObject
                                int nargs, int *types, void **args, QSemaphore *semaphore)
     : QEvent(MetaCall), slotObj_(slotO), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
-      callFunction_(0), method_offset_(0), method_relative_(ushort(-1))
+      callFunction_(0), coalescingConnection_(nullptr),
+      method_offset_(0), method_relative_(ushort(-1))
 {
     if (slotObj_)
         slotObj_->ref();
@@ -494,6 +694,7 @@ QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO, const QObject
  */
 QMetaCallEvent::~QMetaCallEvent()
 {
+    detachFromCoalescingConnection();
     if (types_) {
         for (int i = 0; i < nargs_; ++i) {
             if (types_[i] && args_[i])
@@ -515,6 +716,7 @@ QMetaCallEvent::~QMetaCallEvent()
  */
 void QMetaCallEvent::placeMetaCall(QObject *object)
 {
+    detachFromCoalescingConnection();
     if (slotObj_) {
         slotObj_->call(object, args_);
     } else if (callFunction_ && method_offset_ <= object->metaObject()->methodOffset()) {
@@ -524,6 +726,43 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+    Makes this event the pending call of the coalesced connection \a c,
+    which later emissions update instead of queueing another call.
+ */
+void QMetaCallEvent::setCoalescingConnection(QObjectPrivate::Connection *c)
+{
+    Q_ASSERT(!coalescingConnection_);
+    c->ref();
+    coalescingConnection_ = c;
+    c->coalescedEvent.storeRelease(this);
+}
+
+/*!
+    \internal
+    Stops later emissions from updating the arguments of this event, waiting
+    for queued_activate() if it is exchanging them right now.
+ */
+void QMetaCallEvent::detachFromCoalescingConnection()
+{
+    QObjectPrivate::Connection *c = coalescingConnection_;
+    if (!c)
+        return;
+    coalescingConnection_ = nullptr;
+
+    for (;;) {
+        QMetaCallEvent *pending = c->coalescedEvent.loadAcquire();
+        if (pending == COALESCED_EVENT_BUSY) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        if (pending != this || c->coalescedEvent.testAndSetOrdered(this, nullptr))
+            break;
+    }
+    c->deref();
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals().
@@ -927,55 +1166,59 @@ QObject::~QObject()
         d->currentSender->ref = 0;
     d->currentSender = 0;
 
-    if (d->connectionLists || d->senders) {
+    QObjectConnectionListVector *connectionLists = d->connectionLists.load();
+    if (connectionLists || d->senders) {
         QMutex *signalSlotMutex = signalSlotLock(this);
         QMutexLocker locker(signalSlotMutex);
 
+        // connections removed from the lists, to be released once unlocked
+        QObjectPrivate::Connection *orphans = nullptr;
+
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        if (connectionLists) {
+            connectionLists->inUse.ref();
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
-
-                while (QObjectPrivate::Connection *c = connectionList.first) {
-                    if (!c->receiver) {
-                        connectionList.first = c->nextConnectionList;
-                        c->deref();
-                        continue;
-                    }
-
-                    QMutex *m = signalSlotLock(c->receiver);
-                    bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
-
-                    if (c->receiver) {
-                        *c->prev = c->next;
-                        if (c->next) c->next->prev = c->prev;
+                    (*connectionLists)[signal];
+
+                while (QObjectPrivate::Connection *c = connectionList.first.load()) {
+                    if (QObject *receiver = c->receiver.load()) {
+                        QMutex *m = signalSlotLock(receiver);
+                        bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
+
+                        if (c->receiver.load()) {
+                            *c->prev = c->next;
+                            if (c->next) c->next->prev = c->prev;
+                        }
+                        c->receiver.storeRelease(nullptr);
+                        if (needToUnlock)
+                            m->unlock();
                     }
-                    c->receiver = 0;
-                    if (needToUnlock)
-                        m->unlock();
 
-                    connectionList.first = c->nextConnectionList;
+                    connectionList.first.store(c->nextConnectionList.load());
 
                     // The destroy operation must happen outside the lock
-                    if (c->isSlotObject) {
-                        c->isSlotObject = false;
-                        locker.unlock();
-                        c->slotObj->destroyIfLastRef();
-                        locker.relock();
-                    }
-                    c->deref();
+                    c->nextInOrphanList = orphans;
+                    orphans = c;
                 }
+                connectionList.last = nullptr;
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
-            } else {
-                d->connectionLists->orphaned = true;
+            // Set before dropping our reference: if an emission still holds
+            // one, its final deref() must see the flag, see ConnectionListsRef
+            connectionLists->orphaned.storeRelease(true);
+            if (!connectionLists->inUse.deref()) {
+                QObjectPrivate::Connection *c = connectionLists->takeOrphanedConnections();
+                while (c) {
+                    QObjectPrivate::Connection *next = c->nextInOrphanList;
+                    c->nextInOrphanList = orphans;
+                    orphans = c;
+                    c = next;
+                }
+                delete connectionLists;
             }
-            d->connectionLists = 0;
+            d->connectionLists.store(nullptr);
         }
 
         /* Disconnect all senders:
@@ -1004,15 +1247,11 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
-            if (senderLists)
-                senderLists->dirty = true;
-
+            node->receiver.storeRelease(nullptr);
             QtPrivate::QSlotObjectBase *slotObj = nullptr;
-            if (node->isSlotObject) {
-                slotObj = node->slotObj;
-                node->isSlotObject = false;
+            if (QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load()) {
+                senderLists->dirty.store(true);
+                slotObj = takeDisconnectedSlotObject(senderLists, node);
             }
 
             node = node->next;
@@ -1027,6 +1266,9 @@ QObject::~QObject()
                 locker.relock();
             }
         }
+
+        locker.unlock();
+        releaseConnections(orphans);
     }
 
     if (!d->children.isEmpty())
@@ -1517,16 +1759,34 @@ void QObject::moveToThread(QThread *targetThread)
     if (!targetData)
         targetData = new QThreadData(0);
 
+    // make sure nobody adds or removes connections to this object or its
+    // children while we're moving them, see setThreadData_helper(). The
+    // mutexes are locked in the same order as QOrderedMutexLocker does.
+    SignalSlotLockList signalSlotMutexes;
+    collectSignalSlotLocks(this, signalSlotMutexes);
+    std::sort(signalSlotMutexes.begin(), signalSlotMutexes.end(), std::less<QMutex *>());
+    signalSlotMutexes.resize(std::unique(signalSlotMutexes.begin(), signalSlotMutexes.end())
+                             - signalSlotMutexes.begin());
+    for (QMutex *mutex : qAsConst(signalSlotMutexes))
+        mutex->lock();
     QOrderedMutexLocker locker(&currentData->postEventList.mutex,
                                &targetData->postEventList.mutex);
 
     // keep currentData alive (since we've got it locked)
     currentData->ref();
 
+    // collect the events other threads posted without the lock, so that
+    // they move along with the object
+    currentData->postEventList.closeInbox();
+    QCoreApplicationPrivate::drainPostEventInbox(currentData);
+
     // move the object
     d_func()->setThreadData_helper(currentData, targetData);
 
+    currentData->postEventList.openInbox();
     locker.unlock();
+    for (QMutex *mutex : qAsConst(signalSlotMutexes))
+        mutex->unlock();
 
     // now currentData can commit suicide if it wants to
     currentData->deref();
@@ -1575,6 +1835,14 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     threadData->deref();
     threadData = targetData;
 
+    // the connections to this object tell QMetaObject::activate() where it
+    // lives; moveToThread() has locked the signalSlotLock() of this object
+    for (Connection *c = senders; c; c = c->next) {
+        targetData->ref();
+        if (QThreadData *td = c->receiverThreadData.fetchAndStoreRelease(targetData))
+            td->deref();
+    }
+
     for (int i = 0; i < children.size(); ++i) {
         QObject *child = children.at(i);
         child->d_func()->setThreadData_helper(currentData, targetData);
@@ -2480,13 +2748,13 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first.load();
                 while (c) {
-                    receivers += c->receiver ? 1 : 0;
-                    c = c->nextConnectionList;
+                    receivers += c->receiver.load() ? 1 : 0;
+                    c = c->nextConnectionList.load();
                 }
             }
         }
@@ -2528,17 +2796,17 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
     signalIndex += QMetaObjectPrivate::signalOffset(signal.mobj);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < sizeof(d->connectedSignals) * 8 && !d->connectionLists->dirty)
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < sizeof(d->connectedSignals) * 8 && !connectionLists->dirty.load())
             return d->isSignalConnected(signalIndex);
 
-        if (signalIndex < uint(d->connectionLists->count())) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first.load();
             while (c) {
-                if (c->receiver)
+                if (c->receiver.load())
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -2788,7 +3056,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if (((type & ~QObjectPrivate::CoalescedConnection) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(0);
     }
@@ -2869,7 +3137,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if (((type & ~QObjectPrivate::CoalescedConnection) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signal.parameterTypes())))
         return QMetaObject::Connection(0);
 
@@ -3311,18 +3579,21 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     QOrderedMutexLocker locker(signalSlotLock(sender),
                                signalSlotLock(receiver));
 
+    const bool coalesced = type & QObjectPrivate::CoalescedConnection;
+    type &= ~QObjectPrivate::CoalescedConnection;
+
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             int method_index_absolute = method_index + method_offset;
 
             while (c2) {
-                if (!c2->isSlotObject && c2->receiver == receiver && c2->method() == method_index_absolute)
+                if (!c2->isSlotObject && c2->receiver.load() == receiver && c2->method() == method_index_absolute)
                     return 0;
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type &= Qt::UniqueConnection - 1;
@@ -3331,18 +3602,21 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->method_relative = method_index;
     c->method_offset = method_offset;
     c->connectionType = type;
     c->isSlotObject = false;
+    c->isCoalesced = coalesced;
     c->argumentTypes.store(types);
-    c->nextConnectionList = 0;
     c->callFunction = callFunction;
 
-    QObjectPrivate::get(s)->addConnection(signal_index, c.data());
+    QObjectPrivate *senderPrivate = QObjectPrivate::get(s);
+    senderPrivate->addConnection(signal_index, c.data());
+    QObjectPrivate::Connection *orphans = senderPrivate->connectionLists.load()->takeOrphanedConnections();
 
     locker.unlock();
+    releaseConnections(orphans);
     QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
     if (smethod.isValid())
         s->connectNotify(smethod);
@@ -3389,41 +3663,32 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
 {
     bool success = false;
     while (c) {
-        if (c->receiver
-            && (receiver == 0 || (c->receiver == receiver
+        QObject *r = c->receiver.load();
+        if (r
+            && (receiver == 0 || (r == receiver
                            && (method_index < 0 || (!c->isSlotObject && c->method() == method_index))
                            && (slot == 0 || (c->isSlotObject && c->slotObj->compare(slot)))))) {
-            bool needToUnlock = false;
-            QMutex *receiverMutex = 0;
-            if (c->receiver) {
-                receiverMutex = signalSlotLock(c->receiver);
-                // need to relock this receiver and sender in the correct order
-                needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
-            }
-            if (c->receiver) {
+            QMutex *receiverMutex = signalSlotLock(r);
+            // need to relock this receiver and sender in the correct order
+            bool needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
+            if (c->receiver.load()) {
                 *c->prev = c->next;
                 if (c->next)
                     c->next->prev = c->prev;
             }
 
+            // with the receiver's mutex locked, as queued_activate() relies on it
+            c->receiver.storeRelease(nullptr);
+
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
-
-            if (c->isSlotObject) {
-                c->isSlotObject = false;
-                senderMutex->unlock();
-                c->slotObj->destroyIfLastRef();
-                senderMutex->lock();
-            }
-
             success = true;
 
             if (disconnectType == DisconnectOne)
                 return success;
         }
-        c = c->nextConnectionList;
+        c = c->nextConnectionList.load();
     }
     return success;
 }
@@ -3445,39 +3710,57 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
     QMutex *senderMutex = signalSlotLock(sender);
     QMutexLocker locker(senderMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
     if (!connectionLists)
         return false;
 
     // prevent incoming connections changing the connectionLists while unlocked
-    ++connectionLists->inUse;
+    connectionLists->inUse.ref();
 
     bool success = false;
     if (signal_index < 0) {
         // remove from all connection lists
         for (int sig_index = -1; sig_index < connectionLists->count(); ++sig_index) {
             QObjectPrivate::Connection *c =
-                (*connectionLists)[sig_index].first;
+                (*connectionLists)[sig_index].first.load();
             if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
                 success = true;
-                connectionLists->dirty = true;
+                connectionLists->dirty.store(true);
             }
         }
     } else if (signal_index < connectionLists->count()) {
         QObjectPrivate::Connection *c =
-            (*connectionLists)[signal_index].first;
+            (*connectionLists)[signal_index].first.load();
         if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
             success = true;
-            connectionLists->dirty = true;
+            connectionLists->dirty.store(true);
         }
     }
 
-    --connectionLists->inUse;
-    Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
-        delete connectionLists;
+    QVarLengthArray<QtPrivate::QSlotObjectBase *, 4> slotObjects;
+    if (connectionLists->orphaned.load()) {
+        if (!connectionLists->inUse.deref())
+            delete connectionLists;
+    } else if (!connectionLists->inUse.deref()) {
+        // Nothing is emitting, so the functors can be destroyed right away.
+        // Otherwise, this happens when the emission is done and the
+        // disconnected connections are removed from the lists.
+        const int first = signal_index < 0 ? -1 : signal_index;
+        const int last = signal_index < 0 ? connectionLists->count() - 1 : signal_index;
+        for (int sig_index = first; sig_index <= last && sig_index < connectionLists->count(); ++sig_index) {
+            QObjectPrivate::Connection *c = (*connectionLists)[sig_index].first.load();
+            for (; c; c = c->nextConnectionList.load()) {
+                if (c->isSlotObject && !c->receiver.load()) {
+                    c->isSlotObject = false;
+                    slotObjects.append(c->slotObj);
+                }
+            }
+        }
+    }
 
     locker.unlock();
+    for (QtPrivate::QSlotObjectBase *slotObj : qAsConst(slotObjects))
+        slotObj->destroyIfLastRef();
     if (success) {
         QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
         if (smethod.isValid())
@@ -3594,8 +3877,7 @@ void QMetaObject::connectSlotsByName(QObject *o)
 
     \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
 */
-static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv,
-                            QMutexLocker &locker)
+static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
 {
     const int *argumentTypes = c->argumentTypes.load();
     if (!argumentTypes) {
@@ -3625,19 +3907,41 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         for (int n = 1; n < nargs; ++n)
             types[n] = argumentTypes[n-1];
 
-        locker.unlock();
         for (int n = 1; n < nargs; ++n)
             args[n] = QMetaType::create(types[n], argv[n]);
-        locker.relock();
+    }
+
+    // The connection is only disconnected with the receiver's mutex locked,
+    // so holding it keeps the receiver and the functor alive until the call
+    // is queued.
+    QMutexLocker locker(signalSlotLock(c->receiver.load()));
+    QObject *receiver = c->receiver.load();
+    if (!receiver) {
+        locker.unlock();
+        // we have been disconnected before we got the mutex
+        for (int n = 1; n < nargs; ++n)
+            QMetaType::destroy(types[n], args[n]);
+        free(types);
+        free(args);
+        return;
+    }
+
+    if (c->isCoalesced) {
+        // An earlier call through this connection is still queued: hand it
+        // the new arguments instead of queueing another one. Emissions on a
+        // connection are serialized by the receiver's lock, so only the
+        // receiving side can race with us, and it waits while we're busy.
+        QMetaCallEvent *pending = c->coalescedEvent.fetchAndStoreAcquire(COALESCED_EVENT_BUSY);
+        Q_ASSERT(pending != COALESCED_EVENT_BUSY);
+        if (pending) {
+            args = pending->exchangeArguments(args);
+            c->coalescedEvent.storeRelease(pending);
 
-        if (!c->receiver) {
             locker.unlock();
-            // we have been disconnected while the mutex was unlocked
             for (int n = 1; n < nargs; ++n)
                 QMetaType::destroy(types[n], args[n]);
             free(types);
             free(args);
-            locker.relock();
             return;
         }
     }
@@ -3645,7 +3949,9 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
-    QCoreApplication::postEvent(c->receiver, ev);
+    if (c->isCoalesced)
+        ev->setCoalescingConnection(c);
+    QCoreApplication::postEvent(receiver, ev);
 }
 
 /*!
@@ -3690,64 +3996,75 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
     }
 
     {
-    QMutexLocker locker(signalSlotLock(sender));
+    // The lists are walked without locking the sender's mutex; holding a
+    // reference to them keeps everything reachable from them alive, see
+    // QObjectConnectionListVector.
     struct ConnectionListsRef {
+        QObject *sender;
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        ConnectionListsRef(QObject *sender, QObjectConnectionListVector *connectionLists)
+            : sender(sender), connectionLists(connectionLists)
         {
             if (connectionLists)
-                ++connectionLists->inUse;
+                connectionLists->inUse.ref();
         }
         ~ConnectionListsRef()
         {
-            if (!connectionLists)
+            if (!connectionLists || connectionLists->inUse.deref())
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
+            if (connectionLists->orphaned.loadAcquire()) {
+                delete connectionLists;
+            } else if (connectionLists->dirty.load()
+                       || connectionLists->orphanedConnections.load()
+                       || connectionLists->orphanedSignalLists.load()) {
+                // release what was disconnected while we were walking the lists
+                QMutexLocker locker(signalSlotLock(sender));
+                sender->d_func()->cleanConnectionLists();
+                QObjectPrivate::Connection *orphans = connectionLists->takeOrphanedConnections();
+                locker.unlock();
+                releaseConnections(orphans);
             }
         }
 
         QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
+    ConnectionListsRef connectionLists(sender, sender->d_func()->connectionLists.loadAcquire());
     if (!connectionLists.connectionLists) {
-        locker.unlock();
         if (qt_signal_spy_callback_set.signal_end_callback != 0)
             qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
         return;
     }
 
+    const QObjectConnectionListVector::SignalLists *signalLists =
+            connectionLists->signalLists.loadAcquire();
     const QObjectPrivate::ConnectionList *list;
-    if (signal_index < connectionLists->count())
-        list = &connectionLists->at(signal_index);
+    if (signalLists && signal_index < signalLists->count)
+        list = &signalLists->lists[signal_index];
     else
         list = &connectionLists->allsignals;
 
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
 
+    // We need to check against the highest connection id to ensure that
+    // signals added during the signal emission are not emitted in this emission.
+    const uint highestConnectionId = connectionLists->currentConnectionId.load();
+
     do {
-        QObjectPrivate::Connection *c = list->first;
-        if (!c) continue;
-        // We need to check against last here to ensure that signals added
-        // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
-
-        do {
-            if (!c->receiver)
+        QObjectPrivate::Connection *c = list->first.loadAcquire();
+        for (; c && c->id <= highestConnectionId; c = c->nextConnectionList.loadAcquire()) {
+            QObject * const receiver = c->receiver.loadAcquire();
+            if (!receiver)
                 continue;
 
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId.load();
+            const bool receiverInSameThread =
+                currentThreadId == c->receiverThreadData.loadAcquire()->threadId.load();
 
             // determine if this connection should be sent immediately or
             // put into the event queue
             if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
                 || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
+                queued_activate(sender, signal_index, c, argv ? argv : empty_argv);
                 continue;
 #if QT_CONFIG(thread)
             } else if (c->connectionType == Qt::BlockingQueuedConnection) {
@@ -3758,13 +4075,16 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                     receiver->metaObject()->className(), receiver);
                 }
                 QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
-                    new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
-                QCoreApplication::postEvent(receiver, ev);
-                locker.unlock();
+                {
+                    QMutexLocker locker(signalSlotLock(receiver));
+                    if (!c->receiver.load())
+                        continue; // disconnected before we got the mutex
+                    QMetaCallEvent *ev = c->isSlotObject ?
+                        new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
+                        new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
+                    QCoreApplication::postEvent(receiver, ev);
+                }
                 semaphore.acquire();
-                locker.relock();
                 continue;
 #endif
             }
@@ -3777,10 +4097,9 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
             if (c->isSlotObject) {
                 c->slotObj->ref();
                 QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
 
                 if (qt_signal_spy_callback_set.slot_object_begin_callback != 0)
-                    qt_signal_spy_callback_set.slot_object_begin_callback(c->slotObj, receiver, argv ? argv : empty_argv);
+                    qt_signal_spy_callback_set.slot_object_begin_callback(obj.data(), receiver, argv ? argv : empty_argv);
 
                 {
                     Q_TRACE_SCOPE(QMetaObject_activate_slot_functor, obj.data());
@@ -3788,20 +4107,12 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                 }
 
                 if (qt_signal_spy_callback_set.slot_object_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_object_end_callback(c->slotObj, receiver);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
+                    qt_signal_spy_callback_set.slot_object_end_callback(obj.data(), receiver);
             } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
                 //we compare the vtable to make sure we are not in the destructor of the object.
                 const int methodIndex = c->method();
                 const int method_relative = c->method_relative;
                 const auto callFunction = c->callFunction;
-                locker.unlock();
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0)
                     qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
 
@@ -3812,10 +4123,8 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
-                locker.relock();
             } else {
                 const int method = c->method_relative + c->method_offset;
-                locker.unlock();
 
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
                     qt_signal_spy_callback_set.slot_begin_callback(receiver,
@@ -3830,15 +4139,13 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, method);
-
-                locker.relock();
             }
 
-            if (connectionLists->orphaned)
+            if (connectionLists->orphaned.load())
                 break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+        }
 
-        if (connectionLists->orphaned)
+        if (connectionLists->orphaned.load())
             break;
     } while (list != &connectionLists->allsignals &&
         //start over for all signals;
@@ -4109,32 +4416,33 @@ void QObject::dumpObjectInfo() const
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
             while (c) {
-                if (!c->receiver) {
+                QObject *receiver = c->receiver.load();
+                if (!receiver) {
                     qDebug("          <Disconnected receiver>");
-                    c = c->nextConnectionList;
+                    c = c->nextConnectionList.load();
                     continue;
                 }
                 if (c->isSlotObject) {
                     qDebug("          <functor or function pointer>");
-                    c = c->nextConnectionList;
+                    c = c->nextConnectionList.load();
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = receiver->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       receiver->objectName().isEmpty() ? "unnamed" : qPrintable(receiver->objectName()),
                        method.methodSignature().constData());
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     } else {
@@ -4880,18 +5188,21 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QOrderedMutexLocker locker(signalSlotLock(sender),
                                signalSlotLock(receiver));
 
+    const bool coalesced = type & QObjectPrivate::CoalescedConnection;
+    type = static_cast<Qt::ConnectionType>(type & ~QObjectPrivate::CoalescedConnection);
+
     if (type & Qt::UniqueConnection && slot) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             while (c2) {
-                if (c2->receiver == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
+                if (c2->receiver.load() == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
                     slotObj->destroyIfLastRef();
                     return QMetaObject::Connection();
                 }
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type = static_cast<Qt::ConnectionType>(type ^ Qt::UniqueConnection);
@@ -4900,18 +5211,22 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->slotObj = slotObj;
     c->connectionType = type;
     c->isSlotObject = true;
+    c->isCoalesced = coalesced;
     if (types) {
         c->argumentTypes.store(types);
         c->ownArgumentTypes = false;
     }
 
-    QObjectPrivate::get(s)->addConnection(signal_index, c.data());
+    QObjectPrivate *senderPrivate = QObjectPrivate::get(s);
+    senderPrivate->addConnection(signal_index, c.data());
+    QObjectPrivate::Connection *orphans = senderPrivate->connectionLists.load()->takeOrphanedConnections();
     QMetaObject::Connection ret(c.take());
     locker.unlock();
+    releaseConnections(orphans);
 
     QMetaMethod method = QMetaObjectPrivate::signal(senderMetaObject, signal_index);
     Q_ASSERT(method.isValid());
@@ -4932,30 +5247,31 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
 {
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(connection.d_ptr);
 
-    if (!c || !c->receiver)
+    if (!c || !c->receiver.load())
         return false;
 
     QMutex *senderMutex = signalSlotLock(c->sender);
-    QMutex *receiverMutex = signalSlotLock(c->receiver);
+    QMutex *receiverMutex = signalSlotLock(c->receiver.load());
 
+    QtPrivate::QSlotObjectBase *slotObj = nullptr;
     {
         QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists.load();
         Q_ASSERT(connectionLists);
-        connectionLists->dirty = true;
+        connectionLists->dirty.store(true);
 
         *c->prev = c->next;
         if (c->next)
             c->next->prev = c->prev;
-        c->receiver = 0;
+        c->receiver.storeRelease(nullptr);
+
+        slotObj = takeDisconnectedSlotObject(connectionLists, c);
     }
 
     // destroy the QSlotObject, if possible
-    if (c->isSlotObject) {
-        c->slotObj->destroyIfLastRef();
-        c->isSlotObject = false;
-    }
+    if (slotObj)
+        slotObj->destroyIfLastRef();
 
     c->sender->disconnectNotify(QMetaObjectPrivate::signal(c->sender->metaObject(),
                                                            c->signal_index));
@@ -5142,7 +5458,7 @@ bool QMetaObject::Connection::isConnected_helper() const
     Q_ASSERT(d_ptr);    // we're only called from operator RestrictedBool() const
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(d_ptr);
 
-    return c->receiver;
+    return c->receiver.load();
 }
 
 
@@ -66,6 +66,7 @@ QT_BEGIN_NAMESPACE
 
 class QVariant;
 class QThreadData;
+class QMetaCallEvent;
 class QObjectConnectionListVector;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
@@ -129,29 +130,46 @@ public:
         QString objectName;
     };
 
+    // Connection type flag for connect(), to be OR'ed with Qt::AutoConnection
+    // or Qt::QueuedConnection: while a queued call through the connection has
+    // not been delivered yet, later emissions replace its arguments instead of
+    // queueing another call
+    enum ConnectionTypeFlag { CoalescedConnection = 0x40 };
+
     typedef void (*StaticMetaCallFunction)(QObject *, QMetaObject::Call, int, void **);
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        QAtomicPointer<QObject> receiver;
+        // the thread data of the receiver, so that QMetaObject::activate()
+        // doesn't have to look at a receiver that may be destroyed meanwhile
+        QAtomicPointer<QThreadData> receiverThreadData;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
         };
         // The next pointer for the singly-linked ConnectionList
-        Connection *nextConnectionList;
+        QAtomicPointer<Connection> nextConnectionList;
+        // The next pointer for the list of connections waiting to be deleted
+        Connection *nextInOrphanList;
         //senders linked list
         Connection *next;
         Connection **prev;
         QAtomicPointer<const int> argumentTypes;
+        // for CoalescedConnection: the queued call that has not been
+        // delivered yet, see queued_activate()
+        QAtomicPointer<QMetaCallEvent> coalescedEvent;
         QAtomicInt ref_;
+        uint id; // in order of connection, see QMetaObject::activate()
         ushort method_offset;
         ushort method_relative;
         uint signal_index : 27; // In signal range (see QObjectPrivate::signalIndex())
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(nullptr), ref_(2), ownArgumentTypes(true) {
+        ushort isCoalesced : 1;
+        Connection() : nextConnectionList(nullptr), nextInOrphanList(nullptr), ref_(2), id(0),
+                       ownArgumentTypes(true), isCoalesced(false) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -159,7 +177,7 @@ public:
         void ref() { ref_.ref(); }
         void deref() {
             if (!ref_.deref()) {
-                Q_ASSERT(!receiver);
+                Q_ASSERT(!receiver.load());
                 delete this;
             }
         }
@@ -167,7 +185,7 @@ public:
     // ConnectionList is a singly-linked list
     struct ConnectionList {
         ConnectionList() : first(nullptr), last(nullptr) {}
-        Connection *first;
+        QAtomicPointer<Connection> first;
         Connection *last;
     };
 
@@ -234,7 +252,7 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -399,7 +417,14 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+    // for QObjectPrivate::CoalescedConnection
+    void setCoalescingConnection(QObjectPrivate::Connection *c);
+    inline void **exchangeArguments(void **args)
+    { void **old = args_; args_ = args; return old; }
+
 private:
+    void detachFromCoalescingConnection();
+
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
     int signalId_;
@@ -408,6 +433,7 @@ private:
     void **args_;
     QSemaphore *semaphore_;
     QObjectPrivate::StaticMetaCallFunction callFunction_;
+    QObjectPrivate::Connection *coalescingConnection_;
     ushort method_offset_;
     ushort method_relative_;
 };
@@ -45,6 +45,11 @@
 #include "private/qtimerinfo_unix_p.h"
 #include "private/qobject_p.h"
 #include "private/qabstracteventdispatcher_p.h"
+#include "private/qeventloopinstrumentation_p.h"
+
+#include <qvarlengtharray.h>
+
+#include <algorithm>
 
 #ifdef QTIMERINFO_DEBUG
 #  include <QDebug>
@@ -84,6 +89,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = 0;
+    nextSequence = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -174,18 +180,124 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+enum { TimerHeapArity = 4 };
+
+static inline bool timerFiresBefore(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    // timers with the same timeout fire in the order they were (re)inserted
+    return t1->sequence < t2->sequence;
+}
+
+void QTimerInfoList::siftUp(int index)
+{
+    QTimerInfo *t = at(index);
+    while (index > 0) {
+        const int parent = (index - 1) / TimerHeapArity;
+        QTimerInfo *p = at(parent);
+        if (!timerFiresBefore(t, p))
+            break;
+        (*this)[index] = p;
+        p->heapIndex = index;
+        index = parent;
+    }
+    (*this)[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::siftDown(int index)
+{
+    const int n = size();
+    QTimerInfo *t = at(index);
+    for (;;) {
+        const int firstChild = index * TimerHeapArity + 1;
+        if (firstChild >= n)
+            break;
+
+        int best = firstChild;
+        const int lastChild = qMin(firstChild + TimerHeapArity, n);
+        for (int child = firstChild + 1; child < lastChild; ++child) {
+            if (timerFiresBefore(at(child), at(best)))
+                best = child;
+        }
+        QTimerInfo *c = at(best);
+        if (!timerFiresBefore(c, t))
+            break;
+        (*this)[index] = c;
+        c->heapIndex = index;
+        index = best;
+    }
+    (*this)[index] = t;
+    t->heapIndex = index;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    ti->sequence = nextSequence++;
+    append(ti);
+    siftUp(size() - 1);
+}
+
+/*
+  remove timer info from list, without deleting it
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    const int index = ti->heapIndex;
+    Q_ASSERT(index >= 0 && index < size() && at(index) == ti);
+
+    QTimerInfo *last = takeLast();
+    if (last == ti)
+        return;
+
+    (*this)[index] = last;
+    last->heapIndex = index;
+    if (index > 0 && timerFiresBefore(last, at((index - 1) / TimerHeapArity)))
+        siftUp(index);
+    else
+        siftDown(index);
+}
+
+/*
+  Returns the first timer that is not currently being activated. Timers
+  whose event is being delivered are skipped; there are at most as many
+  of them as there are nested event loops, so the search stays short.
+*/
+QTimerInfo *QTimerInfoList::firstWaitingTimer() const
+{
+    if (isEmpty())
+        return 0;
+    if (!constFirst()->activateRef)
+        return constFirst();
+
+    // visit the heap in timeout order, starting from the root
+    QVarLengthArray<int, 16> candidates;
+    candidates.append(0);
+    while (!candidates.isEmpty()) {
+        int best = 0;
+        for (int i = 1; i < candidates.size(); ++i) {
+            if (timerFiresBefore(at(candidates.at(i)), at(candidates.at(best))))
+                best = i;
+        }
+        const int index = candidates.at(best);
+        candidates.remove(best);
+
+        QTimerInfo *t = at(index);
+        if (!t->activateRef)
+            return t;
+
+        const int firstChild = index * TimerHeapArity + 1;
+        const int lastChild = qMin(firstChild + TimerHeapArity, size());
+        for (int child = firstChild; child < lastChild; ++child)
+            candidates.append(child);
     }
-    insert(index+1, ti);
+    return 0;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -389,14 +501,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
-
+    QTimerInfo *t = firstWaitingTimer();
     if (!t)
       return false;
 
@@ -423,16 +528,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -494,6 +596,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     }
 
     timerInsert(t);
+    timersById.insert(timerId, t);
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -508,56 +611,64 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = 0;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
+
+    QVarLengthArray<QTimerInfo *, 16> found;
     for (int i = 0; i < count(); ++i) {
         QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+        if (t->obj == object)
+            found.append(t);
+    }
+
+    for (QTimerInfo *t : qAsConst(found)) {
+        timersById.remove(t->id);
+        timerRemove(t);
+        if (t == firstTimerInfo)
+            firstTimerInfo = 0;
+        if (t->activateRef)
+            *(t->activateRef) = 0;
+        delete t;
     }
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
-    QList<QAbstractEventDispatcher::TimerInfo> list;
+    QVarLengthArray<const QTimerInfo *, 16> found;
     for (int i = 0; i < count(); ++i) {
         const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+        if (t->obj == object)
+            found.append(t);
+    }
+    // report them in firing order, as the sorted list used to
+    std::sort(found.begin(), found.end(), timerFiresBefore);
+
+    QList<QAbstractEventDispatcher::TimerInfo> list;
+    list.reserve(found.size());
+    for (const QTimerInfo *t : qAsConst(found)) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -578,11 +689,21 @@ int QTimerInfoList::activateTimers()
     repairTimersIfNeeded();
 
 
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
+    // Find out how many timer have expired; they form a subtree at the
+    // top of the heap
+    QVarLengthArray<int, 64> expired;
+    if (!(currentTime < constFirst()->timeout))
+        expired.append(0);
+    while (!expired.isEmpty()) {
+        const int index = expired.last();
+        expired.removeLast();
         maxCount++;
+        const int firstChild = index * TimerHeapArity + 1;
+        const int lastChild = qMin(firstChild + TimerHeapArity, size());
+        for (int child = firstChild; child < lastChild; ++child) {
+            if (!(currentTime < at(child)->timeout))
+                expired.append(child);
+        }
     }
 
     //fire the timers.
@@ -604,8 +725,18 @@ int QTimerInfoList::activateTimers()
             firstTimerInfo = currentTimerInfo;
         }
 
+        // taken now, as the timer event may kill the timer or delete its object
+        const bool instrumented = qt_eventLoopInstrumentationActive();
+        quint64 lateness = 0;
+        QByteArray className;
+        if (instrumented) {
+            const timespec late = currentTime - currentTimerInfo->timeout;
+            lateness = quint64(late.tv_sec) * 1000 * 1000 * 1000 + quint64(late.tv_nsec);
+            className = currentTimerInfo->obj->metaObject()->className();
+        }
+
         // remove from list
-        removeFirst();
+        timerRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -645,6 +776,11 @@ int QTimerInfoList::activateTimers()
             if (currentTimerInfo)
                 currentTimerInfo->activateRef = 0;
         }
+
+        if (instrumented) {
+            qt_recordEventLoopMeasurement(QEventLoopTimerLateness, lateness,
+                                          QEvent::Timer, className.constData());
+        }
     }
 
     firstTimerInfo = 0;
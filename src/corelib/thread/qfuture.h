@@ -228,6 +228,7 @@ public:
 
 private:
     friend class QFutureWatcher<void>;
+    friend class QFutureInterfaceBasePrivate;
 
 #ifdef QFUTURE_TEST
 public:
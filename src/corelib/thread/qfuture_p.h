@@ -0,0 +1,559 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFUTURE_P_H
+#define QFUTURE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/private/qfutureinterface_p.h>
+
+#include <iterator>
+#include <type_traits>
+
+QT_REQUIRE_CONFIG(future);
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Continuations of QFuture objects: futureThen() and futureOnFailed() attach
+    a function that is run by the thread that finishes the future, without a
+    QFutureWatcher or an event loop, and return a future for its result.
+    whenAll() and whenAny() combine a range of futures into one.
+*/
+
+namespace QtPrivate {
+
+template <typename...>
+struct FutureVoid { typedef void type; };
+
+// FutureCallable<F(Args...)>::value tells whether F can be called with Args
+template <typename Signature, typename = void>
+struct FutureCallable
+{
+    enum { value = false };
+};
+
+template <typename F, typename... Args>
+struct FutureCallable<F(Args...),
+                      typename FutureVoid<decltype(std::declval<F &>()(std::declval<Args>()...))>::type>
+{
+    enum { value = true };
+    typedef decltype(std::declval<F &>()(std::declval<Args>()...)) Result;
+};
+
+// a continuation of a QFuture<T> is called with its result, or with the future itself
+template <typename T, typename F>
+struct FutureContinuationTraits
+{
+    enum { TakesResult = FutureCallable<F(const T &)>::value };
+    typedef typename std::conditional<TakesResult,
+                                      FutureCallable<F(const T &)>,
+                                      FutureCallable<F(QFuture<T> &)> >::type Callable;
+    typedef typename std::decay<typename Callable::Result>::type Result;
+};
+
+template <typename F>
+struct FutureContinuationTraits<void, F>
+{
+    enum { TakesResult = FutureCallable<F()>::value };
+    typedef typename std::conditional<TakesResult,
+                                      FutureCallable<F()>,
+                                      FutureCallable<F(QFuture<void> &)> >::type Callable;
+    typedef typename std::decay<typename Callable::Result>::type Result;
+};
+
+template <typename Future>
+struct FutureResultType;
+
+template <typename T>
+struct FutureResultType<QFuture<T> >
+{
+    typedef T type;
+};
+
+template <typename T>
+struct WhenAnyResult
+{
+    int index = -1;
+    QFuture<T> future;
+};
+
+// the QFutureInterface<T> of the future a continuation is run for
+template <typename T>
+class FutureInterfaceRef : public QFutureInterface<T>
+{
+public:
+    explicit FutureInterfaceRef(const QFutureInterfaceBase &other)
+    {
+        this->derefT();
+        QFutureInterfaceBase::operator=(other);
+        this->refT();
+    }
+};
+
+template <>
+class FutureInterfaceRef<void> : public QFutureInterface<void>
+{
+public:
+    explicit FutureInterfaceRef(const QFutureInterfaceBase &other)
+    {
+        QFutureInterfaceBase::operator=(other);
+    }
+};
+
+template <typename R>
+struct FutureResultReporter
+{
+    template <typename Call>
+    static void report(QFutureInterface<R> &promise, Call call)
+    { promise.reportResult(call()); }
+};
+
+template <>
+struct FutureResultReporter<void>
+{
+    template <typename Call>
+    static void report(QFutureInterface<void> &, Call call)
+    { call(); }
+};
+
+template <typename T, typename F, bool TakesResult = FutureContinuationTraits<T, F>::TakesResult>
+struct FutureContinuationInvoker
+{
+    static bool canInvoke(const QFuture<T> &parent)
+    { return !parent.isCanceled() && parent.isResultReadyAt(0); }
+    static typename FutureContinuationTraits<T, F>::Callable::Result invoke(F &function, QFuture<T> &parent)
+    { return function(parent.result()); }
+};
+
+template <typename F>
+struct FutureContinuationInvoker<void, F, true>
+{
+    static bool canInvoke(const QFuture<void> &parent)
+    { return !parent.isCanceled(); }
+    static typename FutureContinuationTraits<void, F>::Callable::Result invoke(F &function, QFuture<void> &)
+    { return function(); }
+};
+
+template <typename T, typename F>
+struct FutureContinuationInvoker<T, F, false>
+{
+    static bool canInvoke(const QFuture<T> &)
+    { return true; }
+    static typename FutureContinuationTraits<T, F>::Callable::Result invoke(F &function, QFuture<T> &parent)
+    { return function(parent); }
+};
+
+// finishes promise the way parent failed: with its exception, or canceled
+inline void futurePropagateFailure(QFutureInterfaceBase &parent, QFutureInterfaceBase &promise)
+{
+#ifndef QT_NO_EXCEPTIONS
+    QtPrivate::ExceptionStore &exceptions = parent.exceptionStore();
+    if (exceptions.hasException())
+        promise.reportException(*exceptions.exception().exception());
+    else
+#else
+    Q_UNUSED(parent);
+#endif
+        promise.reportCanceled();
+    promise.reportFinished();
+}
+
+// finishes promise as canceled, for continuations destroyed without having
+// been run because the future they were waiting for went away unfinished
+inline void futureCancelUnfinished(QFutureInterfaceBase &promise)
+{
+    if (promise.isFinished())
+        return;
+    promise.reportCanceled();
+    promise.reportFinished();
+}
+
+template <typename T, typename F>
+class FutureContinuationRunnable;
+
+template <typename T, typename F>
+class FutureContinuation : public QFutureContinuation
+{
+public:
+    typedef typename FutureContinuationTraits<T, F>::Result Result;
+    typedef FutureContinuationInvoker<T, F> Invoker;
+
+    FutureContinuation(const QFutureInterface<Result> &promise, F &&function, QThreadPool *pool)
+        : m_promise(promise), m_function(std::move(function)), m_pool(pool), m_ran(false)
+    { }
+
+    ~FutureContinuation()
+    {
+        if (!m_ran)
+            futureCancelUnfinished(m_promise);
+    }
+
+    void run(const QFutureInterfaceBase &parentData) override
+    {
+        m_ran = true;
+        FutureInterfaceRef<T> parentInterface(parentData);
+        QFuture<T> parent(&parentInterface);
+        if (m_pool)
+            m_pool->start(new FutureContinuationRunnable<T, F>(m_promise, std::move(m_function), parent));
+        else
+            call(m_promise, m_function, parent);
+    }
+
+    static void call(QFutureInterface<Result> &promise, F &function, QFuture<T> &parent)
+    {
+        if (promise.isCanceled()) {
+            promise.reportFinished();
+            return;
+        }
+        if (!Invoker::canInvoke(parent)) {
+            futurePropagateFailure(QFutureInterfaceBasePrivate::futureInterface(parent), promise);
+            return;
+        }
+
+#ifndef QT_NO_EXCEPTIONS
+        try {
+#endif
+            FutureResultReporter<Result>::report(promise, [&function, &parent]() {
+                return Invoker::invoke(function, parent);
+            });
+#ifndef QT_NO_EXCEPTIONS
+        } catch (const QException &e) {
+            promise.reportException(e);
+        } catch (...) {
+            promise.reportException(QUnhandledException());
+        }
+#endif
+        promise.reportFinished();
+    }
+
+private:
+    QFutureInterface<Result> m_promise;
+    F m_function;
+    QThreadPool *m_pool;
+    bool m_ran;
+};
+
+template <typename T, typename F>
+class FutureContinuationRunnable : public QRunnable
+{
+public:
+    typedef typename FutureContinuationTraits<T, F>::Result Result;
+
+    FutureContinuationRunnable(const QFutureInterface<Result> &promise, F &&function,
+                               const QFuture<T> &parent)
+        : m_promise(promise), m_function(std::move(function)), m_parent(parent)
+    { }
+
+    // the pool may be cleared before running it
+    ~FutureContinuationRunnable()
+    { futureCancelUnfinished(m_promise); }
+
+    void run() override
+    { FutureContinuation<T, F>::call(m_promise, m_function, m_parent); }
+
+private:
+    QFutureInterface<Result> m_promise;
+    F m_function;
+    QFuture<T> m_parent;
+};
+
+// Calls function once future has finished, by the thread that finishes it,
+// or on pool if that is not null
+template <typename T, typename Function>
+QFuture<typename FutureContinuationTraits<T, typename std::decay<Function>::type>::Result>
+futureThen(const QFuture<T> &future, QThreadPool *pool, Function &&function)
+{
+    typedef typename std::decay<Function>::type F;
+    typedef typename FutureContinuationTraits<T, F>::Result Result;
+    QFutureInterface<Result> promise;
+    promise.reportStarted();
+    QFutureInterfaceBasePrivate::addContinuation(
+            QFutureInterfaceBasePrivate::futureInterface(future),
+            new FutureContinuation<T, F>(promise, F(std::forward<Function>(function)), pool));
+    return promise.future();
+}
+
+template <typename T, typename Function>
+QFuture<typename FutureContinuationTraits<T, typename std::decay<Function>::type>::Result>
+futureThen(const QFuture<T> &future, Function &&function)
+{
+    return futureThen(future, nullptr, std::forward<Function>(function));
+}
+
+#ifndef QT_NO_EXCEPTIONS
+
+// the type of exception a failure handler takes, if any
+template <typename F>
+struct FutureFailureHandlerTraits : FutureFailureHandlerTraits<decltype(&F::operator())>
+{ };
+
+template <typename R>
+struct FutureFailureHandlerTraits<R (*)()>
+{
+    enum { TakesException = false };
+    typedef void Exception;
+};
+
+template <typename R, typename E>
+struct FutureFailureHandlerTraits<R (*)(E)>
+{
+    enum { TakesException = true };
+    typedef typename std::decay<E>::type Exception;
+};
+
+template <typename C, typename R>
+struct FutureFailureHandlerTraits<R (C::*)()> : FutureFailureHandlerTraits<R (*)()>
+{ };
+
+template <typename C, typename R>
+struct FutureFailureHandlerTraits<R (C::*)() const> : FutureFailureHandlerTraits<R (*)()>
+{ };
+
+template <typename C, typename R, typename E>
+struct FutureFailureHandlerTraits<R (C::*)(E)> : FutureFailureHandlerTraits<R (*)(E)>
+{ };
+
+template <typename C, typename R, typename E>
+struct FutureFailureHandlerTraits<R (C::*)(E) const> : FutureFailureHandlerTraits<R (*)(E)>
+{ };
+
+// Calls handler if it takes exception. The exception is matched by its
+// dynamic type, so that QException::raise() need not be reimplemented.
+template <typename T, typename F, bool TakesException = FutureFailureHandlerTraits<F>::TakesException>
+struct FutureFailureHandlerInvoker
+{
+    static bool invoke(F &handler, QException *exception, QFutureInterface<T> &promise)
+    {
+        typedef typename FutureFailureHandlerTraits<F>::Exception Exception;
+        Exception *e = dynamic_cast<Exception *>(exception);
+        if (!e)
+            return false;
+        FutureResultReporter<T>::report(promise, [&handler, e]() { return handler(*e); });
+        return true;
+    }
+};
+
+template <typename T, typename F>
+struct FutureFailureHandlerInvoker<T, F, false>
+{
+    static bool invoke(F &handler, QException *, QFutureInterface<T> &promise)
+    {
+        FutureResultReporter<T>::report(promise, [&handler]() { return handler(); });
+        return true;
+    }
+};
+
+template <typename T>
+struct FutureResultCopier
+{
+    static void copy(QFuture<T> &parent, QFutureInterface<T> &promise)
+    { promise.reportResults(parent.results().toVector()); }
+};
+
+template <>
+struct FutureResultCopier<void>
+{
+    static void copy(QFuture<void> &, QFutureInterface<void> &)
+    { }
+};
+
+template <typename T, typename F>
+class FutureFailureHandler : public QFutureContinuation
+{
+public:
+    FutureFailureHandler(const QFutureInterface<T> &promise, F &&handler)
+        : m_promise(promise), m_handler(std::move(handler))
+    { }
+
+    ~FutureFailureHandler()
+    { futureCancelUnfinished(m_promise); }
+
+    void run(const QFutureInterfaceBase &parentData) override
+    {
+        FutureInterfaceRef<T> parentInterface(parentData);
+        QFuture<T> parent(&parentInterface);
+
+        QtPrivate::ExceptionStore &exceptions = parentInterface.exceptionStore();
+        if (!exceptions.hasException()) {
+            if (parent.isCanceled())
+                m_promise.reportCanceled();
+            else
+                FutureResultCopier<T>::copy(parent, m_promise);
+            m_promise.reportFinished();
+            return;
+        }
+
+        QException *exception = exceptions.exception().exception();
+        try {
+            if (!FutureFailureHandlerInvoker<T, F>::invoke(m_handler, exception, m_promise))
+                m_promise.reportException(*exception);
+        } catch (const QException &e) {
+            m_promise.reportException(e);
+        } catch (...) {
+            m_promise.reportException(QUnhandledException());
+        }
+        m_promise.reportFinished();
+    }
+
+private:
+    QFutureInterface<T> m_promise;
+    F m_handler;
+};
+
+// Calls handler if future raises an exception, which handler either takes
+// by reference or not at all; the returned future has the results of future
+// otherwise
+template <typename T, typename Function>
+QFuture<T> futureOnFailed(const QFuture<T> &future, Function &&handler)
+{
+    typedef typename std::decay<Function>::type F;
+    QFutureInterface<T> promise;
+    promise.reportStarted();
+    QFutureInterfaceBasePrivate::addContinuation(
+            QFutureInterfaceBasePrivate::futureInterface(future),
+            new FutureFailureHandler<T, F>(promise, F(std::forward<Function>(handler))));
+    return promise.future();
+}
+
+#endif // QT_NO_EXCEPTIONS
+
+template <typename InputIt>
+QFuture<QList<typename std::iterator_traits<InputIt>::value_type> > whenAll(InputIt first, InputIt last)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type Future;
+    struct Context
+    {
+        // canceled if one of the futures went away unfinished
+        ~Context() { futureCancelUnfinished(promise); }
+
+        QFutureInterface<QList<Future> > promise;
+        // filled in as the futures finish: holding them before would keep
+        // them alive through their own continuations
+        QList<Future> futures;
+        QMutex mutex;
+        QAtomicInt remaining;
+    };
+
+    QList<Future> futures;
+    for (; first != last; ++first)
+        futures.append(*first);
+
+    QSharedPointer<Context> context(new Context);
+    context->promise.reportStarted();
+    QFuture<QList<Future> > all = context->promise.future();
+
+    if (futures.isEmpty()) {
+        context->promise.reportFinished(&context->futures);
+        return all;
+    }
+
+    for (int index = 0; index < futures.size(); ++index)
+        context->futures.append(Future());
+    context->remaining.store(futures.size());
+    for (int index = 0; index < futures.size(); ++index) {
+        futureThen(futures.at(index), [context, index](const Future &finished) {
+            {
+                QMutexLocker locker(&context->mutex);
+                context->futures[index] = finished;
+            }
+            if (!context->remaining.deref())
+                context->promise.reportFinished(&context->futures);
+        });
+    }
+    return all;
+}
+
+template <typename InputIt>
+QFuture<WhenAnyResult<typename FutureResultType<typename std::iterator_traits<InputIt>::value_type>::type> >
+whenAny(InputIt first, InputIt last)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type Future;
+    typedef WhenAnyResult<typename FutureResultType<Future>::type> Result;
+    struct Context
+    {
+        // canceled if all of the futures went away unfinished
+        ~Context() { futureCancelUnfinished(promise); }
+
+        QFutureInterface<Result> promise;
+        QAtomicInt finished;
+    };
+
+    QSharedPointer<Context> context(new Context);
+    context->promise.reportStarted();
+    QFuture<Result> any = context->promise.future();
+
+    if (first == last) {
+        const Result none;
+        context->promise.reportFinished(&none);
+        return any;
+    }
+
+    for (int index = 0; first != last; ++first, ++index) {
+        futureThen(*first, [context, index](const Future &finished) {
+            if (context->finished.testAndSetOrdered(0, 1)) {
+                Result result;
+                result.index = index;
+                result.future = finished;
+                context->promise.reportFinished(&result);
+            }
+        });
+    }
+    return any;
+}
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QFUTURE_P_H
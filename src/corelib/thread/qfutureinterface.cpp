@@ -290,6 +290,15 @@ void QFutureInterfaceBase::reportFinished()
         switch_from_to(d->state, Running, Finished);
         d->waitCondition.wakeAll();
         d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+
+        // run the continuations without the lock, they may well use this future
+        QList<QFutureContinuation *> continuations;
+        continuations.swap(d->continuations);
+        locker.unlock();
+        for (QFutureContinuation *continuation : qAsConst(continuations)) {
+            continuation->run(*this);
+            delete continuation;
+        }
     }
 }
 
@@ -471,6 +480,11 @@ QFutureInterfaceBasePrivate::QFutureInterfaceBasePrivate(QFutureInterfaceBase::S
     progressTime.invalidate();
 }
 
+QFutureInterfaceBasePrivate::~QFutureInterfaceBasePrivate()
+{
+    qDeleteAll(continuations);
+}
+
 int QFutureInterfaceBasePrivate::internal_resultCount() const
 {
     return m_results.count(); // ### subtract canceled results.
@@ -599,6 +613,28 @@ void QFutureInterfaceBasePrivate::disconnectOutputInterface(QFutureCallOutInterf
     interface->callOutInterfaceDisconnected();
 }
 
+/*!
+    \internal
+
+    Makes \a continuation run with \a future as the argument when it
+    finishes, by the thread that reports it finished, and deletes it after.
+    If \a future has already finished, \a continuation is run right away by
+    the calling thread. Continuations added earlier are run first.
+*/
+void QFutureInterfaceBasePrivate::addContinuation(QFutureInterfaceBase &future,
+                                                  QFutureContinuation *continuation)
+{
+    QMutexLocker locker(&future.d->m_mutex);
+    if (!future.isFinished()) {
+        future.d->continuations.append(continuation);
+        return;
+    }
+
+    locker.unlock();
+    continuation->run(future);
+    delete continuation;
+}
+
 void QFutureInterfaceBasePrivate::setState(QFutureInterfaceBase::State newState)
 {
     state.store(newState);
@@ -139,6 +139,7 @@ private:
 private:
     friend class QFutureWatcherBase;
     friend class QFutureWatcherBasePrivate;
+    friend class QFutureInterfaceBasePrivate;
 };
 
 template <typename T>
@@ -126,10 +126,19 @@ public:
     virtual void callOutInterfaceDisconnected() = 0;
 };
 
+// A function to run once a future has finished, see QtPrivate::futureThen()
+class QFutureContinuation
+{
+public:
+    virtual ~QFutureContinuation() {}
+    virtual void run(const QFutureInterfaceBase &future) = 0;
+};
+
 class QFutureInterfaceBasePrivate
 {
 public:
     QFutureInterfaceBasePrivate(QFutureInterfaceBase::State initialState);
+    ~QFutureInterfaceBasePrivate();
 
     // When the last QFuture<T> reference is removed, we need to make
     // sure that data stored in the ResultStore is cleaned out.
@@ -174,6 +183,7 @@ public:
     QString m_progressText;
     QRunnable *runnable;
     QThreadPool *m_pool;
+    QList<QFutureContinuation *> continuations;
 
     inline QThreadPool *pool() const
     { return m_pool ? m_pool : QThreadPool::globalInstance(); }
@@ -191,6 +201,14 @@ public:
     void disconnectOutputInterface(QFutureCallOutInterface *iface);
 
     void setState(QFutureInterfaceBase::State state);
+
+    // Takes ownership of continuation, which is run once future has finished
+    Q_CORE_EXPORT static void addContinuation(QFutureInterfaceBase &future,
+                                              QFutureContinuation *continuation);
+
+    template <typename Future>
+    static auto futureInterface(const Future &future) -> decltype(future.d) &
+    { return future.d; }
 };
 
 QT_END_NAMESPACE
@@ -98,6 +98,13 @@ QThreadData::~QThreadData()
         }
     }
 
+    if (QPostEventQueue *queue = postEventList.inbox.load()) {
+        queue->consume([](const QPostEvent &pe) {
+            pe.event->posted = false;
+            delete pe.event;
+        });
+    }
+
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
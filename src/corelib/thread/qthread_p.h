@@ -102,6 +102,85 @@ inline bool operator<(const QPostEvent &first, const QPostEvent &second)
     return first.priority > second.priority;
 }
 
+// Bounded queue that threads other than the receiver's push posted events
+// onto without taking the post event list mutex. Any number of threads may
+// claim and publish cells; a single consumer, holding the mutex, takes them
+// in claim order. Every cell carries a sequence number telling whether it
+// is free, claimed or published for the current lap around the ring.
+class QPostEventQueue
+{
+public:
+    enum { Capacity = 256 };
+
+    QPostEventQueue()
+    {
+        for (quint32 i = 0; i < Capacity; ++i)
+            cells[i].sequence.store(i);
+    }
+
+    // Reserves the next cell; returns false if the queue is full. A claimed
+    // cell must be published, otherwise the consumer waits forever.
+    bool claim(quint32 *position)
+    {
+        quint32 pos = tail.load();
+        for (;;) {
+            Cell &cell = cells[pos % Capacity];
+            const qint32 diff = qint32(cell.sequence.loadAcquire() - pos);
+            if (diff == 0) {
+                if (tail.testAndSetOrdered(pos, pos + 1, pos)) {
+                    *position = pos;
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load();
+            }
+        }
+    }
+
+    // A null event publishes an empty cell that the consumer skips.
+    void publish(quint32 position, const QPostEvent &ev)
+    {
+        Cell &cell = cells[position % Capacity];
+        cell.event = ev;
+        cell.sequence.storeRelease(position + 1);
+    }
+
+    bool isEmpty() const
+    { return head.load() == tail.loadAcquire(); }
+
+    // Takes every cell claimed so far, waiting for the ones still being
+    // filled in. Must be called with the post event list mutex held.
+    template <typename Func>
+    void consume(Func func)
+    {
+        const quint32 end = tail.loadAcquire();
+        quint32 pos = head.load();
+        while (pos != end) {
+            Cell &cell = cells[pos % Capacity];
+            while (cell.sequence.loadAcquire() != pos + 1)
+                QThread::yieldCurrentThread();
+            const QPostEvent ev = cell.event;
+            cell.sequence.storeRelease(pos + Capacity);
+            head.store(++pos);
+            if (ev.event)
+                func(ev);
+        }
+    }
+
+private:
+    struct Cell
+    {
+        QAtomicInteger<quint32> sequence;
+        QPostEvent event;
+    };
+
+    QAtomicInteger<quint32> tail;
+    QAtomicInteger<quint32> head;
+    Cell cells[Capacity];
+};
+
 // This class holds the list of posted events.
 //  The list has to be kept sorted by priority
 class QPostEventList : public QVector<QPostEvent>
@@ -117,10 +196,65 @@ public:
 
     QMutex mutex;
 
+    // Events posted from other threads go to this queue, created on first
+    // use, without taking the mutex. Whoever holds the mutex merges them
+    // into the sorted list (see QCoreApplicationPrivate::drainPostEventInbox())
+    // before looking at it.
+    QAtomicPointer<QPostEventQueue> inbox;
+    // set by QObject::moveToThread() to send posters through the mutex
+    QAtomicInt inboxClosed;
+
     inline QPostEventList()
         : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
     { }
 
+    ~QPostEventList()
+    { delete inbox.load(); }
+
+    bool hasPendingInboxEvents() const
+    {
+        const QPostEventQueue *queue = inbox.loadAcquire();
+        return queue && !queue->isEmpty();
+    }
+
+    QPostEventQueue *ensureInbox()
+    {
+        QPostEventQueue *queue = inbox.loadAcquire();
+        if (Q_UNLIKELY(!queue)) {
+            QPostEventQueue *newQueue = new QPostEventQueue;
+            if (inbox.testAndSetOrdered(nullptr, newQueue, queue))
+                return newQueue;
+            delete newQueue;
+        }
+        return queue;
+    }
+
+    // Must be called with the mutex held. Keeps new posts out of the inbox
+    // until openInbox() is called; the ones already claimed are still
+    // collected by the next drain.
+    //
+    // This is a store-load handshake with isInboxOpen(): a poster claims a
+    // cell, then checks the flag, while closeInbox() sets the flag and the
+    // drain then reads the claimed cells. Acquire/release ordering lets both
+    // sides read the old value, so each side has a sequentially consistent
+    // fence between its store and its load. Then either the poster sees the
+    // inbox closed, or the drain sees the claim and waits for the event.
+    void closeInbox()
+    {
+        inboxClosed.store(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // Called by posters after claiming a cell, see closeInbox()
+    bool isInboxOpen() const
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !inboxClosed.load();
+    }
+
+    void openInbox()
+    { inboxClosed.storeRelease(0); }
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -267,7 +401,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasPendingInboxEvents();
     }
 
     // This class provides per-thread (by way of being a QThreadData
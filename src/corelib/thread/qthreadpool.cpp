@@ -40,9 +40,14 @@
 #include "qthreadpool.h"
 #include "qthreadpool_p.h"
 #include "qdeadlinetimer.h"
+#include "qthreadstorage.h"
 
 #include <algorithm>
 
+#if defined(Q_OS_LINUX) && !defined(QT_LINUXBASE)
+#include <sched.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 Q_GLOBAL_STATIC(QThreadPool, theInstance)
@@ -53,15 +58,39 @@ Q_GLOBAL_STATIC(QThreadPool, theInstance)
 class QThreadPoolThread : public QThread
 {
 public:
+    enum {
+        LocalBatchSize = 8
+    };
+
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() override;
     void registerThreadInactive();
 
+    void pushLocalRunnable(QRunnable *runnable);
+    QRunnable *popLocalRunnable();
+    void setCpuAffinity();
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+    int index;
+
+    // runnables started from within this thread: the thread itself takes
+    // them from the back, other threads steal them from the front
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
 };
 
+namespace {
+struct CurrentPoolThread
+{
+    QThreadPoolThread *thread;
+};
+}
+
+// not a pointer, QThreadStorage would delete the thread otherwise
+Q_GLOBAL_STATIC(QThreadStorage<CurrentPoolThread>, currentPoolThread)
+
 /*
     QThreadPool private class.
 */
@@ -71,7 +100,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(nullptr)
+    :manager(manager), runnable(nullptr), index(0)
 {
     setStackSize(manager->stackSize);
 }
@@ -81,6 +110,11 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    if (QThreadStorage<CurrentPoolThread> *current = currentPoolThread())
+        current->setLocalData(CurrentPoolThread{ this });
+    if (!manager->affinityCpus.isEmpty())
+        setCpuAffinity();
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -88,47 +122,46 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool autoDelete = r->autoDelete();
+                // run the task, followed by the ones it started
+                do {
+                    const bool autoDelete = r->autoDelete();
+                    locker.unlock();
 
-
-                // run the task
-                locker.unlock();
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        locker.relock();
+                        manager->moveLocalRunnablesToQueue(this);
+                        registerThreadInactive();
+                        locker.unlock();
+                        throw;
+                    }
 #endif
-                locker.relock();
 
-                if (autoDelete && !--r->ref)
-                    delete r;
+                    locker.relock();
+                    if (autoDelete && QThreadPoolPrivate::derefRunnable(r))
+                        delete r;
+
+                    // queued runnables with a higher priority go first
+                    r = manager->queuedHighPriorityCount.load() ? nullptr : popLocalRunnable();
+                } while (r);
             }
 
             // if too many threads are active, expire this thread
             if (manager->tooManyThreadsActive())
                 break;
 
-            if (manager->queue.isEmpty()) {
-                r = nullptr;
-                break;
-            }
+            r = manager->takeQueuedRunnable(this);
+        } while (r);
 
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
-        } while (true);
+        // leave what is left of the local queue to the other threads
+        manager->moveLocalRunnablesToQueue(this);
 
         // if too many threads are active, expire this thread
         bool expired = manager->tooManyThreadsActive();
@@ -159,12 +192,81 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+void QThreadPoolThread::pushLocalRunnable(QRunnable *runnable)
+{
+    {
+        QMutexLocker locker(&manager->mutex);
+        if (runnable->autoDelete())
+            QThreadPoolPrivate::refRunnable(runnable);
+    }
+    {
+        QMutexLocker locker(&localMutex);
+        localQueue.append(runnable);
+    }
+    manager->localRunnableCount.ref();
+}
+
+QRunnable *QThreadPoolThread::popLocalRunnable()
+{
+    if (manager->localRunnableCount.load() == 0)
+        return nullptr;
+
+    QMutexLocker locker(&localMutex);
+    if (localQueue.isEmpty())
+        return nullptr;
+    manager->localRunnableCount.deref();
+    return localQueue.takeLast();
+}
+
+void QThreadPoolThread::setCpuAffinity()
+{
+#if defined(Q_OS_LINUX) && !defined(QT_LINUXBASE)
+    const QVector<int> &cpus = manager->affinityCpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus.at(index % cpus.size()), &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        qErrnoWarning("QThreadPool: cannot set the CPU affinity of a thread");
+#endif
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
-{ }
+{
+    // nothing started yet, so there is room for more threads
+    maybeSpareThreads.store(1);
+
+#if defined(Q_OS_LINUX) && !defined(QT_LINUXBASE)
+    // pin each thread to one of the CPUs this pool may use, round-robin
+    if (qEnvironmentVariableIntValue("QT_THREADPOOL_CPU_AFFINITY") > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set))
+                    affinityCpus.append(cpu);
+            }
+        }
+    }
+#endif
+}
+
+/*
+    QRunnable::ref is a plain int, so these must be called with the mutex
+    locked, also by the threads for the runnables they start and run locally.
+*/
+void QThreadPoolPrivate::refRunnable(QRunnable *runnable)
+{
+    ++runnable->ref;
+}
+
+bool QThreadPoolPrivate::derefRunnable(QRunnable *runnable)
+{
+    return !--runnable->ref;
+}
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
@@ -194,7 +296,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         if (task->autoDelete())
-            ++task->ref;
+            refRunnable(task);
         thread->runnable = task;
         thread->start();
         return true;
@@ -214,7 +316,20 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     Q_ASSERT(runnable != nullptr);
     if (runnable->autoDelete())
-        ++runnable->ref;
+        refRunnable(runnable);
+
+    queueRunnable(runnable, priority);
+}
+
+/*
+    \internal
+
+    Adds \a runnable to the queue without taking a reference to it.
+*/
+void QThreadPoolPrivate::queueRunnable(QRunnable *runnable, int priority)
+{
+    if (priority > 0)
+        queuedHighPriorityCount.ref();
 
     for (QueuePage *page : qAsConst(queue)) {
         if (page->priority() == priority && !page->isFull()) {
@@ -226,6 +341,155 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
+QRunnable *QThreadPoolPrivate::popQueue()
+{
+    QueuePage *page = queue.first();
+    if (page->priority() > 0)
+        queuedHighPriorityCount.deref();
+    QRunnable *runnable = page->pop();
+
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+    }
+    return runnable;
+}
+
+/*
+    \internal
+
+    Returns the next runnable for \a thread to run, or \c nullptr if there is
+    none. Runnables queued with a priority above 0 go first, then the ones
+    started from within \a thread, those queued with priority 0, those
+    started from within the other threads, and finally those queued with a
+    negative priority.
+*/
+QRunnable *QThreadPoolPrivate::takeQueuedRunnable(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty() && queue.first()->priority() > 0)
+        return popQueue();
+
+    if (QRunnable *r = thread->popLocalRunnable())
+        return r;
+
+    if (!queue.isEmpty() && queue.first()->priority() == 0) {
+        QRunnable *r = popQueue();
+
+        // move a few more to the local queue, so that the thread does not
+        // need the mutex for them; the oldest goes last, as the thread takes
+        // from the back
+        QRunnable *batch[QThreadPoolThread::LocalBatchSize];
+        int count = 0;
+        while (count < QThreadPoolThread::LocalBatchSize
+               && !queue.isEmpty() && queue.first()->priority() == 0) {
+            batch[count++] = popQueue();
+        }
+        if (count) {
+            {
+                QMutexLocker locker(&thread->localMutex);
+                for (int i = count - 1; i >= 0; --i)
+                    thread->localQueue.append(batch[i]);
+            }
+            localRunnableCount.fetchAndAddOrdered(count);
+        }
+        return r;
+    }
+
+    if (QRunnable *r = stealLocalRunnable(thread))
+        return r;
+
+    if (!queue.isEmpty())
+        return popQueue();
+
+    // the thread is about to become idle; announce that before looking at
+    // the local queues once more, so that a runnable started concurrently
+    // is either found here or shared by QThreadPool::start()
+    setMaybeSpareThreads();
+    if (localRunnableCount.fetchAndAddOrdered(0) > 0)
+        return stealLocalRunnable(thread);
+    return nullptr;
+}
+
+/*
+    \internal
+
+    Takes the oldest runnables from the local queue of another thread than
+    \a thief. One is returned, the others, up to half of that queue, are
+    moved to the local queue of \a thief. If \a thief is \c nullptr, only
+    one runnable is taken.
+*/
+QRunnable *QThreadPoolPrivate::stealLocalRunnable(QThreadPoolThread *thief)
+{
+    if (localRunnableCount.load() == 0)
+        return nullptr;
+
+    for (QThreadPoolThread *victim : qAsConst(allThreads)) {
+        if (victim == thief)
+            continue;
+
+        QRunnable *stolen[QThreadPoolThread::LocalBatchSize];
+        int count;
+        {
+            QMutexLocker locker(&victim->localMutex);
+            const int available = victim->localQueue.size();
+            count = thief ? qMin((available + 1) / 2, int(QThreadPoolThread::LocalBatchSize))
+                          : qMin(available, 1);
+            for (int i = 0; i < count; ++i)
+                stolen[i] = victim->localQueue.takeFirst();
+        }
+        if (count == 0)
+            continue;
+
+        if (count > 1) {
+            QMutexLocker locker(&thief->localMutex);
+            for (int i = count - 1; i > 0; --i)
+                thief->localQueue.append(stolen[i]);
+        }
+        localRunnableCount.deref();
+        return stolen[0];
+    }
+    return nullptr;
+}
+
+void QThreadPoolPrivate::moveLocalRunnablesToQueue(QThreadPoolThread *thread)
+{
+    QList<QRunnable *> runnables;
+    {
+        QMutexLocker locker(&thread->localMutex);
+        runnables.swap(thread->localQueue);
+    }
+    if (runnables.isEmpty())
+        return;
+
+    localRunnableCount.fetchAndAddOrdered(-runnables.size());
+    for (QRunnable *r : qAsConst(runnables))
+        queueRunnable(r, 0);
+}
+
+/*
+    \internal
+
+    Starts the runnables in the local queues on threads that are available.
+*/
+void QThreadPoolPrivate::shareLocalRunnables()
+{
+    while (activeThreadCount() < maxThreadCount) {
+        QRunnable *r = stealLocalRunnable(nullptr);
+        if (!r)
+            return;
+        // tryStart() takes its own reference
+        if (r->autoDelete())
+            derefRunnable(r);
+        tryStart(r);
+    }
+    maybeSpareThreads.fetchAndStoreOrdered(0);
+}
+
+void QThreadPoolPrivate::setMaybeSpareThreads()
+{
+    maybeSpareThreads.fetchAndStoreOrdered(1);
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     return (allThreads.count()
@@ -242,12 +506,13 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
         if (!tryStart(page->first()))
             break;
 
-        page->pop();
+        popQueue();
+    }
 
-        if (page->isFinished()) {
-            queue.removeFirst();
-            delete page;
-        }
+    // then the tasks started from within the threads
+    if (activeThreadCount() < maxThreadCount) {
+        setMaybeSpareThreads();
+        shareLocalRunnables();
     }
 }
 
@@ -265,12 +530,13 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     Q_ASSERT(runnable != nullptr);
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
+    thread->index = nextThreadIndex++;
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.insert(thread.data());
     ++activeThreads;
 
     if (runnable->autoDelete())
-        ++runnable->ref;
+        refRunnable(runnable);
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -287,6 +553,7 @@ void QThreadPoolPrivate::reset()
     allThreadsCopy.swap(allThreads);
     expiredThreads.clear();
     waitingThreads.clear();
+    setMaybeSpareThreads();
     mutex.unlock();
 
     for (QThreadPoolThread *thread: qAsConst(allThreadsCopy)) {
@@ -334,12 +601,26 @@ void QThreadPoolPrivate::clear()
     for (QueuePage *page : qAsConst(queue)) {
         while (!page->isFinished()) {
             QRunnable *r = page->pop();
-            if (r && r->autoDelete() && !--r->ref)
+            if (r && r->autoDelete() && derefRunnable(r))
                 delete r;
         }
     }
     qDeleteAll(queue);
     queue.clear();
+    queuedHighPriorityCount.store(0);
+
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        QList<QRunnable *> runnables;
+        {
+            QMutexLocker localLocker(&thread->localMutex);
+            runnables.swap(thread->localQueue);
+        }
+        localRunnableCount.fetchAndAddOrdered(-runnables.size());
+        for (QRunnable *r : qAsConst(runnables)) {
+            if (r->autoDelete() && derefRunnable(r))
+                delete r;
+        }
+    }
 }
 
 /*!
@@ -370,12 +651,24 @@ bool QThreadPool::tryTake(QRunnable *runnable)
 
         for (QueuePage *page : qAsConst(d->queue)) {
             if (page->tryTake(runnable)) {
+                if (page->priority() > 0)
+                    d->queuedHighPriorityCount.deref();
                 if (page->isFinished()) {
                     d->queue.removeOne(page);
                     delete page;
                 }
                 if (runnable->autoDelete())
-                    --runnable->ref; // undo ++ref in start()
+                    QThreadPoolPrivate::derefRunnable(runnable); // undo ++ref in start()
+                return true;
+            }
+        }
+
+        for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            if (thread->localQueue.removeOne(runnable)) {
+                d->localRunnableCount.deref();
+                if (runnable->autoDelete())
+                    QThreadPoolPrivate::derefRunnable(runnable); // undo ++ref in start()
                 return true;
             }
         }
@@ -395,7 +688,11 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     Q_Q(QThreadPool);
     if (!q->tryTake(runnable))
         return;
-    const bool del = runnable->autoDelete() && !runnable->ref; // tryTake already deref'ed
+    bool del;
+    {
+        QMutexLocker locker(&mutex);
+        del = runnable->autoDelete() && !runnable->ref; // tryTake already deref'ed
+    }
 
     runnable->run();
 
@@ -451,6 +748,16 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     implementing time-consuming operations that are not visible to the
     QThreadPool.
 
+    Runnables that a thread of the pool starts with the default priority are
+    first kept with that thread, which runs them after the current one
+    returns, most recent first. Threads that become available take the
+    oldest of them over. Runnables started with a higher priority are run
+    before these.
+
+    On Linux, setting the \c QT_THREADPOOL_CPU_AFFINITY environment variable
+    to 1 binds each thread of pools created afterwards to one of the CPUs
+    available when the pool is created.
+
     Note that QThreadPool is a low-level class for managing threads, see
     the Qt Concurrent module for higher level alternatives.
 
@@ -485,7 +792,9 @@ QThreadPool *QThreadPool::globalInstance()
     Reserves a thread and uses it to run \a runnable, unless this thread will
     make the current thread count exceed maxThreadCount().  In that case,
     \a runnable is added to a run queue instead. The \a priority argument can
-    be used to control the run queue's order of execution.
+    be used to control the run queue's order of execution. When called from
+    within a thread of this pool with the default \a priority, \a runnable
+    is kept with that thread instead, unless another thread is available.
 
     Note that the thread pool takes ownership of the \a runnable if
     \l{QRunnable::autoDelete()}{runnable->autoDelete()} returns \c true,
@@ -502,6 +811,21 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+
+    // runnables started from within a thread of this pool stay with that
+    // thread, unless other threads are available to run them
+    if (priority == 0) {
+        QThreadStorage<CurrentPoolThread> *current = currentPoolThread();
+        if (current && current->hasLocalData() && current->localData().thread->manager == d) {
+            current->localData().thread->pushLocalRunnable(runnable);
+            if (d->maybeSpareThreads.fetchAndAddOrdered(0)) {
+                QMutexLocker locker(&d->mutex);
+                d->shareLocalRunnables();
+            }
+            return;
+        }
+    }
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -721,7 +1045,15 @@ void QThreadPool::clear()
 */
 void QThreadPool::cancel(QRunnable *runnable)
 {
-    if (tryTake(runnable) && runnable->autoDelete() && !runnable->ref) // tryTake already deref'ed
+    Q_D(QThreadPool);
+    if (!tryTake(runnable))
+        return;
+    bool del;
+    {
+        QMutexLocker locker(&d->mutex);
+        del = runnable->autoDelete() && !runnable->ref; // tryTake already deref'ed
+    }
+    if (del)
         delete runnable;
 }
 #endif
@@ -57,6 +57,8 @@
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qset.h"
 #include "QtCore/qqueue.h"
+#include "QtCore/qvector.h"
+#include "QtCore/qatomic.h"
 #include "private/qobject_p.h"
 
 QT_REQUIRE_CONFIG(thread);
@@ -170,6 +172,17 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    QRunnable *popQueue();
+    void queueRunnable(QRunnable *runnable, int priority);
+    QRunnable *takeQueuedRunnable(QThreadPoolThread *thread);
+    QRunnable *stealLocalRunnable(QThreadPoolThread *thief);
+    void moveLocalRunnablesToQueue(QThreadPoolThread *thread);
+    void shareLocalRunnables();
+    void setMaybeSpareThreads();
+
+    static void refRunnable(QRunnable *runnable);
+    static bool derefRunnable(QRunnable *runnable);
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -182,6 +195,16 @@ public:
     int reservedThreads = 0;
     int activeThreads = 0;
     uint stackSize = 0;
+
+    // runnables queued with a priority above 0, which go before local runnables
+    QAtomicInt queuedHighPriorityCount;
+    // runnables in the local queues of all threads
+    QAtomicInt localRunnableCount;
+    // set whenever a thread may have become available, reset by shareLocalRunnables()
+    QAtomicInt maybeSpareThreads;
+
+    QVector<int> affinityCpus;
+    int nextThreadIndex = 0;
 };
 
 QT_END_NAMESPACE
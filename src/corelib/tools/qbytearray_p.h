@@ -60,6 +60,11 @@ QT_BEGIN_NAMESPACE
 constexpr qsizetype MaxByteArraySize = MaxAllocSize - sizeof(std::remove_pointer<QByteArray::DataPtr>::type) - 1;
 constexpr qsizetype MaxStringSize = (MaxAllocSize - sizeof(std::remove_pointer<QByteArray::DataPtr>::type)) / 2 - 1;
 
+// CRC-32 (ISO 3309, as in zlib) and CRC-32C (Castagnoli) of data, continuing
+// from the checksum crc of the preceding data
+Q_CORE_EXPORT quint32 qCrc32(const char *data, size_t len, quint32 crc = 0);
+Q_CORE_EXPORT quint32 qCrc32C(const char *data, size_t len, quint32 crc = 0);
+
 QT_END_NAMESPACE
 
 #endif // QBYTEARRAY_P_H
@@ -43,6 +43,10 @@
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
+#ifndef QT_BOOTSTRAPPED
+#include <private/qsimd_p.h>
+#endif
+
 #if defined(QT_BOOTSTRAPPED) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
 #  error "Are you sure you need the other hashing algorithms besides SHA-1?"
 #endif
@@ -164,6 +168,397 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
 
 QT_BEGIN_NAMESPACE
 
+/*
+    SHA-1 and SHA-256 block functions using the SHA instructions of recent x86
+    processors (Intel Goldmont and Ice Lake, AMD Zen) and the ARMv8
+    Cryptography Extension. They process \a blocks 64-byte blocks starting at
+    \a data and update \a state, the five or eight hash words in the order of
+    the standard (h0 first), in place.
+*/
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_PROCESSOR_X86)
+#  if QT_COMPILER_SUPPORTS_HERE(SHA)
+#    define QT_CRYPTOGRAPHICHASH_SHA_X86
+#  endif
+#elif !defined(QT_BOOTSTRAPPED) && defined(Q_PROCESSOR_ARM_V8) && defined(__ARM_FEATURE_CRYPTO)
+#  define QT_CRYPTOGRAPHICHASH_SHA_ARM
+#endif
+
+#if defined(QT_CRYPTOGRAPHICHASH_SHA_X86)
+#  define QT_CRYPTOGRAPHICHASH_SHA_BLOCKS
+static inline bool hasFastSha1()
+{
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+}
+
+static inline bool hasFastSha256()
+{
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+}
+
+// the next four message words, computed from the previous sixteen
+QT_FUNCTION_TARGET(SHA)
+static inline __m128i sha1NextWords(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    return _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w0, w1), w2), w3);
+}
+
+// four rounds; e holds the a, b, c, d words from before the previous four rounds
+template <int Function>
+QT_FUNCTION_TARGET(SHA)
+static inline void sha1Rounds4(__m128i &abcd, __m128i &e, __m128i w)
+{
+    const __m128i previous = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, _mm_sha1nexte_epu32(e, w), Function);
+    e = previous;
+}
+
+QT_FUNCTION_TARGET(SHA)
+static void sha1BlocksHw(quint32 *state, const uchar *data, size_t blocks)
+{
+    // the instructions want the words in big-endian order with w[0] in the highest lane
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0001020304050607), Q_INT64_C(0x08090a0b0c0d0e0f));
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1b);
+    __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i savedAbcd = abcd;
+        const __m128i savedE0 = e0;
+        __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), byteSwap);
+        __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), byteSwap);
+        __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), byteSwap);
+        __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), byteSwap);
+
+        __m128i e = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e0, w0), 0);
+        sha1Rounds4<0>(abcd, e, w1);
+        sha1Rounds4<0>(abcd, e, w2);
+        sha1Rounds4<0>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);
+        sha1Rounds4<0>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);
+        sha1Rounds4<1>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);
+        sha1Rounds4<1>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);
+        sha1Rounds4<1>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);
+        sha1Rounds4<1>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);
+        sha1Rounds4<1>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);
+        sha1Rounds4<2>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);
+        sha1Rounds4<2>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);
+        sha1Rounds4<2>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);
+        sha1Rounds4<2>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);
+        sha1Rounds4<2>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);
+        sha1Rounds4<3>(abcd, e, w3);
+        w0 = sha1NextWords(w0, w1, w2, w3);
+        sha1Rounds4<3>(abcd, e, w0);
+        w1 = sha1NextWords(w1, w2, w3, w0);
+        sha1Rounds4<3>(abcd, e, w1);
+        w2 = sha1NextWords(w2, w3, w0, w1);
+        sha1Rounds4<3>(abcd, e, w2);
+        w3 = sha1NextWords(w3, w0, w1, w2);
+        sha1Rounds4<3>(abcd, e, w3);
+
+        e0 = _mm_sha1nexte_epu32(e, savedE0);
+        abcd = _mm_add_epi32(abcd, savedAbcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = quint32(_mm_extract_epi32(e0, 3));
+}
+
+#  ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// the next four message words, computed from the previous sixteen
+QT_FUNCTION_TARGET(SHA)
+static inline __m128i sha256NextWords(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    const __m128i w = _mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4));
+    return _mm_sha256msg2_epu32(w, w3);
+}
+
+QT_FUNCTION_TARGET(SHA)
+static inline void sha256Rounds4(__m128i &abef, __m128i &cdgh, __m128i w, const quint32 *k)
+{
+    const __m128i wk = _mm_add_epi32(w, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+}
+
+QT_FUNCTION_TARGET(SHA)
+static void sha256BlocksHw(quint32 *state, const uchar *data, size_t blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0c0d0e0f08090a0b), Q_INT64_C(0x0405060700010203));
+
+    // the instructions want the state as ABEF and CDGH, from the highest lane down
+    const __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xb1);
+    const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i savedAbef = abef;
+        const __m128i savedCdgh = cdgh;
+        __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), byteSwap);
+        __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), byteSwap);
+        __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), byteSwap);
+        __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), byteSwap);
+
+        sha256Rounds4(abef, cdgh, w0, sha256RoundConstants);
+        sha256Rounds4(abef, cdgh, w1, sha256RoundConstants + 4);
+        sha256Rounds4(abef, cdgh, w2, sha256RoundConstants + 8);
+        sha256Rounds4(abef, cdgh, w3, sha256RoundConstants + 12);
+        for (int i = 16; i < 64; i += 16) {
+            w0 = sha256NextWords(w0, w1, w2, w3);
+            sha256Rounds4(abef, cdgh, w0, sha256RoundConstants + i);
+            w1 = sha256NextWords(w1, w2, w3, w0);
+            sha256Rounds4(abef, cdgh, w1, sha256RoundConstants + i + 4);
+            w2 = sha256NextWords(w2, w3, w0, w1);
+            sha256Rounds4(abef, cdgh, w2, sha256RoundConstants + i + 8);
+            w3 = sha256NextWords(w3, w0, w1, w2);
+            sha256Rounds4(abef, cdgh, w3, sha256RoundConstants + i + 12);
+        }
+
+        abef = _mm_add_epi32(abef, savedAbef);
+        cdgh = _mm_add_epi32(cdgh, savedCdgh);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+#  endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#elif defined(QT_CRYPTOGRAPHICHASH_SHA_ARM)
+#  define QT_CRYPTOGRAPHICHASH_SHA_BLOCKS
+static inline bool hasFastSha1()
+{
+    return qCpuHasFeature(SHA1);
+}
+
+static inline bool hasFastSha256()
+{
+    return qCpuHasFeature(SHA2);
+}
+
+#if defined(Q_PROCESSOR_ARM_64)
+QT_FUNCTION_TARGET(CRYPTO)
+#endif
+static void sha1BlocksHw(quint32 *state, const uchar *data, size_t blocks)
+{
+    static const quint32 k[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e = state[4];
+
+    for ( ; blocks; --blocks, data += 64) {
+        const uint32x4_t savedAbcd = abcd;
+        const uint32_t savedE = e;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; ++i)
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+
+        for (int i = 0; i < 20; ++i) {
+            if (i >= 4)
+                w[i & 3] = vsha1su1q_u32(vsha1su0q_u32(w[i & 3], w[(i + 1) & 3], w[(i + 2) & 3]), w[(i + 3) & 3]);
+            const uint32x4_t wk = vaddq_u32(w[i & 3], vdupq_n_u32(k[i / 5]));
+            const uint32_t nextE = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            if (i < 5)
+                abcd = vsha1cq_u32(abcd, e, wk);
+            else if (i < 10 || i >= 15)
+                abcd = vsha1pq_u32(abcd, e, wk);
+            else
+                abcd = vsha1mq_u32(abcd, e, wk);
+            e = nextE;
+        }
+
+        abcd = vaddq_u32(abcd, savedAbcd);
+        e += savedE;
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e;
+}
+
+#  ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#if defined(Q_PROCESSOR_ARM_64)
+QT_FUNCTION_TARGET(CRYPTO)
+#endif
+static void sha256BlocksHw(quint32 *state, const uchar *data, size_t blocks)
+{
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const uint32x4_t savedAbcd = abcd;
+        const uint32x4_t savedEfgh = efgh;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; ++i)
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+
+        for (int i = 0; i < 16; ++i) {
+            if (i >= 4)
+                w[i & 3] = vsha256su1q_u32(vsha256su0q_u32(w[i & 3], w[(i + 1) & 3]), w[(i + 2) & 3], w[(i + 3) & 3]);
+            const uint32x4_t wk = vaddq_u32(w[i & 3], vld1q_u32(sha256RoundConstants + 4 * i));
+            const uint32x4_t previous = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, previous, wk);
+        }
+
+        abcd = vaddq_u32(abcd, savedAbcd);
+        efgh = vaddq_u32(efgh, savedEfgh);
+    }
+
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+#  endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#else
+static inline bool hasFastSha1()
+{
+    return false;
+}
+
+#  ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static inline bool hasFastSha256()
+{
+    return false;
+}
+#  endif
+#endif
+
+static void sha1Blocks(Sha1State *state, const uchar *data, size_t blocks)
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_BLOCKS
+    if (hasFastSha1()) {
+        quint32 h[5] = { state->h0, state->h1, state->h2, state->h3, state->h4 };
+        sha1BlocksHw(h, data, blocks);
+        state->h0 = h[0];
+        state->h1 = h[1];
+        state->h2 = h[2];
+        state->h3 = h[3];
+        state->h4 = h[4];
+        return;
+    }
+#endif
+    for ( ; blocks; --blocks, data += 64)
+        sha1ProcessChunk(state, data);
+}
+
+// like sha1Update(), but hands all complete blocks to sha1Blocks() at once
+static void sha1Input(Sha1State *state, const uchar *data, quint64 length)
+{
+    quint32 rest = quint32(state->messageSize & 63);
+    state->messageSize += length;
+
+    if (rest) {
+        const quint64 fill = qMin<quint64>(64 - rest, length);
+        memcpy(state->buffer + rest, data, fill);
+        data += fill;
+        length -= fill;
+        if (rest + fill < 64)
+            return;
+        sha1Blocks(state, state->buffer, 1);
+    }
+
+    sha1Blocks(state, data, length / 64);
+    memcpy(state->buffer, data + (length & ~Q_UINT64_C(63)), length & 63);
+}
+
+static void sha1Finish(Sha1State *state, uchar *hash)
+{
+    const quint64 messageSize = state->messageSize;
+    const int rest = int(messageSize & 63);
+    const int paddingLength = (rest < 56 ? 56 : 120) - rest;
+    uchar padding[64 + 8] = { 0x80 };
+    qToBigEndian(messageSize << 3, padding + paddingLength);
+    sha1Input(state, padding, paddingLength + 8);
+    sha1ToHash(state, hash);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static void sha256Blocks(SHA256Context *context, const uchar *data, size_t blocks)
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_BLOCKS
+    if (hasFastSha256()) {
+        sha256BlocksHw(context->Intermediate_Hash, data, blocks);
+        return;
+    }
+#endif
+    for ( ; blocks; --blocks, data += 64) {
+        if (data != context->Message_Block)
+            memcpy(context->Message_Block, data, 64);
+        SHA224_256ProcessMessageBlock(context);
+    }
+}
+
+/*
+    Replaces SHA224Input() and SHA256Input(), which go through the data one
+    byte at a time, and the padding in SHA224Result() and SHA256Result(), so
+    that all blocks go through sha256Blocks().
+*/
+static void sha256Input(SHA256Context *context, const uchar *data, quint64 length)
+{
+    const quint64 bits = ((quint64(context->Length_High) << 32) | context->Length_Low) + (length << 3);
+    context->Length_High = quint32(bits >> 32);
+    context->Length_Low = quint32(bits);
+
+    if (int index = context->Message_Block_Index) {
+        const quint64 fill = qMin<quint64>(64 - index, length);
+        memcpy(context->Message_Block + index, data, fill);
+        data += fill;
+        length -= fill;
+        context->Message_Block_Index = qint16(index + fill);
+        if (index + fill < 64)
+            return;
+        sha256Blocks(context, context->Message_Block, 1);
+    }
+
+    sha256Blocks(context, data, length / 64);
+    memcpy(context->Message_Block, data + (length & ~Q_UINT64_C(63)), length & 63);
+    context->Message_Block_Index = qint16(length & 63);
+}
+
+static void sha256Finish(SHA256Context *context, uchar *hash, int hashSize)
+{
+    const quint64 bits = (quint64(context->Length_High) << 32) | context->Length_Low;
+    const int index = context->Message_Block_Index;
+    const int paddingLength = (index < 56 ? 56 : 120) - index;
+    uchar padding[64 + 8] = { 0x80 };
+    qToBigEndian(bits, padding + paddingLength);
+    sha256Input(context, padding, paddingLength + 8);
+    for (int i = 0; i < hashSize / 4; ++i)
+        qToBigEndian(context->Intermediate_Hash[i], hash + 4 * i);
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
 class QCryptographicHashPrivate
 {
 public:
@@ -359,7 +754,7 @@ void QCryptographicHash::addData(const char *data, int length)
 {
     switch (d->method) {
     case Sha1:
-        sha1Update(&d->sha1Context, (const unsigned char *)data, length);
+        sha1Input(&d->sha1Context, reinterpret_cast<const uchar *>(data), length);
         break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
     default:
@@ -374,10 +769,10 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256Input(&d->sha224Context, reinterpret_cast<const uchar *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256Input(&d->sha256Context, reinterpret_cast<const uchar *>(data), length);
         break;
     case Sha384:
         SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -451,8 +846,7 @@ QByteArray QCryptographicHash::result() const
     case Sha1: {
         Sha1State copy = d->sha1Context;
         d->result.resize(20);
-        sha1FinalizeState(&copy);
-        sha1ToHash(&copy, (unsigned char *)d->result.data());
+        sha1Finish(&copy, reinterpret_cast<uchar *>(d->result.data()));
         break;
     }
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
@@ -476,13 +870,13 @@ QByteArray QCryptographicHash::result() const
     case Sha224: {
         SHA224Context copy = d->sha224Context;
         d->result.resize(SHA224HashSize);
-        SHA224Result(&copy, reinterpret_cast<unsigned char *>(d->result.data()));
+        sha256Finish(&copy, reinterpret_cast<uchar *>(d->result.data()), SHA224HashSize);
         break;
     }
     case Sha256:{
         SHA256Context copy = d->sha256Context;
         d->result.resize(SHA256HashSize);
-        SHA256Result(&copy, reinterpret_cast<unsigned char *>(d->result.data()));
+        sha256Finish(&copy, reinterpret_cast<uchar *>(d->result.data()), SHA256HashSize);
         break;
     }
     case Sha384:{
@@ -0,0 +1,689 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_P_H
+#define QFLATHASH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+enum : uchar {
+    Empty = 0,
+    Deleted = 1,
+    Full = 0x80 // ORed with the low 7 bits of the mixed hash
+};
+
+// Fibonacci hashing: spreads the bits of qHash() values that only differ in
+// their low bits (integers, pointers) over the whole table.
+Q_DECL_CONSTEXPR inline uint mix(uint h) Q_DECL_NOTHROW { return h * 0x9e3779b9U; }
+Q_DECL_CONSTEXPR inline uchar tag(uint mixed) Q_DECL_NOTHROW { return uchar(Full | (mixed & 0x7f)); }
+
+// The control bytes are probed in groups of eight, with the usual bit tricks
+// on a 64-bit word. The first GroupWidth control bytes are mirrored after the
+// last one, so that a group starting anywhere in the table can be loaded.
+enum { GroupWidth = 8 };
+typedef quint64 Group;
+
+Q_DECL_CONSTEXPR inline Group lsbs() Q_DECL_NOTHROW { return Q_UINT64_C(0x0101010101010101); }
+Q_DECL_CONSTEXPR inline Group msbs() Q_DECL_NOTHROW { return Q_UINT64_C(0x8080808080808080); }
+
+inline Group loadGroup(const uchar *ctrl) Q_DECL_NOTHROW { return qFromLittleEndian<quint64>(ctrl); }
+
+// the high bit of each byte of the result is set if that byte of g is zero
+Q_DECL_CONSTEXPR inline Group zeroBytes(Group g) Q_DECL_NOTHROW
+{ return ~(((g & ~msbs()) + ~msbs()) | g) & msbs(); }
+Q_DECL_CONSTEXPR inline Group matchByte(Group g, uchar c) Q_DECL_NOTHROW { return zeroBytes(g ^ (lsbs() * c)); }
+Q_DECL_CONSTEXPR inline Group matchEmpty(Group g) Q_DECL_NOTHROW { return zeroBytes(g); }
+Q_DECL_CONSTEXPR inline Group matchEmptyOrDeleted(Group g) Q_DECL_NOTHROW { return ~g & msbs(); }
+inline int firstMatch(Group m) Q_DECL_NOTHROW { return int(qCountTrailingZeroBits(m) >> 3); }
+inline int lastMatch(Group m) Q_DECL_NOTHROW { return int(7 - (qCountLeadingZeroBits(m) >> 3)); }
+
+template <typename K>
+using IfQString = typename std::enable_if<std::is_same<K, QString>::value, bool>::type;
+
+} // namespace QFlatHashPrivate
+
+// An implicitly shared hash with a subset of the QHash API, using the same
+// qHash() functions and seed. The items live in one array with linear
+// probing, so inserting only allocates when the table grows. Unlike QHash,
+// a key maps to at most one value, and inserting may move items, which
+// invalidates all iterators and references. QString keys can also be
+// looked up by QStringView and QLatin1String.
+template <class Key, class T>
+class QFlatHash
+{
+    struct Node
+    {
+        Key key;
+        T value;
+    };
+
+    struct Data
+    {
+        QtPrivate::RefCount ref;
+        int size;
+        int used;      // full and deleted slots
+        int capacity;  // power of two
+        int shift;     // 32 - log2(capacity)
+        uint seed;
+        Node *nodes;
+        uchar *ctrl;   // one control byte per slot and the mirrored group, after the nodes
+
+        inline void setCtrl(int i, uchar c) Q_DECL_NOTHROW
+        {
+            ctrl[i] = c;
+            if (i < QFlatHashPrivate::GroupWidth)
+                ctrl[capacity + i] = c;
+        }
+    };
+
+    Data *d;
+
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef T value_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline QFlatHash() Q_DECL_NOTHROW : d(nullptr) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key, T> > list)
+        : d(nullptr)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key, T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    QFlatHash(const QFlatHash &other) : d(other.d) { if (d && !d->ref.ref()) { d = nullptr; copyFrom(other.d); } }
+    ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    {
+        QFlatHash copy(other);
+        swap(copy);
+        return *this;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = nullptr; }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const Q_DECL_NOTHROW { return d ? d->size : 0; }
+    inline int count() const Q_DECL_NOTHROW { return size(); }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return size() == 0; }
+    inline int capacity() const Q_DECL_NOTHROW { return d ? maxLoad(d->capacity) : 0; }
+    void reserve(int size);
+    inline void squeeze() { reserve(0); }
+
+    inline void detach() { if (d && d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const Q_DECL_NOTHROW { return !d || !d->ref.isShared(); }
+    inline bool isSharedWith(const QFlatHash &other) const Q_DECL_NOTHROW { return d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key, hashOf(key)) >= 0; }
+    int count(const Key &key) const { return contains(key) ? 1 : 0; }
+    const T value(const Key &key, const T &defaultValue = T()) const
+    {
+        const int i = findIndex(key, hashOf(key));
+        return i < 0 ? defaultValue : d->nodes[i].value;
+    }
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash;
+        friend class const_iterator;
+        Data *d;
+        int i;
+        iterator(Data *data, int index) Q_DECL_NOTHROW : d(data), i(index) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        Q_DECL_CONSTEXPR iterator() Q_DECL_NOTHROW : d(nullptr), i(0) { }
+
+        inline const Key &key() const { return d->nodes[i].key; }
+        inline T &value() const { return d->nodes[i].value; }
+        inline T &operator*() const { return d->nodes[i].value; }
+        inline T *operator->() const { return &d->nodes[i].value; }
+        inline bool operator==(const iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        inline iterator &operator++() { i = nextFull(d, i + 1); return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class QFlatHash;
+        friend class iterator;
+        const Data *d;
+        int i;
+        const_iterator(const Data *data, int index) Q_DECL_NOTHROW : d(data), i(index) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Q_DECL_CONSTEXPR const_iterator() Q_DECL_NOTHROW : d(nullptr), i(0) { }
+        const_iterator(const iterator &o) Q_DECL_NOTHROW : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return d->nodes[i].key; }
+        inline const T &value() const { return d->nodes[i].value; }
+        inline const T &operator*() const { return d->nodes[i].value; }
+        inline const T *operator->() const { return &d->nodes[i].value; }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        inline const_iterator &operator++() { i = nextFull(d, i + 1); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+    };
+    friend class const_iterator;
+
+    inline iterator begin() { detach(); return iterator(d, nextFull(d, 0)); }
+    inline const_iterator begin() const Q_DECL_NOTHROW { return constBegin(); }
+    inline const_iterator cbegin() const Q_DECL_NOTHROW { return constBegin(); }
+    inline const_iterator constBegin() const Q_DECL_NOTHROW { return const_iterator(d, nextFull(d, 0)); }
+    inline iterator end() { detach(); return iterator(d, endIndex()); }
+    inline const_iterator end() const Q_DECL_NOTHROW { return constEnd(); }
+    inline const_iterator cend() const Q_DECL_NOTHROW { return constEnd(); }
+    inline const_iterator constEnd() const Q_DECL_NOTHROW { return const_iterator(d, endIndex()); }
+
+    iterator erase(const_iterator it);
+    inline iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    iterator find(const Key &key)
+    {
+        const int i = findIndex(key, hashOf(key));
+        return i < 0 ? end() : (detach(), iterator(d, i));
+    }
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const
+    {
+        const int i = findIndex(key, hashOf(key));
+        return i < 0 ? constEnd() : const_iterator(d, i);
+    }
+
+    iterator insert(const Key &key, const T &value);
+    void insert(const QFlatHash &other);
+
+    // Lookups by string views, without converting them into a QString key
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    bool contains(QStringView key) const { return findIndex(key, qHash(key, seed())) >= 0; }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    bool contains(QLatin1String key) const { return findLatin1(key) >= 0; }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    const T value(QStringView key, const T &defaultValue = T()) const
+    {
+        const int i = findIndex(key, qHash(key, seed()));
+        return i < 0 ? defaultValue : d->nodes[i].value;
+    }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    const T value(QLatin1String key, const T &defaultValue = T()) const
+    {
+        const int i = findLatin1(key);
+        return i < 0 ? defaultValue : d->nodes[i].value;
+    }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    iterator find(QStringView key)
+    {
+        const int i = findIndex(key, qHash(key, seed()));
+        return i < 0 ? end() : (detach(), iterator(d, i));
+    }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    iterator find(QLatin1String key)
+    {
+        const int i = findLatin1(key);
+        return i < 0 ? end() : (detach(), iterator(d, i));
+    }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    const_iterator constFind(QStringView key) const
+    {
+        const int i = findIndex(key, qHash(key, seed()));
+        return i < 0 ? constEnd() : const_iterator(d, i);
+    }
+    template <typename K = Key, QFlatHashPrivate::IfQString<K> = true>
+    const_iterator constFind(QLatin1String key) const
+    {
+        const int i = findLatin1(key);
+        return i < 0 ? constEnd() : const_iterator(d, i);
+    }
+
+    // STL compatibility
+    inline bool empty() const Q_DECL_NOTHROW { return isEmpty(); }
+
+private:
+    static Q_DECL_CONSTEXPR int maxLoad(int capacity) Q_DECL_NOTHROW { return capacity - capacity / 8; }
+
+    inline uint seed() const Q_DECL_NOTHROW { return d ? d->seed : 0; }
+    inline uint hashOf(const Key &key) const { return d ? uint(qHash(key, d->seed)) : 0; }
+    inline int endIndex() const Q_DECL_NOTHROW { return d ? d->capacity : 0; }
+
+    static int nextFull(const Data *d, int i) Q_DECL_NOTHROW
+    {
+        if (!d)
+            return 0;
+        while (i < d->capacity && !(d->ctrl[i] & QFlatHashPrivate::Full))
+            ++i;
+        return i;
+    }
+
+    template <typename K>
+    int findIndex(const K &key, uint hash) const
+    {
+        if (!d || !d->size)
+            return -1;
+        using namespace QFlatHashPrivate;
+        const uint mixed = mix(hash);
+        const uchar t = tag(mixed);
+        const int mask = d->capacity - 1;
+        for (int pos = int(mixed >> d->shift); ; pos = (pos + GroupWidth) & mask) {
+            const Group group = loadGroup(d->ctrl + pos);
+            for (Group m = matchByte(group, t); m; m &= m - 1) {
+                const int i = (pos + firstMatch(m)) & mask;
+                if (d->nodes[i].key == key)
+                    return i;
+            }
+            if (matchEmpty(group))
+                return -1;
+        }
+    }
+
+    int findLatin1(QLatin1String key) const
+    {
+        if (!d || !d->size)
+            return -1;
+        // hash it the way the equal QString would be hashed
+        QVarLengthArray<QChar> utf16(key.size());
+        for (int i = 0; i < key.size(); ++i)
+            utf16[i] = QLatin1Char(key.data()[i]);
+        return findIndex(key, qHash(QStringView(utf16.constData(), utf16.size()), d->seed));
+    }
+
+    static Data *allocateData(int capacity, uint seed);
+    static void freeData(Data *x);
+    void copyFrom(const Data *other);
+    void detach_helper();
+    void rehash(int capacity);
+    int insertSlot(const Key &key, uint hash, bool *found);
+};
+
+template <class Key, class T>
+typename QFlatHash<Key, T>::Data *QFlatHash<Key, T>::allocateData(int capacity, uint seed)
+{
+    Q_ASSERT(capacity >= 8 && (capacity & (capacity - 1)) == 0);
+    Data *x = static_cast<Data *>(::malloc(sizeof(Data)));
+    Q_CHECK_PTR(x);
+    x->ref.initializeOwned();
+    x->size = 0;
+    x->used = 0;
+    x->capacity = capacity;
+    x->shift = 32;
+    for (int c = capacity; c > 1; c >>= 1)
+        --x->shift;
+    x->seed = seed;
+    const size_t ctrlSize = size_t(capacity) + QFlatHashPrivate::GroupWidth;
+    x->nodes = static_cast<Node *>(::malloc(size_t(capacity) * sizeof(Node) + ctrlSize));
+    Q_CHECK_PTR(x->nodes);
+    x->ctrl = reinterpret_cast<uchar *>(x->nodes + capacity);
+    memset(x->ctrl, QFlatHashPrivate::Empty, ctrlSize);
+    return x;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::freeData(Data *x)
+{
+    if (!QTypeInfo<Key>::isComplex && !QTypeInfo<T>::isComplex) {
+        // nothing to destroy
+    } else {
+        for (int i = 0; i < x->capacity; ++i) {
+            if (x->ctrl[i] & QFlatHashPrivate::Full)
+                x->nodes[i].~Node();
+        }
+    }
+    ::free(x->nodes);
+    ::free(x);
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::copyFrom(const Data *other)
+{
+    // keeps every node in its slot, so that iterators stay valid across detach()
+    Data *x = allocateData(other->capacity, other->seed);
+    for (int i = 0; i < other->capacity; ++i) {
+        if (other->ctrl[i] & QFlatHashPrivate::Full)
+            new (x->nodes + i) Node(other->nodes[i]);
+    }
+    memcpy(x->ctrl, other->ctrl, size_t(other->capacity) + QFlatHashPrivate::GroupWidth);
+    x->size = other->size;
+    x->used = other->used;
+    d = x;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::detach_helper()
+{
+    Data *old = d;
+    copyFrom(old);
+    if (!old->ref.deref())
+        freeData(old);
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::rehash(int capacity)
+{
+    Data *x = allocateData(capacity, d ? d->seed : uint(qGlobalQHashSeed()));
+    if (d) {
+        const bool shared = d->ref.isShared();
+        const int mask = capacity - 1;
+        for (int i = 0; i < d->capacity; ++i) {
+            if (!(d->ctrl[i] & QFlatHashPrivate::Full))
+                continue;
+            Node *n = d->nodes + i;
+            const uint mixed = QFlatHashPrivate::mix(uint(qHash(n->key, x->seed)));
+            int pos = int(mixed >> x->shift);
+            QFlatHashPrivate::Group empty;
+            while (!(empty = QFlatHashPrivate::matchEmpty(QFlatHashPrivate::loadGroup(x->ctrl + pos))))
+                pos = (pos + QFlatHashPrivate::GroupWidth) & mask;
+            const int j = (pos + QFlatHashPrivate::firstMatch(empty)) & mask;
+            if (shared) {
+                new (x->nodes + j) Node(*n);
+            } else {
+                new (x->nodes + j) Node(std::move(*n));
+                n->~Node();
+            }
+            x->setCtrl(j, QFlatHashPrivate::tag(mixed));
+        }
+        x->size = d->size;
+        x->used = d->size;
+        if (shared) {
+            if (!d->ref.deref())
+                freeData(d);
+        } else {
+            ::free(d->nodes);
+            ::free(d);
+        }
+    }
+    d = x;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::reserve(int size)
+{
+    const int needed = qMax(size, this->size());
+    int capacity = 8;
+    while (maxLoad(capacity) < needed)
+        capacity <<= 1;
+    if (!d) {
+        if (size > 0)
+            rehash(capacity);
+    } else if (capacity != d->capacity || d->used != d->size) {
+        rehash(capacity);
+    }
+}
+
+// Returns the slot of \a key, after inserting an unconstructed node for it
+// if it was not there yet (*found is false then).
+template <class Key, class T>
+int QFlatHash<Key, T>::insertSlot(const Key &key, uint hash, bool *found)
+{
+    using namespace QFlatHashPrivate;
+    detach();
+    if (!d)
+        rehash(8);
+    const uint mixed = mix(hash);
+    const uchar t = tag(mixed);
+    for (;;) {
+        const int mask = d->capacity - 1;
+        int slot = -1;
+        for (int pos = int(mixed >> d->shift); ; pos = (pos + GroupWidth) & mask) {
+            const Group group = loadGroup(d->ctrl + pos);
+            for (Group m = matchByte(group, t); m; m &= m - 1) {
+                const int i = (pos + firstMatch(m)) & mask;
+                if (d->nodes[i].key == key) {
+                    *found = true;
+                    return i;
+                }
+            }
+            if (slot < 0) {
+                if (const Group available = matchEmptyOrDeleted(group))
+                    slot = (pos + firstMatch(available)) & mask;
+            }
+            if (matchEmpty(group))
+                break;
+        }
+        if (d->ctrl[slot] == Empty) {
+            if (d->used + 1 > maxLoad(d->capacity)) {
+                // reclaim the deleted slots if they make up much of the load
+                rehash(d->size + 1 > maxLoad(d->capacity) / 2 ? d->capacity * 2 : d->capacity);
+                continue;
+            }
+            ++d->used;
+        }
+        d->setCtrl(slot, t);
+        ++d->size;
+        *found = false;
+        return slot;
+    }
+}
+
+template <class Key, class T>
+T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    if (!d)
+        rehash(8);
+    bool found;
+    const int i = insertSlot(key, uint(qHash(key, d->seed)), &found);
+    if (!found)
+        new (d->nodes + i) Node{key, T()};
+    return d->nodes[i].value;
+}
+
+template <class Key, class T>
+typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    if (!d)
+        rehash(8);
+    bool found;
+    const int i = insertSlot(key, uint(qHash(key, d->seed)), &found);
+    if (found)
+        d->nodes[i].value = value;
+    else
+        new (d->nodes + i) Node{key, value};
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::insert(const QFlatHash &other)
+{
+    if (d == other.d)
+        return;
+    reserve(size() + other.size());
+    for (const_iterator it = other.constBegin(), end = other.constEnd(); it != end; ++it)
+        insert(it.key(), it.value());
+}
+
+template <class Key, class T>
+typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.i >= 0 && it.i <= endIndex(), "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    if (it == constEnd())
+        return end();
+    const int i = it.i;
+    detach();
+    d->nodes[i].~Node();
+    --d->size;
+    // If every group that contains the slot also contains an empty slot, no
+    // lookup ever probed past it, and it can become empty rather than deleted.
+    using namespace QFlatHashPrivate;
+    const Group emptyAfter = matchEmpty(loadGroup(d->ctrl + i));
+    const Group emptyBefore = matchEmpty(loadGroup(d->ctrl + ((i - GroupWidth) & (d->capacity - 1))));
+    if (emptyAfter && emptyBefore
+            && firstMatch(emptyAfter) + (GroupWidth - 1 - lastMatch(emptyBefore)) < GroupWidth) {
+        d->setCtrl(i, Empty);
+        --d->used;
+    } else {
+        d->setCtrl(i, Deleted);
+    }
+    return iterator(d, nextFull(d, i + 1));
+}
+
+template <class Key, class T>
+int QFlatHash<Key, T>::remove(const Key &key)
+{
+    const int i = findIndex(key, hashOf(key));
+    if (i < 0)
+        return 0;
+    erase(const_iterator(d, i));
+    return 1;
+}
+
+template <class Key, class T>
+T QFlatHash<Key, T>::take(const Key &key)
+{
+    const int i = findIndex(key, hashOf(key));
+    if (i < 0)
+        return T();
+    detach();
+    T t = std::move(d->nodes[i].value);
+    erase(const_iterator(d, i));
+    return t;
+}
+
+template <class Key, class T>
+QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(), end = constEnd(); it != end; ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(), end = constEnd(); it != end; ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (d == other.d)
+        return true;
+    if (size() != other.size())
+        return false;
+    for (const_iterator it = constBegin(), end = constEnd(); it != end; ++it) {
+        const_iterator o = other.constFind(it.key());
+        if (o == other.constEnd() || !(o.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+inline void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2) Q_DECL_NOTHROW
+{
+    value1.swap(value2);
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_P_H
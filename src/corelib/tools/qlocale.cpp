@@ -3106,6 +3106,15 @@ QString QLocalePrivate::dateTimeToString(QStringView format, const QDateTime &da
 QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
                                     int width, unsigned flags) const
 {
+    if (width <= 0 && hasCLocaleSymbols()) {
+        char buf[64];
+        const int len = doubleToCLocaleChars(d, precision, form, flags, buf, int(sizeof buf));
+        if (len <= int(sizeof buf))
+            return QString::fromLatin1(buf, len);
+        QVarLengthArray<char> longBuf(len);
+        doubleToCLocaleChars(d, precision, form, flags, longBuf.data(), len);
+        return QString::fromLatin1(longBuf.constData(), len);
+    }
     return doubleToString(m_zero, m_plus, m_minus, m_exponential, m_group, m_decimal,
                           d, precision, form, width, flags);
 }
@@ -3223,6 +3232,143 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
     return num_str;
 }
 
+// Same result as doubleToString() with the C locale's symbols and a width of 0,
+// but laid out directly in \a buf rather than by inserting into a QString.
+int QLocaleData::doubleToCLocaleChars(double d, int precision, DoubleForm form,
+                                      unsigned flags, char *buf, int bufSize)
+{
+    if (precision != QLocale::FloatingPointShortest && precision < 0)
+        precision = 6;
+
+    int digitsSize = 1;
+    if (precision == QLocale::FloatingPointShortest)
+        digitsSize += DoubleMaxSignificant;
+    else if (form == DFDecimal)
+        digitsSize += ((d > (1 << 19) || d < -(1 << 19)) ? DoubleMaxDigitsBeforeDecimal : 6) +
+                precision;
+    else
+        digitsSize += qMax(2, precision) + 1;
+
+    QVarLengthArray<char> digits(digitsSize);
+    bool negative = false;
+    int length;
+    int decpt;
+    qt_doubleToAscii(d, form, precision, digits.data(), digitsSize, negative, length, decpt);
+
+    const bool special = qstrncmp(digits.constData(), "inf", 3) == 0
+            || qstrncmp(digits.constData(), "nan", 3) == 0;
+    if (!special && isZero(d))
+        negative = false;
+
+    char sign = 0;
+    if (negative)
+        sign = '-';
+    else if (flags & AlwaysShowSign)
+        sign = '+';
+    else if (flags & BlankBeforePositive)
+        sign = ' ';
+
+    if (special) {
+        const int total = (sign ? 1 : 0) + length;
+        if (total <= bufSize) {
+            if (sign)
+                *buf++ = sign;
+            for (int i = 0; i < length; ++i)
+                buf[i] = (flags & CapitalEorX) ? digits[i] - 'a' + 'A' : digits[i];
+        }
+        return total;
+    }
+
+    bool useExponent = form == DFExponent;
+    PrecisionMode pm = PMDecimalDigits;
+    if (form == DFSignificantDigits) {
+        pm = (flags & AddTrailingZeroes) ? PMSignificantDigits : PMChopTrailingZeros;
+
+        int cutoff = precision < 0 ? 6 : precision;
+        if (precision == QLocale::FloatingPointShortest && decpt > 0) {
+            cutoff = length + 4;
+            if (decpt <= 10)
+                ++cutoff;
+            else
+                cutoff += decpt > 100 ? 2 : 1;
+            if (!(flags & ForcePoint) && length > decpt)
+                ++cutoff;
+        }
+        useExponent = decpt != length && (decpt <= -4 || decpt > cutoff);
+    }
+
+    // The digits as decimalForm() and exponentForm() would pad them: leading
+    // zeros for a negative decpt, trailing zeros up to the requested precision.
+    const int leadingZeros = (!useExponent && decpt < 0) ? -decpt : 0;
+    const auto digitAt = [&](int i) {
+        i -= leadingZeros;
+        return (i >= 0 && i < length) ? digits[i] : '0';
+    };
+    const char exponential = (flags & CapitalEorX) ? 'E' : 'e';
+
+    if (useExponent) {
+        int count = length;
+        if (pm == PMDecimalDigits)
+            count = qMax(count, precision + 1);
+        else if (pm == PMSignificantDigits)
+            count = qMax(count, precision);
+        const bool point = (flags & ForcePoint) || count > 1;
+
+        const int exp = decpt - 1;
+        const int absExp = exp < 0 ? -exp : exp;
+        int expDigits = absExp >= 100 ? 3 : absExp >= 10 ? 2 : 1;
+        if ((flags & ZeroPadExponent) && expDigits < 2)
+            expDigits = 2;
+
+        const int total = (sign ? 1 : 0) + count + (point ? 1 : 0) + 2 + expDigits;
+        if (total > bufSize)
+            return total;
+
+        if (sign)
+            *buf++ = sign;
+        if (count > 0)
+            *buf++ = digitAt(0);
+        if (point)
+            *buf++ = '.';
+        for (int i = 1; i < count; ++i)
+            *buf++ = digitAt(i);
+        *buf++ = exponential;
+        *buf++ = exp < 0 ? '-' : '+';
+        for (int i = expDigits - 1, e = absExp; i >= 0; --i, e /= 10)
+            buf[i] = '0' + e % 10;
+        return total;
+    }
+
+    const int intDigits = qMax(decpt, 0);
+    int count = qMax(leadingZeros + length, intDigits);
+    if (pm == PMDecimalDigits)
+        count = qMax(count, intDigits + precision);
+    else if (pm == PMSignificantDigits)
+        count = qMax(count, precision);
+    const bool point = (flags & ForcePoint) || intDigits < count;
+    const bool group = (flags & ThousandsGroup) && intDigits > 3;
+
+    const int total = (sign ? 1 : 0) + qMax(intDigits, 1) + (group ? (intDigits - 1) / 3 : 0)
+            + (point ? 1 : 0) + count - intDigits;
+    if (total > bufSize)
+        return total;
+
+    if (sign)
+        *buf++ = sign;
+    if (intDigits == 0)
+        *buf++ = '0';
+    for (int i = 0; i < intDigits; ++i) {
+        if (group && i > 0 && (intDigits - i) % 3 == 0)
+            *buf++ = ',';
+        *buf++ = digitAt(i);
+    }
+    if (point)
+        *buf++ = '.';
+    for (int i = intDigits; i < count; ++i)
+        *buf++ = digitAt(i);
+    return total;
+}
+
 QString QLocaleData::longLongToString(qlonglong l, int precision,
                                             int base, int width,
                                             unsigned flags) const
@@ -3634,9 +3780,53 @@ bool QLocaleData::validateChars(QStringView str, NumberMode numMode, QByteArray
     return true;
 }
 
+// Copies \a s to \a out if, apart from surrounding whitespace, it consists only
+// of ASCII digits, signs, exponent characters and at most one decimal point that
+// precedes any exponent. numberToCLocale() maps these one to one for a locale
+// with the C locale's symbols, so the result can go to qt_asciiToDouble() as is.
+static int plainNumberToCLocale(QStringView s, char *out, int outSize)
+{
+    const QChar *uc = s.data();
+    qsizetype begin = 0;
+    qsizetype end = s.size();
+    const auto isAsciiSpace = [](ushort c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+    while (begin < end && isAsciiSpace(uc[begin].unicode()))
+        ++begin;
+    while (end > begin && isAsciiSpace(uc[end - 1].unicode()))
+        --end;
+    if (begin == end || end - begin > outSize)
+        return 0;
+
+    bool seenPoint = false;
+    bool seenExponent = false;
+    char *p = out;
+    for (qsizetype i = begin; i < end; ++i) {
+        const ushort c = uc[i].unicode();
+        if ((c >= '0' && c <= '9') || c == '+' || c == '-') {
+            *p++ = char(c);
+        } else if (c == 'e' || c == 'E') {
+            seenExponent = true;
+            *p++ = 'e';
+        } else if (c == '.' && !seenPoint && !seenExponent) {
+            seenPoint = true;
+            *p++ = '.';
+        } else {
+            return 0;
+        }
+    }
+    return int(p - out);
+}
+
 double QLocaleData::stringToDouble(QStringView str, bool *ok,
                                    QLocale::NumberOptions number_options) const
 {
+    if (hasCLocaleSymbols() && !(number_options & (QLocale::RejectLeadingZeroInExponent
+                                                   | QLocale::RejectTrailingZeroesAfterDot))) {
+        char buf[64];
+        if (const int len = plainNumberToCLocale(str, buf, int(sizeof buf)))
+            return cLocaleCharsToDouble(buf, len, ok);
+    }
+
     CharBuff buff;
     if (!numberToCLocale(str, number_options, &buff)) {
         if (ok != nullptr)
@@ -3677,6 +3867,16 @@ qulonglong QLocaleData::stringToUnsLongLong(QStringView str, int base, bool *ok,
     return bytearrayToUnsLongLong(buff.constData(), base, ok);
 }
 
+double QLocaleData::cLocaleCharsToDouble(const char *num, int len, bool *ok)
+{
+    bool nonNullOk = false;
+    int processed = 0;
+    double d = len > 0 ? qt_asciiToDouble(num, len, nonNullOk, processed) : 0.0;
+    if (ok != nullptr)
+        *ok = nonNullOk;
+    return d;
+}
+
 double QLocaleData::bytearrayToDouble(const char *num, bool *ok)
 {
     bool nonNullOk = false;
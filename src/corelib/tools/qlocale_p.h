@@ -230,6 +230,12 @@ public:
                                        int base, int width,
                                        unsigned flags);
 
+    // Formats like doubleToString() with the C locale's symbols and no width
+    // padding. Writes nothing unless the result fits into bufSize characters;
+    // returns the length of the result either way.
+    static int doubleToCLocaleChars(double d, int precision, DoubleForm form,
+                                    unsigned flags, char *buf, int bufSize);
+
     QString doubleToString(double d,
                            int precision = -1,
                            DoubleForm form = DFSignificantDigits,
@@ -269,6 +275,7 @@ public:
     quint64 stringToUnsLongLong(QStringView str, int base, bool *ok, QLocale::NumberOptions options) const;
 
     static double bytearrayToDouble(const char *num, bool *ok);
+    static double cLocaleCharsToDouble(const char *num, int len, bool *ok);
     // this function is used in QIntValidator (QtGui)
     Q_CORE_EXPORT static qint64 bytearrayToLongLong(const char *num, int base, bool *ok);
     static quint64 bytearrayToUnsLongLong(const char *num, int base, bool *ok);
@@ -276,6 +283,7 @@ public:
     bool numberToCLocale(QStringView s, QLocale::NumberOptions number_options,
                          CharBuff *result) const;
     inline char digitToCLocale(QChar c) const;
+    inline bool hasCLocaleSymbols() const;
 
     // this function is used in QIntValidator (QtGui)
     Q_CORE_EXPORT bool validateChars(QStringView str, NumberMode numMode, QByteArray *buff, int decDigits = -1,
@@ -394,6 +402,12 @@ inline QLocalePrivate *QSharedDataPointer<QLocalePrivate>::clone()
     return QLocalePrivate::create(d->m_data, d->m_numberOptions);
 }
 
+inline bool QLocaleData::hasCLocaleSymbols() const
+{
+    return m_zero == '0' && m_decimal == '.' && m_group == ',' && m_plus == '+'
+            && m_minus == '-' && m_exponential == 'e';
+}
+
 inline char QLocaleData::digitToCLocale(QChar in) const
 {
     const ushort tenUnicode = m_zero + 10;
@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include "qregularexpression.h"
+#include "qregularexpression_p.h"
 
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qhashfunctions.h>
@@ -51,6 +52,15 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/qatomic.h>
 #include <QtCore/qdatastream.h>
+#if QT_CONFIG(thread)
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#endif
+
+#include <algorithm>
+#include <limits>
 
 #define PCRE2_CODE_UNIT_WIDTH 16
 
@@ -829,6 +839,36 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    A compiled (and, if enabled, JIT-compiled) pattern. PCRE2 never modifies
+    the code after pcre2_jit_compile_16() has run, so one object is shared by
+    all the QRegularExpression objects with the same pattern and compile
+    options, in any thread; see QRegularExpressionPatternCache.
+*/
+struct QRegularExpressionCompiledPattern : QSharedData
+{
+    QRegularExpressionCompiledPattern()
+        : code(nullptr), errorCode(0), errorOffset(-1)
+    {
+    }
+
+    ~QRegularExpressionCompiledPattern()
+    {
+        pcre2_code_free_16(code);
+    }
+
+    pcre2_code_16 *code;
+    int errorCode;
+    int errorOffset;
+
+private:
+    Q_DISABLE_COPY(QRegularExpressionCompiledPattern)
+};
+
+typedef QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> QRegularExpressionCompiledPatternPointer;
+
+static QRegularExpressionCompiledPatternPointer qt_compileRegularExpressionPattern(const QString &pattern, int options);
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -838,7 +878,6 @@ struct QRegularExpressionPrivate : QSharedData
     void cleanCompiledPattern();
     void compilePattern();
     void getPatternInfo();
-    void optimizePattern();
 
     enum CheckSubjectStringOption {
         CheckSubjectString,
@@ -854,6 +893,15 @@ struct QRegularExpressionPrivate : QSharedData
                                             CheckSubjectStringOption checkSubjectStringOption = CheckSubjectString,
                                             const QRegularExpressionMatchPrivate *previous = 0) const;
 
+    void doBatchMatch(const QStringView *subjects,
+                      int count,
+                      int *offsets,
+                      QRegularExpression::MatchOptions matchOptions) const;
+    static QVector<int> batchMatch(const QRegularExpression &re,
+                                   const QVector<QStringView> &subjects,
+                                   QRegularExpression::MatchOptions matchOptions,
+                                   QRegularExpressionBatchMatchOptions batchOptions);
+
     int captureIndexForName(QStringView name) const;
 
     // sizeof(QSharedData) == 4, so start our members with an enum
@@ -865,9 +913,11 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The PCRE code is owned by the compiled pattern object, which is shared
+    // with every other QRegularExpressionPrivate using the same pattern and
+    // options; when the private is copied (i.e. a detach happened) both are
+    // set to nullptr
+    QRegularExpressionCompiledPatternPointer compiled;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     int errorOffset;
@@ -936,6 +986,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate()
       patternOptions(0),
       pattern(),
       mutex(),
+      compiled(),
       compiledPattern(nullptr),
       errorCode(0),
       errorOffset(-1),
@@ -957,8 +1008,7 @@ QRegularExpressionPrivate::~QRegularExpressionPrivate()
     \internal
 
     Copies the private, which means copying only the pattern and the pattern
-    options. The compiledPattern pointer is NOT copied (we
-    do not own it any more), and in general all the members set when
+    options. The compiled pattern is NOT copied, and in general all the members set when
     compiling a pattern are set to default values. isDirty is set back to true
     so that the pattern has to be recompiled again.
 */
@@ -967,6 +1017,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
       patternOptions(other.patternOptions),
       pattern(other.pattern),
       mutex(),
+      compiled(),
       compiledPattern(nullptr),
       errorCode(0),
       errorOffset(-1),
@@ -981,7 +1032,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiled.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -1004,25 +1055,14 @@ void QRegularExpressionPrivate::compilePattern()
 
     int options = convertToPcreOptions(patternOptions);
     options |= PCRE2_UTF;
-QT_WARNING_PUSH
-QT_WARNING_DISABLE_DEPRECATED
-    PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(pattern.utf16(),
-                                       pattern.length(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       NULL);
-QT_WARNING_POP
+    compiled = qt_compileRegularExpressionPattern(pattern, options);
+    compiledPattern = compiled->code;
     if (!compiledPattern) {
-        errorOffset = static_cast<int>(patternErrorOffset);
+        errorCode = compiled->errorCode;
+        errorOffset = compiled->errorOffset;
         return;
-    } else {
-        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
-        errorCode = 0;
     }
 
-    optimizePattern();
     getPatternInfo();
 }
 
@@ -1123,19 +1163,145 @@ static bool isJitEnabled()
     The purpose of the function is to call pcre2_jit_compile_16, which
     JIT-compiles the pattern.
 
-    It gets called when a pattern is recompiled by us (in compilePattern()),
-    under mutex protection.
+    It gets called when a pattern is compiled by us (in
+    compileUncachedPattern()), before the code is shared with anyone else.
 */
-void QRegularExpressionPrivate::optimizePattern()
+static void optimizePattern(pcre2_code_16 *code)
 {
-    Q_ASSERT(compiledPattern);
+    Q_ASSERT(code);
 
     static const bool enableJit = isJitEnabled();
 
     if (!enableJit)
         return;
 
-    pcre2_jit_compile_16(compiledPattern, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
+    pcre2_jit_compile_16(code, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
+}
+
+/*!
+    \internal
+
+    Compiles and optimizes \a pattern with the PCRE2 \a options, without
+    looking into the cache.
+*/
+static QRegularExpressionCompiledPatternPointer compileUncachedPattern(const QString &pattern, int options)
+{
+    QRegularExpressionCompiledPatternPointer compiled(new QRegularExpressionCompiledPattern);
+
+QT_WARNING_PUSH
+QT_WARNING_DISABLE_DEPRECATED
+    PCRE2_SIZE patternErrorOffset;
+    compiled->code = pcre2_compile_16(pattern.utf16(),
+                                      pattern.length(),
+                                      options,
+                                      &compiled->errorCode,
+                                      &patternErrorOffset,
+                                      NULL);
+QT_WARNING_POP
+    if (!compiled->code) {
+        compiled->errorOffset = static_cast<int>(patternErrorOffset);
+    } else {
+        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
+        compiled->errorCode = 0;
+        optimizePattern(compiled->code);
+    }
+
+    return compiled;
+}
+
+namespace {
+struct QRegularExpressionCacheKey
+{
+    QString pattern;
+    int options;
+
+    bool operator==(const QRegularExpressionCacheKey &other) const
+    {
+        return options == other.options && pattern == other.pattern;
+    }
+};
+
+uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.pattern);
+    seed = hash(seed, key.options);
+    return seed;
+}
+
+static int costOfCompiledPattern(const QRegularExpressionCompiledPattern *compiled, const QString &pattern)
+{
+    size_t cost = sizeof(QRegularExpressionCompiledPattern) + size_t(pattern.size()) * sizeof(QChar);
+    if (compiled->code) {
+        size_t size = 0;
+        if (pcre2_pattern_info_16(compiled->code, PCRE2_INFO_SIZE, &size) == 0)
+            cost += size;
+        size = 0;
+        if (pcre2_pattern_info_16(compiled->code, PCRE2_INFO_JITSIZE, &size) == 0)
+            cost += size;
+    }
+    return int(qMin(cost, size_t(std::numeric_limits<int>::max())));
+}
+
+/*
+    Least-recently-used cache of compiled patterns. Programs tend to build
+    the same QRegularExpression over and over (in loops, in functions called
+    for every item of a model, ...), and compiling and JIT-compiling a pattern
+    costs far more than most of the matches done with it.
+
+    1 MiB holds a few hundred typical patterns together with their JIT code.
+*/
+struct QRegularExpressionPatternCache
+    : QShardedCache<QRegularExpressionCacheKey, QRegularExpressionCompiledPatternPointer>
+{
+    QRegularExpressionPatternCache()
+        : QShardedCache(maxCostFromEnvironment("QT_REGEXP_CACHE_SIZE", 1024 * 1024))
+    { }
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QRegularExpressionPatternCache, qt_regularExpressionPatternCache)
+
+/*!
+    \internal
+
+    Returns the compiled code for \a pattern with the PCRE2 \a options,
+    shared with any other regular expression using the same ones.
+*/
+static QRegularExpressionCompiledPatternPointer qt_compileRegularExpressionPattern(const QString &pattern, int options)
+{
+    QRegularExpressionPatternCache *cache = qt_regularExpressionPatternCache();
+    if (!cache || !cache->isEnabled())
+        return compileUncachedPattern(pattern, options);
+
+    // Compilation happens outside of the cache's locks, so two threads missing
+    // the same pattern at once both compile it; the second one adopts the entry
+    // of the first one.
+    const QRegularExpressionCacheKey key = { pattern, options };
+    if (QRegularExpressionCompiledPatternPointer cached = cache->find(key))
+        return cached;
+    const QRegularExpressionCompiledPatternPointer compiled = compileUncachedPattern(pattern, options);
+    return cache->insert(key, compiled, costOfCompiledPattern(compiled.data(), pattern));
+}
+
+void qt_setRegularExpressionCacheLimit(int maxCost)
+{
+    if (QRegularExpressionPatternCache *cache = qt_regularExpressionPatternCache())
+        cache->setMaxCost(maxCost);
+}
+
+QRegularExpressionCacheStatistics qt_regularExpressionCacheStatistics()
+{
+    if (QRegularExpressionPatternCache *cache = qt_regularExpressionPatternCache())
+        return cache->statistics();
+    QShardedCacheStatistics statistics = { 0, 0, 0, 0, 0 };
+    return statistics;
+}
+
+void qt_clearRegularExpressionCache()
+{
+    if (QRegularExpressionPatternCache *cache = qt_regularExpressionPatternCache())
+        cache->clear();
 }
 
 /*!
@@ -1369,6 +1535,88 @@ QT_WARNING_POP
     return priv;
 }
 
+/*!
+    \internal
+
+    Matches each of the \a count strings in \a subjects, and writes the
+    offsets of the captured substrings to \a offsets, in the layout
+    described for qt_regularExpressionBatchMatch(). Unlike doMatch(), the
+    PCRE2 match data and context are created once for the whole range.
+*/
+void QRegularExpressionPrivate::doBatchMatch(const QStringView *subjects,
+                                             int count,
+                                             int *offsets,
+                                             QRegularExpression::MatchOptions matchOptions) const
+{
+    Q_ASSERT(compiledPattern);
+
+    const int stride = 2 * (capturingCount + 1);
+    const int pcreOptions = convertToPcreOptions(matchOptions);
+
+    pcre2_match_context_16 *matchContext = pcre2_match_context_create_16(NULL);
+    pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, NULL);
+    pcre2_match_data_16 *matchData = pcre2_match_data_create_from_pattern_16(compiledPattern, NULL);
+    const PCRE2_SIZE * const ovector = pcre2_get_ovector_pointer_16(matchData);
+
+    // PCRE2 rejects a null subject, even an empty one
+    static const unsigned short emptySubject = 0;
+
+    for (int i = 0; i < count; ++i, offsets += stride) {
+        const QStringView subject = subjects[i];
+        const unsigned short *subjectUtf16 = subject.utf16()
+                ? reinterpret_cast<const unsigned short *>(subject.utf16())
+                : &emptySubject;
+
+        const int result = safe_pcre2_match_16(compiledPattern,
+                                               subjectUtf16, int(subject.size()),
+                                               0, pcreOptions,
+                                               matchData, matchContext);
+
+        // result == 0 means not enough space in the ovector; should never happen
+        Q_ASSERT(result != 0);
+
+        const int capturedCount = result > 0 ? 2 * result : 0;
+        for (int j = 0; j < capturedCount; ++j)
+            offsets[j] = static_cast<int>(ovector[j]);
+        std::fill(offsets + capturedCount, offsets + stride, -1);
+    }
+
+    pcre2_match_data_free_16(matchData);
+    pcre2_match_context_free_16(matchContext);
+}
+
+#if QT_CONFIG(thread)
+/*
+    Matches one range of a batch in a thread of the pool.
+*/
+class QRegularExpressionBatchMatcher : public QRunnable
+{
+public:
+    QRegularExpressionBatchMatcher(const QRegularExpressionPrivate *d,
+                                   const QStringView *subjects, int count, int *offsets,
+                                   QRegularExpression::MatchOptions matchOptions,
+                                   QSemaphore *done)
+        : d(d), subjects(subjects), count(count), offsets(offsets),
+          matchOptions(matchOptions), done(done)
+    {
+    }
+
+    void run() override
+    {
+        d->doBatchMatch(subjects, count, offsets, matchOptions);
+        done->release();
+    }
+
+private:
+    const QRegularExpressionPrivate *d;
+    const QStringView *subjects;
+    int count;
+    int *offsets;
+    QRegularExpression::MatchOptions matchOptions;
+    QSemaphore *done;
+};
+#endif // QT_CONFIG(thread)
+
 /*!
     \internal
 */
@@ -1764,6 +2012,125 @@ QRegularExpressionMatchIterator QRegularExpression::globalMatch(const QStringRef
     return QRegularExpressionMatchIterator(*priv);
 }
 
+/*!
+    \internal
+
+    Matches \a re against each string in \a subjects, honoring the given
+    \a matchOptions and \a batchOptions, and returns the offsets of the
+    captured substrings.
+
+    This is equivalent to calling QRegularExpression::match() for each
+    subject, with an offset of 0 and the NormalMatch match type, but does not
+    allocate a QRegularExpressionMatch for every subject.
+
+    The returned vector holds 2 * (captureCount() + 1) integers per subject,
+    in the order of \a subjects: the start and end offsets of the implicit
+    capturing group 0 (the whole match), then those of capturing group 1, and
+    so on. An offset pair is -1, -1 if the subject did not match, or if the
+    capturing group did not capture anything. The offsets are relative to the
+    start of each subject.
+
+    If \a re is not valid, or the result would not fit in a QVector, an
+    empty vector is returned.
+*/
+QVector<int> qt_regularExpressionBatchMatch(const QRegularExpression &re,
+                                            const QStringList &subjects,
+                                            QRegularExpression::MatchOptions matchOptions,
+                                            QRegularExpressionBatchMatchOptions batchOptions)
+{
+    QVector<QStringView> views;
+    views.reserve(subjects.size());
+    for (const QString &subject : subjects)
+        views.append(subject);
+
+    return QRegularExpressionPrivate::batchMatch(re, views, matchOptions, batchOptions);
+}
+
+/*!
+    \internal
+    \overload
+
+    The strings viewed by \a subjects must stay valid until the function
+    returns.
+*/
+QVector<int> qt_regularExpressionBatchMatch(const QRegularExpression &re,
+                                            const QVector<QStringView> &subjects,
+                                            QRegularExpression::MatchOptions matchOptions,
+                                            QRegularExpressionBatchMatchOptions batchOptions)
+{
+    return QRegularExpressionPrivate::batchMatch(re, subjects, matchOptions, batchOptions);
+}
+
+/*!
+    \internal
+*/
+QVector<int> QRegularExpressionPrivate::batchMatch(const QRegularExpression &re,
+                                                   const QVector<QStringView> &subjects,
+                                                   QRegularExpression::MatchOptions matchOptions,
+                                                   QRegularExpressionBatchMatchOptions batchOptions)
+{
+    QRegularExpressionPrivate *d = re.d.data();
+    d->compilePattern();
+
+    if (Q_UNLIKELY(!d->compiledPattern)) {
+        qWarning("qt_regularExpressionBatchMatch(): called on an invalid QRegularExpression object");
+        return QVector<int>();
+    }
+
+    const int count = subjects.size();
+    const int stride = 2 * (d->capturingCount + 1);
+    if (Q_UNLIKELY(count > std::numeric_limits<int>::max() / stride)) {
+        qWarning("qt_regularExpressionBatchMatch(): too many subjects");
+        return QVector<int>();
+    }
+    QVector<int> offsets(count * stride);
+    const QStringView *subjectData = subjects.constData();
+    int *offsetData = offsets.data();
+
+#if QT_CONFIG(thread)
+    // Below this many subjects per range, handing a range over to another
+    // thread costs more than matching it
+    static const int MinimumRangeSize = 64;
+
+    int rangeCount = 1;
+    if (batchOptions & ParallelBatchMatchOption)
+        rangeCount = qBound(1, count / MinimumRangeSize, QThread::idealThreadCount());
+
+    if (rangeCount > 1) {
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore done;
+        int started = 0;
+
+        // the calling thread keeps the first range for itself
+        const int rangeSize = count / rangeCount;
+        for (int range = 1; range < rangeCount; ++range) {
+            const int begin = range * rangeSize;
+            const int end = range == rangeCount - 1 ? count : begin + rangeSize;
+            QRegularExpressionBatchMatcher *matcher =
+                    new QRegularExpressionBatchMatcher(d, subjectData + begin, end - begin,
+                                                       offsetData + begin * stride,
+                                                       matchOptions, &done);
+            if (pool->tryStart(matcher)) {
+                ++started;
+            } else {
+                delete matcher;
+                d->doBatchMatch(subjectData + begin, end - begin, offsetData + begin * stride,
+                                matchOptions);
+            }
+        }
+
+        d->doBatchMatch(subjectData, rangeSize, offsetData, matchOptions);
+        done.acquire(started);
+        return offsets;
+    }
+#else
+    Q_UNUSED(batchOptions);
+#endif
+
+    d->doBatchMatch(subjectData, count, offsetData, matchOptions);
+    return offsets;
+}
+
 /*!
     \since 5.4
 
@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QREGULAREXPRESSION_P_H
+#define QREGULAREXPRESSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qshardedcache_p.h>
+#include <QtCore/qregularexpression.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qstringview.h>
+#include <QtCore/qvector.h>
+
+QT_REQUIRE_CONFIG(regularexpression);
+
+QT_BEGIN_NAMESPACE
+
+typedef QShardedCacheStatistics QRegularExpressionCacheStatistics;
+
+// Process-wide cache of compiled (and JIT-compiled) patterns, keyed by the
+// pattern string and the compile options. Its size is a number of bytes, set
+// here or in KiB through QT_REGEXP_CACHE_SIZE; a size of 0 disables it.
+Q_CORE_EXPORT void qt_setRegularExpressionCacheLimit(int maxCost);
+Q_CORE_EXPORT QRegularExpressionCacheStatistics qt_regularExpressionCacheStatistics();
+Q_CORE_EXPORT void qt_clearRegularExpressionCache();
+
+enum QRegularExpressionBatchMatchOption {
+    NoBatchMatchOption         = 0x0000,
+    ParallelBatchMatchOption   = 0x0001
+};
+Q_DECLARE_FLAGS(QRegularExpressionBatchMatchOptions, QRegularExpressionBatchMatchOption)
+Q_DECLARE_OPERATORS_FOR_FLAGS(QRegularExpressionBatchMatchOptions)
+
+// Matches \a re against each of \a subjects, as match() would with an offset
+// of 0 and NormalMatch, and returns the start and end offsets of every
+// capturing group, 2 * (re.captureCount() + 1) integers per subject; -1 marks
+// a group that did not capture. With ParallelBatchMatchOption, large batches
+// are split over the threads of QThreadPool::globalInstance().
+Q_CORE_EXPORT QVector<int> qt_regularExpressionBatchMatch(const QRegularExpression &re,
+                                                          const QStringList &subjects,
+                                                          QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption,
+                                                          QRegularExpressionBatchMatchOptions batchOptions = NoBatchMatchOption);
+Q_CORE_EXPORT QVector<int> qt_regularExpressionBatchMatch(const QRegularExpression &re,
+                                                          const QVector<QStringView> &subjects,
+                                                          QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption,
+                                                          QRegularExpressionBatchMatchOptions batchOptions = NoBatchMatchOption);
+
+QT_END_NAMESPACE
+
+#endif // QREGULAREXPRESSION_P_H
@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSHARDEDCACHE_P_H
+#define QSHARDEDCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qmutex.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+struct QShardedCacheStatistics
+{
+    quint64 hits;
+    quint64 misses;
+    int count;
+    int totalCost;
+    int maxCost;
+};
+
+/*
+    A thread-safe least-recently-used cache of shared handles (implicitly or
+    explicitly shared pointers) for process-wide caches of expensive results.
+
+    The entries are spread over a few QCache shards chosen by the hash of the
+    key, each with its own mutex and an equal part of the total cost, so that
+    threads looking up different keys rarely wait for each other. Values are
+    computed by the caller outside of any lock; when two threads insert the
+    same key, the entry of the first one is kept and returned to both.
+
+    A maximum cost of 0 disables the cache: lookups then fail without locking.
+*/
+template <typename Key, typename Value>
+class QShardedCache
+{
+public:
+    enum { ShardCount = 8 };
+
+    explicit QShardedCache(int maxCost = 0) { setMaxCost(maxCost); }
+
+    // Returns the size in bytes set in KiB by the environment variable
+    // \a name, or \a defaultMaxCost if it is not set.
+    static int maxCostFromEnvironment(const char *name, int defaultMaxCost)
+    {
+        if (!qEnvironmentVariableIsSet(name))
+            return defaultMaxCost;
+        return qBound(0, qEnvironmentVariableIntValue(name), std::numeric_limits<int>::max() / 1024) * 1024;
+    }
+
+    bool isEnabled() const { return m_enabled.load(); }
+
+    // Returns the value for \a key, or a null value if there is none.
+    Value find(const Key &key)
+    {
+        if (!isEnabled())
+            return Value();
+        Shard &shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        if (Value *value = shard.entries.object(key)) {
+            ++shard.hits;
+            return *value;
+        }
+        ++shard.misses;
+        return Value();
+    }
+
+    // Stores \a value for \a key, unless another thread got there first, and
+    // returns the value that is now cached (or \a value if it is not cached).
+    Value insert(const Key &key, const Value &value, int cost)
+    {
+        if (!isEnabled())
+            return value;
+        Shard &shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        if (Value *other = shard.entries.object(key))
+            return *other;
+        shard.entries.insert(key, new Value(value), cost);
+        return value;
+    }
+
+    void setMaxCost(int maxCost)
+    {
+        maxCost = qMax(0, maxCost);
+        for (int i = 0; i < ShardCount; ++i) {
+            QMutexLocker locker(&m_shards[i].mutex);
+            m_shards[i].entries.setMaxCost(maxCost / ShardCount + (i < maxCost % ShardCount ? 1 : 0));
+        }
+        m_enabled.store(maxCost > 0);
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < ShardCount; ++i) {
+            QMutexLocker locker(&m_shards[i].mutex);
+            m_shards[i].entries.clear();
+        }
+    }
+
+    QShardedCacheStatistics statistics()
+    {
+        QShardedCacheStatistics statistics = { 0, 0, 0, 0, 0 };
+        for (int i = 0; i < ShardCount; ++i) {
+            QMutexLocker locker(&m_shards[i].mutex);
+            statistics.hits += m_shards[i].hits;
+            statistics.misses += m_shards[i].misses;
+            statistics.count += m_shards[i].entries.count();
+            statistics.totalCost += m_shards[i].entries.totalCost();
+            statistics.maxCost += m_shards[i].entries.maxCost();
+        }
+        return statistics;
+    }
+
+private:
+    struct Shard
+    {
+        Shard() : hits(0), misses(0) { }
+
+        QMutex mutex;
+        QCache<Key, Value> entries;
+        quint64 hits;
+        quint64 misses;
+    };
+
+    Shard &shardFor(const Key &key)
+    {
+        // the low bits select the bucket within the shard's QCache
+        return m_shards[(qHash(key) >> 24) % ShardCount];
+    }
+
+    QAtomicInt m_enabled;
+    Shard m_shards[ShardCount];
+
+    Q_DISABLE_COPY(QShardedCache)
+};
+
+QT_END_NAMESPACE
+
+#endif // QSHARDEDCACHE_P_H
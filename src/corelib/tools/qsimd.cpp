@@ -65,9 +65,13 @@
 #define HWCAP_VFPv3D16  16384
 
 // copied from <asm/hwcap.h> (ARM):
+#define HWCAP2_SHA1  (1 << 2)
+#define HWCAP2_SHA2  (1 << 3)
 #define HWCAP2_CRC32 (1 << 4)
 
 // copied from <asm/hwcap.h> (Aarch64)
+#define HWCAP_SHA1              (1 << 5)
+#define HWCAP_SHA2              (1 << 6)
 #define HWCAP_CRC32             (1 << 7)
 
 // copied from <linux/auxvec.h>
@@ -90,12 +94,16 @@ QT_BEGIN_NAMESPACE
 /* Data:
  neon
  crc32
+ sha1
+ sha2
  */
 static const char features_string[] =
         " neon\0"
         " crc32\0"
+        " sha1\0"
+        " sha2\0"
         "\0";
-static const int features_indices[] = { 0, 6 };
+static const int features_indices[] = { 0, 6, 13, 19 };
 #elif defined(Q_PROCESSOR_MIPS)
 /* Data:
  dsp
@@ -149,6 +157,10 @@ static inline quint64 detectProcessorFeatures()
                     // For Aarch64:
                     if (vector[i+1] & HWCAP_CRC32)
                         features |= Q_UINT64_C(1) << CpuFeatureCRC32;
+                    if (vector[i+1] & HWCAP_SHA1)
+                        features |= Q_UINT64_C(1) << CpuFeatureSHA1;
+                    if (vector[i+1] & HWCAP_SHA2)
+                        features |= Q_UINT64_C(1) << CpuFeatureSHA2;
 #  endif
                     // Aarch32, or ARMv7 or before:
                     if (vector[i+1] & HWCAP_NEON)
@@ -159,6 +171,10 @@ static inline quint64 detectProcessorFeatures()
                 if (vector[i] == AT_HWCAP2) {
                     if (vector[i+1] & HWCAP2_CRC32)
                         features |= Q_UINT64_C(1) << CpuFeatureCRC32;
+                    if (vector[i+1] & HWCAP2_SHA1)
+                        features |= Q_UINT64_C(1) << CpuFeatureSHA1;
+                    if (vector[i+1] & HWCAP2_SHA2)
+                        features |= Q_UINT64_C(1) << CpuFeatureSHA2;
                 }
 #  endif
             }
@@ -176,6 +192,10 @@ static inline quint64 detectProcessorFeatures()
 #if defined(__ARM_FEATURE_CRC32)
     features |= Q_UINT64_C(1) << CpuFeatureCRC32;
 #endif
+#if defined(__ARM_FEATURE_CRYPTO)
+    features |= Q_UINT64_C(1) << CpuFeatureSHA1;
+    features |= Q_UINT64_C(1) << CpuFeatureSHA2;
+#endif
 
     return features;
 }
@@ -302,6 +302,12 @@ QT_END_NAMESPACE
 #endif
 #  include <arm_acle.h>
 #endif
+#if defined(Q_PROCESSOR_ARM_V8) && defined(__ARM_FEATURE_CRYPTO)
+#if defined(Q_PROCESSOR_ARM_64)
+// only available on aarch64
+#define QT_FUNCTION_TARGET_STRING_CRYPTO     "+crypto"
+#endif
+#endif
 
 #ifdef __cplusplus
 #include <qatomic.h>
@@ -314,6 +320,8 @@ enum CPUFeatures {
     CpuFeatureNEON          = 2,
     CpuFeatureARM_NEON      = CpuFeatureNEON,
     CpuFeatureCRC32         = 4,
+    CpuFeatureSHA1          = 8,
+    CpuFeatureSHA2          = 16,
 #elif defined(Q_PROCESSOR_MIPS)
     CpuFeatureDSP           = 2,
     CpuFeatureDSPR2         = 4,
@@ -330,6 +338,10 @@ static const quint64 qCompilerCpuFeatures = 0
 #if defined __ARM_FEATURE_CRC32
         | CpuFeatureCRC32
 #endif
+#if defined __ARM_FEATURE_CRYPTO
+        | CpuFeatureSHA1
+        | CpuFeatureSHA2
+#endif
 #if defined __mips_dsp
         | CpuFeatureDSP
 #endif
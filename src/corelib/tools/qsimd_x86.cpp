@@ -39,14 +39,15 @@ static const char features_string[] =
     " avx512vpopcntdq\0"
     " avx5124nniw\0"
     " avx5124fmaps\0"
+    " pclmul\0"
     "\0";
 
 static const quint16 features_indices[] = {
-    306,   0,   6,  12,  19,  24,  32,  40,
+    314,   0,   6,  12,  19,  24,  32,  40,
      47,  55,  60,  65,  71,  78,  83,  88,
      94, 100, 105, 114, 124, 132, 144, 154,
     164, 174, 179, 189, 199, 211, 224, 230,
-    236, 248, 262, 279, 292
+    236, 248, 262, 279, 292, 306
 };
 
 enum X86CpuidLeaves {
@@ -94,7 +95,8 @@ static const quint8 x86_locators[] = {
     Leaf7_0ECX*32 + 12, // avx512bitalg
     Leaf7_0ECX*32 + 14, // avx512vpopcntdq
     Leaf7_0EDX*32 +  2, // avx5124nniw
-    Leaf7_0EDX*32 +  3  // avx5124fmaps
+    Leaf7_0EDX*32 +  3, // avx5124fmaps
+    Leaf1ECX*32 +  1  // pclmul
 };
 
 // List of AVX512 features (see detectProcessorFeatures())
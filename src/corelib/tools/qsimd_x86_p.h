@@ -78,7 +78,7 @@ QT_BEGIN_NAMESPACE
 #define CpuFeatureAVX512CD                          (Q_UINT64_C(1) << 24)
 #define QT_FUNCTION_TARGET_STRING_AVX512CD          "avx512cd"
 #define CpuFeatureSHA                               (Q_UINT64_C(1) << 25)
-#define QT_FUNCTION_TARGET_STRING_SHA               "sha"
+#define QT_FUNCTION_TARGET_STRING_SHA               "sha,sse4.1"
 #define CpuFeatureAVX512BW                          (Q_UINT64_C(1) << 26)
 #define QT_FUNCTION_TARGET_STRING_AVX512BW          "avx512bw"
 #define CpuFeatureAVX512VL                          (Q_UINT64_C(1) << 27)
@@ -106,6 +106,10 @@ QT_BEGIN_NAMESPACE
 #define CpuFeatureAVX5124FMAPS                      (Q_UINT64_C(1) << 36)
 #define QT_FUNCTION_TARGET_STRING_AVX5124FMAPS      "avx5124fmaps"
 
+// in CPUID Leaf 1, ECX:
+#define CpuFeaturePCLMUL                            (Q_UINT64_C(1) << 37)
+#define QT_FUNCTION_TARGET_STRING_PCLMUL            "pclmul,sse4.1"
+
 static const quint64 qCompilerCpuFeatures = 0
 #ifdef __SSE2__
          | CpuFeatureSSE2
@@ -214,6 +218,9 @@ static const quint64 qCompilerCpuFeatures = 0
 #endif
 #ifdef __AVX5124FMAPS__
          | CpuFeatureAVX5124FMAPS
+#endif
+#ifdef __PCLMUL__
+         | CpuFeaturePCLMUL
 #endif
         ;
 
@@ -287,6 +287,20 @@ Q_DECL_CONSTEXPR inline bool operator==(const QTzTransitionRule &lhs, const QTzT
 Q_DECL_CONSTEXPR inline bool operator!=(const QTzTransitionRule &lhs, const QTzTransitionRule &rhs) Q_DECL_NOTHROW
 { return !operator==(lhs, rhs); }
 
+// The parsed contents of a tz file, shared by all QTzTimeZonePrivate instances for the zone
+struct QTzTimeZoneCacheEntry
+{
+    QVector<QTzTransitionTime> m_tranTimes;
+    QVector<QTzTransitionRule> m_tranRules;
+    QList<QByteArray> m_abbreviations;
+    QByteArray m_posixRule;
+    // m_posixRule's transitions, two per year from m_posixFirstYear, or a
+    // single one if the rule has a constant offset; empty if not precalculated
+    QVector<QTimeZonePrivate::Data> m_posixTransitions;
+    int m_posixFirstYear = 0;
+    bool m_hasDaylightTime = false;
+};
+
 class Q_AUTOTEST_EXPORT QTzTimeZonePrivate final : public QTimeZonePrivate
 {
     QTzTimeZonePrivate(const QTzTimeZonePrivate &) = default;
@@ -333,14 +347,14 @@ private:
     void init(const QByteArray &ianaId);
     QVector<QTimeZonePrivate::Data> getPosixTransitions(qint64 msNear) const;
 
+    const QTimeZonePrivate::Data *findPosixTransitions(qint64 msNear, int *count) const;
+    bool offsetsForTime(qint64 forMSecsSinceEpoch, int *stdOffset, int *dstOffset) const;
+
     Data dataForTzTransition(QTzTransitionTime tran) const;
-    QVector<QTzTransitionTime> m_tranTimes;
-    QVector<QTzTransitionRule> m_tranRules;
-    QList<QByteArray> m_abbreviations;
 #if QT_CONFIG(icu)
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif
-    QByteArray m_posixRule;
+    QTzTimeZoneCacheEntry m_cachedData;
 };
 #endif // Q_OS_UNIX
 
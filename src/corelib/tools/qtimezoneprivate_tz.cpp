@@ -45,6 +45,7 @@
 #include <QtCore/QHash>
 #include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
+#include <QtCore/QMutex>
 
 #include <qdebug.h>
 
@@ -107,6 +108,16 @@ static QTzTimeZoneHash loadTzTimeZones()
 // Hash of available system tz files as loaded by loadTzTimeZones()
 Q_GLOBAL_STATIC_WITH_ARGS(const QTzTimeZoneHash, tzZones, (loadTzTimeZones()));
 
+static QList<QByteArray> sortedTzZoneIds()
+{
+    QList<QByteArray> result = tzZones->keys();
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Sorted IDs of tzZones, as returned by availableTimeZoneIds()
+Q_GLOBAL_STATIC_WITH_ARGS(const QList<QByteArray>, tzZoneIds, (sortedTzZoneIds()));
+
 /*
     The following is copied and modified from tzfile.h which is in the public domain.
     Copied as no compatibility guarantee and is never system installed.
@@ -647,21 +658,26 @@ QTzTimeZonePrivate *QTzTimeZonePrivate::clone() const
     return new QTzTimeZonePrivate(*this);
 }
 
-void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+// The years for which QTzTimeZoneCacheEntry::m_posixTransitions is filled in
+static const int PosixTableFirstYear = 1970;
+static const int PosixTableLastYear = 2100;
+
+static QTzTimeZoneCacheEntry loadTzTimeZone(const QByteArray &ianaId)
 {
+    QTzTimeZoneCacheEntry ret;
     QFile tzif;
     if (ianaId.isEmpty()) {
         // Open system tz
         tzif.setFileName(QStringLiteral("/etc/localtime"));
         if (!tzif.open(QIODevice::ReadOnly))
-            return;
+            return ret;
     } else {
         // Open named tz, try modern path first, if fails try legacy path
         tzif.setFileName(QLatin1String("/usr/share/zoneinfo/") + QString::fromLocal8Bit(ianaId));
         if (!tzif.open(QIODevice::ReadOnly)) {
             tzif.setFileName(QLatin1String("/usr/lib/zoneinfo/") + QString::fromLocal8Bit(ianaId));
             if (!tzif.open(QIODevice::ReadOnly))
-                return;
+                return ret;
         }
     }
 
@@ -671,59 +687,58 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
     bool ok = false;
     QTzHeader hdr = parseTzHeader(ds, &ok);
     if (!ok || ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     QVector<QTzTransition> tranList = parseTzTransitions(ds, hdr.tzh_timecnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     QVector<QTzType> typeList = parseTzTypes(ds, hdr.tzh_typecnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     QMap<int, QByteArray> abbrevMap = parseTzAbbreviations(ds, hdr.tzh_charcnt, typeList);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     parseTzLeapSeconds(ds, hdr.tzh_leapcnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     typeList = parseTzIndicators(ds, typeList, hdr.tzh_ttisstdcnt, hdr.tzh_ttisgmtcnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
 
     // If version 2 then parse the second block of data
     if (hdr.tzh_version == '2' || hdr.tzh_version == '3') {
         ok = false;
         QTzHeader hdr2 = parseTzHeader(ds, &ok);
         if (!ok || ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         tranList = parseTzTransitions(ds, hdr2.tzh_timecnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         typeList = parseTzTypes(ds, hdr2.tzh_typecnt);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         abbrevMap = parseTzAbbreviations(ds, hdr2.tzh_charcnt, typeList);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         parseTzLeapSeconds(ds, hdr2.tzh_leapcnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         typeList = parseTzIndicators(ds, typeList, hdr2.tzh_ttisstdcnt, hdr2.tzh_ttisgmtcnt);
         if (ds.status() != QDataStream::Ok)
-            return;
-        m_posixRule = parseTzPosixRule(ds);
+            return ret;
+        ret.m_posixRule = parseTzPosixRule(ds);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
     }
 
     // Translate the TZ file into internal format
 
     // Translate the array index based tz_abbrind into list index
     const int size = abbrevMap.size();
-    m_abbreviations.clear();
-    m_abbreviations.reserve(size);
+    ret.m_abbreviations.reserve(size);
     QVector<int> abbrindList;
     abbrindList.reserve(size);
     for (auto it = abbrevMap.cbegin(), end = abbrevMap.cend(); it != end; ++it) {
-        m_abbreviations.append(it.value());
+        ret.m_abbreviations.append(it.value());
         abbrindList.append(it.key());
     }
     for (int i = 0; i < typeList.size(); ++i)
@@ -741,7 +756,7 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
 
     // Now for each transition time calculate and store our rule:
     const int tranCount = tranList.count();;
-    m_tranTimes.reserve(tranCount);
+    ret.m_tranTimes.reserve(tranCount);
     // The DST offset when in effect: usually stable, usually an hour:
     int lastDstOff = 3600;
     for (int i = 0; i < tranCount; i++) {
@@ -795,18 +810,91 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         rule.abbreviationIndex = tz_type.tz_abbrind;
 
         // If the rule already exist then use that, otherwise add it
-        int ruleIndex = m_tranRules.indexOf(rule);
+        int ruleIndex = ret.m_tranRules.indexOf(rule);
         if (ruleIndex == -1) {
-            m_tranRules.append(rule);
-            tran.ruleIndex = m_tranRules.size() - 1;
+            ret.m_tranRules.append(rule);
+            tran.ruleIndex = ret.m_tranRules.size() - 1;
         } else {
             tran.ruleIndex = ruleIndex;
         }
 
         tran.atMSecsSinceEpoch = tz_tran.tz_time * 1000;
-        m_tranTimes.append(tran);
+        ret.m_tranTimes.append(tran);
+    }
+    for (const QTzTransitionRule &rule : qAsConst(ret.m_tranRules)) {
+        if (rule.dstOffset != 0) {
+            ret.m_hasDaylightTime = true;
+            break;
+        }
+    }
+
+    // Calculating the POSIX rule's transitions for a year takes far longer than
+    // looking them up, so do it once for the years dates are most likely in.
+    if (!ret.m_posixRule.isEmpty() && !ret.m_tranTimes.isEmpty()) {
+        const qint64 lastTranMSecs = ret.m_tranTimes.last().atMSecsSinceEpoch;
+        const int lastTranYear = QDateTime::fromMSecsSinceEpoch(lastTranMSecs, Qt::UTC).date().year();
+        const int firstYear = qMax(PosixTableFirstYear, lastTranYear - 1);
+        if (firstYear < PosixTableLastYear) {
+            QVector<QTimeZonePrivate::Data> table =
+                calculatePosixTransitions(ret.m_posixRule, firstYear, PosixTableLastYear, lastTranMSecs);
+            // Either a constant offset, or a pair of transitions for each year
+            if (table.size() == 1 || table.size() == 2 * (PosixTableLastYear - firstYear + 1)) {
+                ret.m_posixTransitions = std::move(table);
+                ret.m_posixFirstYear = firstYear;
+            }
+        }
+    }
+    return ret;
+}
+
+/*
+    Parsed tz files shared by all QTzTimeZonePrivate instances of a zone, in all
+    threads. An entry is never changed once it has been added.
+*/
+class QTzTimeZoneCache
+{
+public:
+    QTzTimeZoneCacheEntry fetchEntry(const QByteArray &ianaId);
+
+private:
+    QHash<QByteArray, QTzTimeZoneCacheEntry> m_cache;
+    QMutex m_mutex;
+};
+
+QTzTimeZoneCacheEntry QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId)
+{
+    // /etc/localtime may be replaced at any time, so the unnamed system zone isn't cached
+    if (ianaId.isEmpty())
+        return loadTzTimeZone(ianaId);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_cache.constFind(ianaId);
+        if (it != m_cache.constEnd())
+            return *it;
     }
-    if (m_tranTimes.isEmpty() && m_posixRule.isEmpty())
+
+    // Parse without holding the lock, so threads loading other zones don't wait for us
+    QTzTimeZoneCacheEntry entry = loadTzTimeZone(ianaId);
+    if (entry.m_tranTimes.isEmpty() && entry.m_posixRule.isEmpty())
+        return entry; // Don't let invalid IDs grow the cache
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_cache.find(ianaId);
+    if (it == m_cache.end())
+        it = m_cache.insert(ianaId, std::move(entry));
+    return *it;
+}
+
+Q_GLOBAL_STATIC(QTzTimeZoneCache, tzCache)
+
+void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+{
+    if (QTzTimeZoneCache *cache = tzCache())
+        m_cachedData = cache->fetchEntry(ianaId);
+    else
+        m_cachedData = loadTzTimeZone(ianaId);
+    if (m_cachedData.m_tranTimes.isEmpty() && m_cachedData.m_posixRule.isEmpty())
         return; // Invalid after all !
 
     if (ianaId.isEmpty())
@@ -892,12 +980,13 @@ QString QTzTimeZonePrivate::displayName(QTimeZone::TimeType timeType,
     }
 
     // Otherwise is strange sequence, so work backwards through trans looking for first match, if any
-    auto it = std::partition_point(m_tranTimes.cbegin(), m_tranTimes.cend(),
+    const QVector<QTzTransitionTime> &tranTimes = m_cachedData.m_tranTimes;
+    auto it = std::partition_point(tranTimes.cbegin(), tranTimes.cend(),
                                    [currentMSecs](const QTzTransitionTime &at) {
                                        return at.atMSecsSinceEpoch <= currentMSecs;
                                    });
 
-    while (it != m_tranTimes.cbegin()) {
+    while (it != tranTimes.cbegin()) {
         --it;
         tran = dataForTzTransition(*it);
         int offset = tran.daylightTimeOffset;
@@ -916,28 +1005,27 @@ QString QTzTimeZonePrivate::abbreviation(qint64 atMSecsSinceEpoch) const
 
 int QTzTimeZonePrivate::offsetFromUtc(qint64 atMSecsSinceEpoch) const
 {
-    const QTimeZonePrivate::Data tran = data(atMSecsSinceEpoch);
-    return tran.offsetFromUtc; // == tran.standardTimeOffset + tran.daylightTimeOffset
+    int stdOffset, dstOffset;
+    if (!offsetsForTime(atMSecsSinceEpoch, &stdOffset, &dstOffset))
+        return invalidSeconds();
+    return stdOffset + dstOffset;
 }
 
 int QTzTimeZonePrivate::standardTimeOffset(qint64 atMSecsSinceEpoch) const
 {
-    return data(atMSecsSinceEpoch).standardTimeOffset;
+    int stdOffset, dstOffset;
+    return offsetsForTime(atMSecsSinceEpoch, &stdOffset, &dstOffset) ? stdOffset : invalidSeconds();
 }
 
 int QTzTimeZonePrivate::daylightTimeOffset(qint64 atMSecsSinceEpoch) const
 {
-    return data(atMSecsSinceEpoch).daylightTimeOffset;
+    int stdOffset, dstOffset;
+    return offsetsForTime(atMSecsSinceEpoch, &stdOffset, &dstOffset) ? dstOffset : invalidSeconds();
 }
 
 bool QTzTimeZonePrivate::hasDaylightTime() const
 {
-    // TODO Perhaps cache as frequently accessed?
-    for (const QTzTransitionRule &rule : m_tranRules) {
-        if (rule.dstOffset != 0)
-            return true;
-    }
-    return false;
+    return m_cachedData.m_hasDaylightTime;
 }
 
 bool QTzTimeZonePrivate::isDaylightTime(qint64 atMSecsSinceEpoch) const
@@ -949,11 +1037,11 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
 {
     QTimeZonePrivate::Data data;
     data.atMSecsSinceEpoch = tran.atMSecsSinceEpoch;
-    QTzTransitionRule rule = m_tranRules.at(tran.ruleIndex);
+    QTzTransitionRule rule = m_cachedData.m_tranRules.at(tran.ruleIndex);
     data.standardTimeOffset = rule.stdOffset;
     data.daylightTimeOffset = rule.dstOffset;
     data.offsetFromUtc = rule.stdOffset + rule.dstOffset;
-    data.abbreviation = QString::fromUtf8(m_abbreviations.at(rule.abbreviationIndex));
+    data.abbreviation = QString::fromUtf8(m_cachedData.m_abbreviations.at(rule.abbreviationIndex));
     return data;
 }
 
@@ -961,37 +1049,105 @@ QVector<QTimeZonePrivate::Data> QTzTimeZonePrivate::getPosixTransitions(qint64 m
 {
     const int year = QDateTime::fromMSecsSinceEpoch(msNear, Qt::UTC).date().year();
     // The Data::atMSecsSinceEpoch of the single entry if zone is constant:
-    qint64 atTime = m_tranTimes.isEmpty() ? msNear : m_tranTimes.last().atMSecsSinceEpoch;
-    return calculatePosixTransitions(m_posixRule, year - 1, year + 1, atTime);
+    const QVector<QTzTransitionTime> &tranTimes = m_cachedData.m_tranTimes;
+    qint64 atTime = tranTimes.isEmpty() ? msNear : tranTimes.last().atMSecsSinceEpoch;
+    return calculatePosixTransitions(m_cachedData.m_posixRule, year - 1, year + 1, atTime);
+}
+
+// Returns what getPosixTransitions(msNear) would, without copying, if the cached table covers it
+const QTimeZonePrivate::Data *QTzTimeZonePrivate::findPosixTransitions(qint64 msNear, int *count) const
+{
+    const QVector<QTimeZonePrivate::Data> &table = m_cachedData.m_posixTransitions;
+    if (table.size() == 1) {
+        *count = 1;
+        return table.constData();
+    }
+
+    const int year = QDateTime::fromMSecsSinceEpoch(msNear, Qt::UTC).date().year();
+    const int first = 2 * (year - 1 - m_cachedData.m_posixFirstYear);
+    if (first < 0 || first + 6 > table.size())
+        return nullptr;
+    *count = 6;
+    return table.constData() + first;
+}
+
+// The offsets data(forMSecsSinceEpoch) would report, without building its abbreviation
+bool QTzTimeZonePrivate::offsetsForTime(qint64 forMSecsSinceEpoch, int *stdOffset, int *dstOffset) const
+{
+    const QVector<QTzTransitionTime> &tranTimes = m_cachedData.m_tranTimes;
+    if (!m_cachedData.m_posixRule.isEmpty()
+        && (tranTimes.isEmpty() || tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch)) {
+        int count;
+        const QTimeZonePrivate::Data *posixTrans = findPosixTransitions(forMSecsSinceEpoch, &count);
+        if (!posixTrans) {
+            const QTimeZonePrivate::Data data = this->data(forMSecsSinceEpoch);
+            *stdOffset = data.standardTimeOffset;
+            *dstOffset = data.daylightTimeOffset;
+            return data.atMSecsSinceEpoch != invalidMSecs();
+        }
+        const QTimeZonePrivate::Data *end = posixTrans + count;
+        auto it = std::partition_point(posixTrans, end,
+                                       [forMSecsSinceEpoch] (const QTimeZonePrivate::Data &at) {
+                                           return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
+                                       });
+        if (it > posixTrans || (tranTimes.isEmpty() && it < end)) {
+            const QTimeZonePrivate::Data &data = *(it > posixTrans ? it - 1 : it);
+            *stdOffset = data.standardTimeOffset;
+            *dstOffset = data.daylightTimeOffset;
+            return true;
+        }
+    }
+    if (tranTimes.isEmpty()) // Only possible if !isValid()
+        return false;
+
+    auto last = std::partition_point(tranTimes.cbegin(), tranTimes.cend(),
+                                     [forMSecsSinceEpoch] (const QTzTransitionTime &at) {
+                                         return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
+                                     });
+    if (last > tranTimes.cbegin())
+        --last;
+    const QTzTransitionRule &rule = m_cachedData.m_tranRules.at(last->ruleIndex);
+    *stdOffset = rule.stdOffset;
+    *dstOffset = rule.dstOffset;
+    return true;
 }
 
 QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
 {
     // If the required time is after the last transition (or there were none)
     // and we have a POSIX rule, then use it:
-    if (!m_posixRule.isEmpty()
-        && (m_tranTimes.isEmpty() || m_tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch)) {
-        QVector<QTimeZonePrivate::Data> posixTrans = getPosixTransitions(forMSecsSinceEpoch);
-        auto it = std::partition_point(posixTrans.cbegin(), posixTrans.cend(),
+    const QVector<QTzTransitionTime> &tranTimes = m_cachedData.m_tranTimes;
+    if (!m_cachedData.m_posixRule.isEmpty()
+        && (tranTimes.isEmpty() || tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch)) {
+        QVector<QTimeZonePrivate::Data> calculated;
+        int count;
+        const QTimeZonePrivate::Data *posixTrans = findPosixTransitions(forMSecsSinceEpoch, &count);
+        if (!posixTrans) {
+            calculated = getPosixTransitions(forMSecsSinceEpoch);
+            posixTrans = calculated.constData();
+            count = calculated.size();
+        }
+        const QTimeZonePrivate::Data *end = posixTrans + count;
+        auto it = std::partition_point(posixTrans, end,
                                        [forMSecsSinceEpoch] (const QTimeZonePrivate::Data &at) {
                                            return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
                                        });
         // Use most recent, if any in the past; or the first if we have no other rules:
-        if (it > posixTrans.cbegin() || (m_tranTimes.isEmpty() && it < posixTrans.cend())) {
-            QTimeZonePrivate::Data data = *(it > posixTrans.cbegin() ? it - 1 : it);
+        if (it > posixTrans || (tranTimes.isEmpty() && it < end)) {
+            QTimeZonePrivate::Data data = *(it > posixTrans ? it - 1 : it);
             data.atMSecsSinceEpoch = forMSecsSinceEpoch;
             return data;
         }
     }
-    if (m_tranTimes.isEmpty()) // Only possible if !isValid()
+    if (tranTimes.isEmpty()) // Only possible if !isValid()
         return invalidData();
 
     // Otherwise, use the rule for the most recent or first transition:
-    auto last = std::partition_point(m_tranTimes.cbegin(), m_tranTimes.cend(),
+    auto last = std::partition_point(tranTimes.cbegin(), tranTimes.cend(),
                                      [forMSecsSinceEpoch] (const QTzTransitionTime &at) {
                                          return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
                                      });
-    if (last > m_tranTimes.cbegin())
+    if (last > tranTimes.cbegin())
         --last;
     Data data = dataForTzTransition(*last);
     data.atMSecsSinceEpoch = forMSecsSinceEpoch;
@@ -1007,48 +1163,65 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
 {
     // If the required time is after the last transition (or there were none)
     // and we have a POSIX rule, then use it:
-    if (!m_posixRule.isEmpty()
-        && (m_tranTimes.isEmpty() || m_tranTimes.last().atMSecsSinceEpoch < afterMSecsSinceEpoch)) {
-        QVector<QTimeZonePrivate::Data> posixTrans = getPosixTransitions(afterMSecsSinceEpoch);
-        auto it = std::partition_point(posixTrans.cbegin(), posixTrans.cend(),
+    const QVector<QTzTransitionTime> &tranTimes = m_cachedData.m_tranTimes;
+    if (!m_cachedData.m_posixRule.isEmpty()
+        && (tranTimes.isEmpty() || tranTimes.last().atMSecsSinceEpoch < afterMSecsSinceEpoch)) {
+        QVector<QTimeZonePrivate::Data> calculated;
+        int count;
+        const QTimeZonePrivate::Data *posixTrans = findPosixTransitions(afterMSecsSinceEpoch, &count);
+        if (!posixTrans) {
+            calculated = getPosixTransitions(afterMSecsSinceEpoch);
+            posixTrans = calculated.constData();
+            count = calculated.size();
+        }
+        const QTimeZonePrivate::Data *end = posixTrans + count;
+        auto it = std::partition_point(posixTrans, end,
                                        [afterMSecsSinceEpoch] (const QTimeZonePrivate::Data &at) {
                                            return at.atMSecsSinceEpoch <= afterMSecsSinceEpoch;
                                        });
 
-        return it == posixTrans.cend() ? invalidData() : *it;
+        return it == end ? invalidData() : *it;
     }
 
     // Otherwise, if we can find a valid tran, use its rule:
-    auto last = std::partition_point(m_tranTimes.cbegin(), m_tranTimes.cend(),
+    auto last = std::partition_point(tranTimes.cbegin(), tranTimes.cend(),
                                      [afterMSecsSinceEpoch] (const QTzTransitionTime &at) {
                                          return at.atMSecsSinceEpoch <= afterMSecsSinceEpoch;
                                      });
-    return last != m_tranTimes.cend() ? dataForTzTransition(*last) : invalidData();
+    return last != tranTimes.cend() ? dataForTzTransition(*last) : invalidData();
 }
 
 QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecsSinceEpoch) const
 {
     // If the required time is after the last transition (or there were none)
     // and we have a POSIX rule, then use it:
-    if (!m_posixRule.isEmpty()
-        && (m_tranTimes.isEmpty() || m_tranTimes.last().atMSecsSinceEpoch < beforeMSecsSinceEpoch)) {
-        QVector<QTimeZonePrivate::Data> posixTrans = getPosixTransitions(beforeMSecsSinceEpoch);
-        auto it = std::partition_point(posixTrans.cbegin(), posixTrans.cend(),
+    const QVector<QTzTransitionTime> &tranTimes = m_cachedData.m_tranTimes;
+    if (!m_cachedData.m_posixRule.isEmpty()
+        && (tranTimes.isEmpty() || tranTimes.last().atMSecsSinceEpoch < beforeMSecsSinceEpoch)) {
+        QVector<QTimeZonePrivate::Data> calculated;
+        int count;
+        const QTimeZonePrivate::Data *posixTrans = findPosixTransitions(beforeMSecsSinceEpoch, &count);
+        if (!posixTrans) {
+            calculated = getPosixTransitions(beforeMSecsSinceEpoch);
+            posixTrans = calculated.constData();
+            count = calculated.size();
+        }
+        auto it = std::partition_point(posixTrans, posixTrans + count,
                                        [beforeMSecsSinceEpoch] (const QTimeZonePrivate::Data &at) {
                                            return at.atMSecsSinceEpoch < beforeMSecsSinceEpoch;
                                        });
-        if (it > posixTrans.cbegin())
+        if (it > posixTrans)
             return *--it;
         // It fell between the last transition (if any) and the first of the POSIX rule:
-        return m_tranTimes.isEmpty() ? invalidData() : dataForTzTransition(m_tranTimes.last());
+        return tranTimes.isEmpty() ? invalidData() : dataForTzTransition(tranTimes.last());
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    auto last = std::partition_point(m_tranTimes.cbegin(), m_tranTimes.cend(),
+    auto last = std::partition_point(tranTimes.cbegin(), tranTimes.cend(),
                                      [beforeMSecsSinceEpoch] (const QTzTransitionTime &at) {
                                          return at.atMSecsSinceEpoch < beforeMSecsSinceEpoch;
                                      });
-    return last > m_tranTimes.cbegin() ? dataForTzTransition(*--last) : invalidData();
+    return last > tranTimes.cbegin() ? dataForTzTransition(*--last) : invalidData();
 }
 
 static long getSymloopMax()
@@ -1148,9 +1321,7 @@ bool QTzTimeZonePrivate::isTimeZoneIdAvailable(const QByteArray &ianaId) const
 
 QList<QByteArray> QTzTimeZonePrivate::availableTimeZoneIds() const
 {
-    QList<QByteArray> result = tzZones->keys();
-    std::sort(result.begin(), result.end());
-    return result;
+    return *tzZoneIds();
 }
 
 QList<QByteArray> QTzTimeZonePrivate::availableTimeZoneIds(QLocale::Country country) const
@@ -41,6 +41,7 @@
 
 #include "qunicodetables_p.h"
 #include "qvarlengtharray.h"
+#include "qsimd_p.h"
 
 #include "qharfbuzz_p.h"
 
@@ -52,6 +53,99 @@ Q_AUTOTEST_EXPORT int qt_initcharattributes_default_algorithm_only = 0;
 
 namespace QUnicodeTools {
 
+// -----------------------------------------------------------------------------------------------------
+//
+// Fast paths for runs of common characters.
+//
+// Most text is made of long runs of ASCII letters and CJK ideographs, whose break classes are
+// known up front: ASCII letters are ALetter/AL, digits are Numeric/NU and the ideographs of the
+// CJK Unified Ideographs block (as assigned in Unicode 1.1) are Other/Any for grapheme and word
+// breaks and ID for line breaks. Once the state machines below have reached a state in which such
+// a run cannot change anything but the attributes of its own characters, the run is measured with
+// a vectorized scan and its attributes are set in bulk instead of doing per-character lookups.
+//
+// -----------------------------------------------------------------------------------------------------
+
+namespace FastPath {
+
+#ifdef __SSE2__
+static inline __m128i inRange(__m128i data, ushort from, ushort to)
+{
+    // (c - from) <= (to - from), unsigned
+    const __m128i offset = _mm_sub_epi16(data, _mm_set1_epi16(short(from)));
+    const __m128i excess = _mm_subs_epu16(offset, _mm_set1_epi16(short(to - from)));
+    return _mm_cmpeq_epi16(excess, _mm_setzero_si128());
+}
+#endif
+
+static inline bool inRange(uint c, ushort from, ushort to)
+{
+    return c - from <= uint(to - from);
+}
+
+struct Ideograph
+{
+    enum : ushort { First = 0x4E00, Last = 0x9FA5 };
+    static bool matches(uint c) { return inRange(c, First, Last); }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data) { return inRange(data, First, Last); }
+#endif
+};
+
+struct AsciiLetter
+{
+    static bool matches(uint c) { return inRange(c | 0x20, 'a', 'z'); }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data) { return inRange(_mm_or_si128(data, _mm_set1_epi16(0x20)), 'a', 'z'); }
+#endif
+};
+
+struct AsciiLetterOrDigit
+{
+    static bool matches(uint c) { return AsciiLetter::matches(c) || inRange(c, '0', '9'); }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data) { return _mm_or_si128(AsciiLetter::matches(data), inRange(data, '0', '9')); }
+#endif
+};
+
+// printable ASCII and ideographs: grapheme break class Any
+struct PrintableOrIdeograph
+{
+    static bool matches(uint c) { return inRange(c, 0x20, 0x7e) || Ideograph::matches(c); }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data) { return _mm_or_si128(inRange(data, 0x20, 0x7e), Ideograph::matches(data)); }
+#endif
+};
+
+// the above, without the space
+struct GraphicOrIdeograph
+{
+    static bool matches(uint c) { return inRange(c, 0x21, 0x7e) || Ideograph::matches(c); }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data) { return _mm_or_si128(inRange(data, 0x21, 0x7e), Ideograph::matches(data)); }
+#endif
+};
+
+// Returns the index of the first character at or after \a from that doesn't match \a Class
+template <typename Class>
+static quint32 runEnd(const ushort *string, quint32 from, quint32 len)
+{
+    quint32 i = from;
+#ifdef __SSE2__
+    for ( ; i + 8 <= len; i += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(string + i));
+        const uint mask = ~uint(_mm_movemask_epi8(Class::matches(data))) & 0xffff;
+        if (mask)
+            return i + qCountTrailingZeroBits(mask) / 2;
+    }
+#endif
+    while (i != len && Class::matches(string[i]))
+        ++i;
+    return i;
+}
+
+} // namespace FastPath
+
 // -----------------------------------------------------------------------------------------------------
 //
 // The text boundaries determination algorithm.
@@ -103,6 +197,19 @@ static void getGraphemeBreaks(const ushort *string, quint32 len, QCharAttributes
     QUnicodeTables::GraphemeBreakClass lcls = QUnicodeTables::GraphemeBreak_LF; // to meet GB1
     GB::State state = GB::Break; // only required to track some of the rules
     for (quint32 i = 0; i != len; ++i) {
+        if (FastPath::PrintableOrIdeograph::matches(string[i])) {
+            // Any: always a boundary, unless it follows a Prepend (GB9b)
+            const quint32 end = FastPath::runEnd<FastPath::PrintableOrIdeograph>(string, i + 1, len);
+            if (lcls != QUnicodeTables::GraphemeBreak_Prepend)
+                attributes[i].graphemeBoundary = true;
+            for (quint32 j = i + 1; j != end; ++j)
+                attributes[j].graphemeBoundary = true;
+            lcls = QUnicodeTables::GraphemeBreak_Any;
+            state = GB::Break;
+            i = end - 1;
+            continue;
+        }
+
         quint32 pos = i;
         uint ucs4 = string[i];
         if (QChar::isHighSurrogate(ucs4) && i + 1 != len) {
@@ -199,6 +306,27 @@ static void getWordBreaks(const ushort *string, quint32 len, QCharAttributes *at
 
     QUnicodeTables::WordBreakClass cls = QUnicodeTables::WordBreak_LF; // to meet WB1
     for (quint32 i = 0; i != len; ++i) {
+        if ((cls == QUnicodeTables::WordBreak_ALetter || cls == QUnicodeTables::WordBreak_Numeric)
+                && FastPath::AsciiLetterOrDigit::matches(string[i])) {
+            // WB5, WB8, WB9, WB10: no break inside a run of letters and digits
+            i = FastPath::runEnd<FastPath::AsciiLetterOrDigit>(string, i + 1, len) - 1;
+            cls = FastPath::AsciiLetter::matches(string[i]) ? QUnicodeTables::WordBreak_ALetter
+                                                            : QUnicodeTables::WordBreak_Numeric;
+            continue;
+        }
+        if (FastPath::Ideograph::matches(string[i])) {
+            // WB999: every ideograph is a word of its own
+            const quint32 end = FastPath::runEnd<FastPath::Ideograph>(string, i + 1, len);
+            if (currentWordType != WordTypeNone)
+                attributes[i].wordEnd = true;
+            for (quint32 j = i; j != end; ++j)
+                attributes[j].wordBreak = true;
+            currentWordType = WordTypeNone;
+            cls = QUnicodeTables::WordBreak_Any;
+            i = end - 1;
+            continue;
+        }
+
         quint32 pos = i;
         uint ucs4 = string[i];
         if (QChar::isHighSurrogate(ucs4) && i + 1 != len) {
@@ -550,6 +678,22 @@ static void getLineBreaks(const ushort *string, quint32 len, QCharAttributes *at
     QUnicodeTables::LineBreakClass lcls = QUnicodeTables::LineBreak_LF; // to meet LB10
     QUnicodeTables::LineBreakClass cls = lcls;
     for (quint32 i = 0; i != len; ++i) {
+        if (cls == lcls && nelast == LB::NS::XX) {
+            if (cls == QUnicodeTables::LineBreak_AL && FastPath::AsciiLetter::matches(string[i])) {
+                // AL x AL
+                i = FastPath::runEnd<FastPath::AsciiLetter>(string, i + 1, len) - 1;
+                continue;
+            }
+            if (cls == QUnicodeTables::LineBreak_ID && FastPath::Ideograph::matches(string[i])) {
+                // ID / ID
+                const quint32 end = FastPath::runEnd<FastPath::Ideograph>(string, i + 1, len);
+                for (quint32 j = i; j != end; ++j)
+                    attributes[j].lineBreak = true;
+                i = end - 1;
+                continue;
+            }
+        }
+
         quint32 pos = i;
         uint ucs4 = string[i];
         if (QChar::isHighSurrogate(ucs4) && i + 1 != len) {
@@ -684,6 +828,11 @@ static void getLineBreaks(const ushort *string, quint32 len, QCharAttributes *at
 static void getWhiteSpaces(const ushort *string, quint32 len, QCharAttributes *attributes)
 {
     for (quint32 i = 0; i != len; ++i) {
+        if (FastPath::GraphicOrIdeograph::matches(string[i])) {
+            i = FastPath::runEnd<FastPath::GraphicOrIdeograph>(string, i + 1, len) - 1;
+            continue;
+        }
+
         uint ucs4 = string[i];
         if (QChar::isHighSurrogate(ucs4) && i + 1 != len) {
             ushort low = string[i + 1];
@@ -23,6 +23,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash_p.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -54,6 +55,7 @@ HEADERS +=  \
         tools/qsharedpointer.h \
         tools/qsharedpointer_impl.h \
         tools/qset.h \
+        tools/qshardedcache_p.h \
         tools/qsimd_p.h \
         tools/qsize.h \
         tools/qstack.h \
@@ -183,7 +185,8 @@ qtConfig(regularexpression) {
     QMAKE_USE_PRIVATE += pcre2
 
     HEADERS += \
-        tools/qregularexpression.h
+        tools/qregularexpression.h \
+        tools/qregularexpression_p.h
     SOURCES += tools/qregularexpression.cpp
 }
 
@@ -66,6 +66,7 @@
 #include <qpa/qplatformtheme.h>
 #include <qpa/qplatformintegration.h>
 
+#include <private/qfont_p.h>
 #include <private/qfontengine_p.h>
 #include <private/qpaintengine_p.h>
 #include <private/qemulationpaintengine_p.h>
@@ -7601,6 +7602,108 @@ QPaintDevice *QPainter::redirected(const QPaintDevice *device, QPoint *offset)
     return 0;
 }
 
+namespace {
+struct QTextLayoutCacheKey
+{
+    QString text;
+    QVector<int> underlines; // positions of the mnemonic underlines in text
+    QFont font;
+    int dpi;
+    int flags;
+    Qt::LayoutDirection direction;
+    int tabStops;
+    qreal lineWidth;
+    qreal maxHeight;
+
+    bool operator==(const QTextLayoutCacheKey &other) const
+    {
+        return flags == other.flags && direction == other.direction && dpi == other.dpi
+                && tabStops == other.tabStops && lineWidth == other.lineWidth
+                && maxHeight == other.maxHeight && text == other.text
+                && underlines == other.underlines && font == other.font;
+    }
+};
+
+uint qHash(const QTextLayoutCacheKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.text);
+    seed = hash(seed, key.underlines);
+    seed = hash(seed, key.font);
+    seed = hash(seed, key.flags);
+    seed = hash(seed, key.lineWidth);
+    return seed;
+}
+
+struct QTextLayoutCacheEntry
+{
+    QTextLayoutCacheEntry(const QString &text, const QFont &font)
+        : layout(text, font), width(0), height(0)
+    { }
+
+    QTextLayout layout;
+    qreal width;
+    qreal height;
+
+    int cost() const
+    {
+        const QTextEngine *engine = layout.engine();
+        int cost = int(sizeof(QTextLayoutCacheEntry) + sizeof(QTextEngine))
+                + engine->layoutData->string.size() * int(sizeof(QChar))
+                + engine->layoutData->allocated * int(sizeof(void *))
+                + engine->layoutData->items.size() * int(sizeof(QScriptItem))
+                + engine->lines.size() * int(sizeof(QScriptLine));
+        return cost;
+    }
+};
+
+typedef QSharedPointer<QTextLayoutCacheEntry> QTextLayoutCacheEntryPointer;
+
+struct QTextLayoutCache : QShardedCache<QTextLayoutCacheKey, QTextLayoutCacheEntryPointer>
+{
+    QTextLayoutCache()
+        : QShardedCache(maxCostFromEnvironment("QT_TEXT_LAYOUT_CACHE_SIZE", 0))
+    { }
+
+    // Returns the cache if it is enabled and may be used by the calling thread.
+    // Cached layouts keep decoration state while being drawn, so they are not
+    // shared between threads; all the painting of views happens on the main thread.
+    static QTextLayoutCache *instance();
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QTextLayoutCache, qt_textLayoutCache)
+
+QTextLayoutCache *QTextLayoutCache::instance()
+{
+    QTextLayoutCache *cache = qt_textLayoutCache();
+    if (!cache || !cache->isEnabled())
+        return 0;
+    if (QThread::currentThread() != QCoreApplicationPrivate::theMainThread.load())
+        return 0;
+    return cache;
+}
+
+void qt_setTextLayoutCacheLimit(int maxCost)
+{
+    if (QTextLayoutCache *cache = qt_textLayoutCache())
+        cache->setMaxCost(maxCost);
+}
+
+QTextLayoutCacheStatistics qt_textLayoutCacheStatistics()
+{
+    if (QTextLayoutCache *cache = qt_textLayoutCache())
+        return cache->statistics();
+    QTextLayoutCacheStatistics statistics = { 0, 0, 0, 0, 0 };
+    return statistics;
+}
+
+void qt_clearTextLayoutCache()
+{
+    if (QTextLayoutCache *cache = qt_textLayoutCache())
+        cache->clear();
+}
+
 void qt_format_text(const QFont &fnt, const QRectF &_r,
                     int tf, const QString& str, QRectF *brect,
                     int tabstops, int *ta, int tabarraylen,
@@ -7726,45 +7829,85 @@ start_lengthVariant:
     qreal width = 0;
 
     QString finalText = text.mid(old_offset, length);
-    QStackTextEngine engine(finalText, fnt);
-    if (option) {
-        engine.option = *option;
+
+    qreal lineWidth = 0x01000000;
+    if (wordwrap || (tf & Qt::TextJustificationForced))
+        lineWidth = qMax<qreal>(0, r.width());
+    const qreal maxHeight = (!dontclip && !brect) ? r.height() : qInf();
+
+    // Only the plain drawText() and boundingRect() calls are cached; the layout
+    // depends on nothing but the key then.
+    QTextLayoutCache *layoutCache = 0;
+    if (painter && !option && !ta && !finalText.isEmpty())
+        layoutCache = QTextLayoutCache::instance();
+    QTextLayoutCacheKey cacheKey;
+    QTextLayoutCacheEntryPointer cacheEntry;
+    bool needsLayout = true;
+    if (layoutCache) {
+        cacheKey.text = finalText;
+        cacheKey.underlines.reserve(underlineFormats.size());
+        for (const QTextLayout::FormatRange &range : qAsConst(underlineFormats))
+            cacheKey.underlines.append(range.start);
+        cacheKey.font = fnt;
+        cacheKey.dpi = QFontPrivate::get(fnt)->dpi;
+        cacheKey.flags = tf;
+        cacheKey.direction = layout_direction;
+        cacheKey.tabStops = tabstops;
+        cacheKey.lineWidth = lineWidth;
+        cacheKey.maxHeight = maxHeight;
+        cacheEntry = layoutCache->find(cacheKey);
+        if (cacheEntry)
+            needsLayout = false;
+        else
+            cacheEntry = QTextLayoutCacheEntryPointer::create(finalText, fnt);
     }
 
-    if (engine.option.tabStopDistance() < 0 && tabstops > 0)
-        engine.option.setTabStopDistance(tabstops);
+    QStackTextEngine stackEngine(cacheEntry ? QString() : finalText, fnt);
+    QTextLayout stackLayout(&stackEngine);
+    QTextLayout &textLayout = cacheEntry ? cacheEntry->layout : stackLayout;
 
-    if (engine.option.tabs().isEmpty() && ta) {
-        QList<qreal> tabs;
-        tabs.reserve(tabarraylen);
-        for (int i = 0; i < tabarraylen; i++)
-            tabs.append(qreal(ta[i]));
-        engine.option.setTabArray(tabs);
-    }
+    if (needsLayout) {
+        QTextEngine &engine = *textLayout.engine();
+        if (option) {
+            engine.option = *option;
+        }
 
-    engine.option.setTextDirection(layout_direction);
-    if (tf & Qt::AlignJustify)
-        engine.option.setAlignment(Qt::AlignJustify);
-    else
-        engine.option.setAlignment(Qt::AlignLeft); // do not do alignment twice
+        if (engine.option.tabStopDistance() < 0 && tabstops > 0)
+            engine.option.setTabStopDistance(tabstops);
 
-    if (!option && (tf & Qt::TextWrapAnywhere))
-        engine.option.setWrapMode(QTextOption::WrapAnywhere);
+        if (engine.option.tabs().isEmpty() && ta) {
+            QList<qreal> tabs;
+            tabs.reserve(tabarraylen);
+            for (int i = 0; i < tabarraylen; i++)
+                tabs.append(qreal(ta[i]));
+            engine.option.setTabArray(tabs);
+        }
 
-    if (tf & Qt::TextJustificationForced)
-        engine.forceJustification = true;
-    QTextLayout textLayout(&engine);
-    textLayout.setCacheEnabled(true);
-    textLayout.setFormats(underlineFormats);
+        engine.option.setTextDirection(layout_direction);
+        if (tf & Qt::AlignJustify)
+            engine.option.setAlignment(Qt::AlignJustify);
+        else
+            engine.option.setAlignment(Qt::AlignLeft); // do not do alignment twice
+
+        if (!option && (tf & Qt::TextWrapAnywhere))
+            engine.option.setWrapMode(QTextOption::WrapAnywhere);
+
+        if (tf & Qt::TextJustificationForced)
+            engine.forceJustification = true;
+        textLayout.setCacheEnabled(true);
+        textLayout.setFormats(underlineFormats);
+    }
 
     if (finalText.isEmpty()) {
         height = fm.height();
         width = 0;
         tf |= Qt::TextDontPrint;
+    } else if (!needsLayout) {
+        if (!wordwrap)
+            tf |= Qt::TextIncludeTrailingSpaces;
+        width = cacheEntry->width;
+        height = cacheEntry->height;
     } else {
-        qreal lineWidth = 0x01000000;
-        if (wordwrap || (tf & Qt::TextJustificationForced))
-            lineWidth = qMax<qreal>(0, r.width());
         if(!wordwrap)
             tf |= Qt::TextIncludeTrailingSpaces;
         textLayout.beginLayout();
@@ -7785,10 +7928,16 @@ start_lengthVariant:
             l.setPosition(QPointF(0., height));
             height += textLayout.engine()->lines[l.lineNumber()].height().toReal();
             width = qMax(width, l.naturalTextWidth());
-            if (!dontclip && !brect && height >= r.height())
+            if (height >= maxHeight)
                 break;
         }
         textLayout.endLayout();
+
+        if (layoutCache) {
+            cacheEntry->width = width;
+            cacheEntry->height = height;
+            layoutCache->insert(cacheKey, cacheEntry, cacheEntry->cost());
+        }
     }
 
     qreal yoff = 0;
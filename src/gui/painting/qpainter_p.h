@@ -62,6 +62,7 @@
 #include "QtGui/qpaintengine.h"
 
 #include <private/qpen_p.h>
+#include <QtCore/private/qshardedcache_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -288,6 +289,15 @@ Q_GUI_EXPORT void qt_draw_helper(QPainterPrivate *p, const QPainterPath &path, Q
 
 QString qt_generate_brush_key(const QBrush &brush);
 
+typedef QShardedCacheStatistics QTextLayoutCacheStatistics;
+
+// Cache of the layouts made by QPainter::drawText() and boundingRect() for a
+// rectangle and flags. It is off unless given a size in bytes, either here or
+// in KiB through QT_TEXT_LAYOUT_CACHE_SIZE, and is only used on the main thread.
+Q_GUI_EXPORT void qt_setTextLayoutCacheLimit(int maxCost);
+Q_GUI_EXPORT QTextLayoutCacheStatistics qt_textLayoutCacheStatistics();
+Q_GUI_EXPORT void qt_clearTextLayoutCache();
+
 inline bool qt_pen_is_cosmetic(const QPen &pen, QPainter::RenderHints hints)
 {
     return pen.isCosmetic() || (const_cast<QPen &>(pen).data_ptr()->defaultWidth && (hints & QPainter::Qt4CompatiblePainting));
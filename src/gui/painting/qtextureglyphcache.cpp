@@ -38,6 +38,14 @@
 ****************************************************************************/
 
 #include <qmath.h>
+#if QT_CONFIG(thread)
+#include <qrunnable.h>
+#include <qscopedpointer.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+
+#include <vector>
+#endif
 
 #include "qtextureglyphcache_p.h"
 #include "private/qfontengine_p.h"
@@ -47,6 +55,10 @@ QT_BEGIN_NAMESPACE
 
 // #define CACHE_DEBUG
 
+// Below this many glyphs per worker, rasterizing on the painting thread is cheaper
+// than setting up a per-thread font engine.
+static const int MinGlyphsPerRasterizationTask = 32;
+
 // out-of-line to avoid vtable duplication, breaking e.g. RTTI
 QTextureGlyphCache::~QTextureGlyphCache()
 {
@@ -272,6 +284,8 @@ void QTextureGlyphCache::fillInPendingGlyphs()
             resizeCache(qNextPowerOfTwo(requiredWidth - 1), qNextPowerOfTwo(requiredHeight - 1));
     }
 
+    rasterizePendingGlyphs();
+
     beginFillTexture();
     {
         QHash<GlyphAndSubPixelPosition, Coord>::iterator iter = m_pendingGlyphs.begin();
@@ -285,17 +299,117 @@ void QTextureGlyphCache::fillInPendingGlyphs()
     endFillTexture();
 
     m_pendingGlyphs.clear();
+    m_rasterizedGlyphs.clear();
+}
+
+#if QT_CONFIG(thread)
+namespace {
+class QGlyphRasterizationTask : public QRunnable
+{
+public:
+    QGlyphRasterizationTask(const QTextureGlyphCache *cache, QFontEngine *fontEngine,
+                            const QTextureGlyphCache::GlyphAndSubPixelPosition *keys, int count,
+                            QImage *images, QSemaphore *done)
+        : m_cache(cache), m_fontEngine(fontEngine), m_keys(keys), m_count(count),
+          m_images(images), m_done(done)
+    { }
+
+    void run() override
+    {
+        // The clone owns a FreeType face (or equivalent) of this thread, so it can
+        // render without contending for the face of the painting thread's engine.
+        QScopedPointer<QFontEngine> engine(m_fontEngine->cloneForRasterization());
+        if (engine) {
+            for (int i = 0; i < m_count; ++i)
+                m_images[i] = m_cache->textureMapForGlyph(engine.data(), m_keys[i].glyph, m_keys[i].subPixelPosition);
+        }
+        m_done->release();
+    }
+
+private:
+    const QTextureGlyphCache *m_cache;
+    QFontEngine *m_fontEngine;
+    const QTextureGlyphCache::GlyphAndSubPixelPosition *m_keys;
+    int m_count;
+    QImage *m_images;
+    QSemaphore *m_done;
+};
+} // unnamed namespace
+#endif
+
+/*
+    Rasterizes the pending glyphs up front, splitting them across the global thread
+    pool when the font engine supports it, so that a large batch of new glyphs (e.g.
+    the first paint of a CJK page) is not rendered one by one on the painting thread.
+    fillTexture() implementations pick the results up through textureMapForGlyph();
+    glyphs that could not be rendered here are rendered there as before.
+*/
+void QTextureGlyphCache::rasterizePendingGlyphs()
+{
+#if QT_CONFIG(thread)
+    if (!m_current_fontengine || !m_current_fontengine->supportsConcurrentRasterization())
+        return;
+
+    const int glyphCount = m_pendingGlyphs.size();
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int taskCount = qMin(pool->maxThreadCount() + 1, glyphCount / MinGlyphsPerRasterizationTask);
+    if (taskCount < 2)
+        return;
+
+    std::vector<GlyphAndSubPixelPosition> keys;
+    keys.reserve(glyphCount);
+    for (auto it = m_pendingGlyphs.cbegin(), end = m_pendingGlyphs.cend(); it != end; ++it)
+        keys.push_back(it.key());
+    QVector<QImage> images(glyphCount);
+
+    // The painting thread renders the first slice with its own engine while the
+    // others are rendered on the pool. If the pool is busy the slice is rendered
+    // inline rather than queued, so we never wait on unrelated work.
+    const int glyphsPerTask = (glyphCount + taskCount - 1) / taskCount;
+    QSemaphore done;
+    int started = 0;
+    for (int from = glyphsPerTask; from < glyphCount; from += glyphsPerTask) {
+        QGlyphRasterizationTask *task = new QGlyphRasterizationTask(this, m_current_fontengine,
+                                                                    keys.data() + from,
+                                                                    qMin(glyphsPerTask, glyphCount - from),
+                                                                    images.data() + from, &done);
+        if (!pool->tryStart(task)) {
+            task->run();
+            delete task;
+        }
+        ++started;
+    }
+    for (int i = 0; i < glyphsPerTask; ++i)
+        images[i] = textureMapForGlyph(m_current_fontengine, keys.at(i).glyph, keys.at(i).subPixelPosition);
+    done.acquire(started);
+
+    m_rasterizedGlyphs.reserve(glyphCount);
+    for (int i = 0; i < glyphCount; ++i) {
+        if (!images.at(i).isNull())
+            m_rasterizedGlyphs.insert(keys.at(i), images.at(i));
+    }
+#endif
 }
 
 QImage QTextureGlyphCache::textureMapForGlyph(glyph_t g, QFixed subPixelPosition) const
+{
+    if (!m_rasterizedGlyphs.isEmpty()) {
+        const auto it = m_rasterizedGlyphs.constFind(GlyphAndSubPixelPosition(g, subPixelPosition));
+        if (it != m_rasterizedGlyphs.constEnd())
+            return it.value();
+    }
+    return textureMapForGlyph(m_current_fontengine, g, subPixelPosition);
+}
+
+QImage QTextureGlyphCache::textureMapForGlyph(QFontEngine *fontEngine, glyph_t g, QFixed subPixelPosition) const
 {
     switch (m_format) {
     case QFontEngine::Format_A32:
-        return m_current_fontengine->alphaRGBMapForGlyph(g, subPixelPosition, m_transform);
+        return fontEngine->alphaRGBMapForGlyph(g, subPixelPosition, m_transform);
     case QFontEngine::Format_ARGB:
-        return m_current_fontengine->bitmapForGlyph(g, subPixelPosition, m_transform, color());
+        return fontEngine->bitmapForGlyph(g, subPixelPosition, m_transform, color());
     default:
-        return m_current_fontengine->alphaMapForGlyph(g, subPixelPosition, m_transform);
+        return fontEngine->alphaMapForGlyph(g, subPixelPosition, m_transform);
     }
 }
 
@@ -142,12 +142,15 @@ public:
     virtual int maxTextureHeight() const { return -1; }
 
     QImage textureMapForGlyph(glyph_t g, QFixed subPixelPosition) const;
+    QImage textureMapForGlyph(QFontEngine *fontEngine, glyph_t g, QFixed subPixelPosition) const;
 
 protected:
     int calculateSubPixelPositionCount(glyph_t) const;
+    void rasterizePendingGlyphs();
 
     QFontEngine *m_current_fontengine;
     QHash<GlyphAndSubPixelPosition, Coord> m_pendingGlyphs;
+    QHash<GlyphAndSubPixelPosition, QImage> m_rasterizedGlyphs;
 
     int m_w; // image width
     int m_h; // image height
@@ -263,6 +263,11 @@ public:
 
     virtual QFontEngine *cloneWithSize(qreal /*pixelSize*/) const { return 0; }
 
+    // Engines that can rasterize glyphs on a worker thread return an engine that
+    // owns its own font face; it must be created, used and deleted on one thread.
+    virtual bool supportsConcurrentRasterization() const { return false; }
+    virtual QFontEngine *cloneForRasterization() const { return 0; }
+
     virtual Qt::HANDLE handle() const;
 
     void *harfbuzzFont() const;
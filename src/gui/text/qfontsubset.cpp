@@ -38,8 +38,10 @@
 ****************************************************************************/
 
 #include "qfontsubset_p.h"
+#include <qcache.h>
 #include <qdebug.h>
 #include <qendian.h>
+#include <qmutex.h>
 #include <qpainterpath.h>
 #include "private/qpdf_p.h"
 
@@ -421,6 +423,40 @@ struct QTtfGlyph {
 };
 Q_DECLARE_TYPEINFO(QTtfGlyph, Q_MOVABLE_TYPE);
 
+/*
+  Converting glyph outlines into TrueType glyph data is most of the cost of toTruetype(), and
+  the result only depends on the font face. It is therefore kept in a process-wide cache shared
+  by all subsets of a face, across documents and QPdfWriter instances, along with the face's
+  'name' and 'OS/2' tables. The cache is bounded by the size of the glyph data it holds.
+*/
+struct QTtfFaceData
+{
+    QTtfFaceData() : hasTables(false), cost(0) {}
+
+    QHash<glyph_t, QTtfGlyph> glyphs;
+    QByteArray nameTable;
+    QByteArray os2Table;
+    bool hasTables;
+    int cost;
+};
+
+struct QTtfFaceCache
+{
+    enum { MaxCost = 16 * 1024 * 1024 };
+
+    QTtfFaceCache() : faces(MaxCost) {}
+
+    QMutex mutex;
+    QCache<QFontEngine::FaceId, QTtfFaceData> faces;
+};
+
+Q_GLOBAL_STATIC(QTtfFaceCache, qt_ttfFaceCache)
+
+static inline int glyphCost(const QTtfGlyph &glyph)
+{
+    return int(sizeof(QTtfGlyph)) + glyph.data.size();
+}
+
 static QTtfGlyph generateGlyph(int index, const QPainterPath &path, qreal advance, qreal lsb, qreal ppem);
 // generates glyf, loca and hmtx
 static QVector<QTtfTable> generateGlyphTables(qttf_font_tables &tables, const QVector<QTtfGlyph> &_glyphs);
@@ -1014,14 +1050,20 @@ static QVector<QTtfTable> generateGlyphTables(qttf_font_tables &tables, const QV
     int nGlyphs = tables.maxp.numGlyphs;
 
     int glyf_size = 0;
-    for (int i = 0; i < glyphs.size(); ++i)
+    int glyf_data_size = 0;
+    for (int i = 0; i < glyphs.size(); ++i) {
         glyf_size += (glyphs.at(i).data.size() + 3) & ~3;
+        glyf_data_size += (glyphs.at(i).data.size() + 1) & ~1;
+    }
 
     tables.head.indexToLocFormat = glyf_size < max_size_small ? 0 : 1;
     tables.hhea.numberOfHMetrics = nGlyphs;
 
+    // glyph data is padded to 2 bytes, as required by the short loca format
     QTtfTable glyf;
     glyf.tag = MAKE_TAG('g', 'l', 'y', 'f');
+    glyf.data.resize(glyf_data_size);
+    char *glyf_data = glyf.data.data();
 
     QTtfTable loca;
     loca.tag = MAKE_TAG('l', 'o', 'c', 'a');
@@ -1034,17 +1076,20 @@ static QVector<QTtfTable> generateGlyphTables(qttf_font_tables &tables, const QV
     QTtfStream hs(hmtx.data);
 
     int pos = 0;
+    int glyf_pos = 0;
     for (int i = 0; i < nGlyphs; ++i) {
-        int gpos = glyf.data.size();
+        int gpos = glyf_pos;
         quint16 advance = 0;
         qint16 lsb = 0;
 
         if (glyphs[pos].index == i) {
             // emit glyph
 //             qDebug("emitting glyph %d: size=%d", i, glyphs.at(i).data.size());
-            glyf.data += glyphs.at(pos).data;
-            while (glyf.data.size() & 1)
-                glyf.data.append('\0');
+            const QByteArray &data = glyphs.at(pos).data;
+            memcpy(glyf_data + glyf_pos, data.constData(), data.size());
+            glyf_pos += data.size();
+            if (glyf_pos & 1)
+                glyf_data[glyf_pos++] = '\0';
             advance = glyphs.at(pos).advanceWidth;
             lsb = glyphs.at(pos).lsb;
             ++pos;
@@ -1067,6 +1112,7 @@ static QVector<QTtfTable> generateGlyphTables(qttf_font_tables &tables, const QV
         ls << quint32(glyf.data.size());
     }
 
+    Q_ASSERT(glyf.data.size() == glyf_pos);
     Q_ASSERT(loca.data.size() == ls.offset());
     Q_ASSERT(hmtx.data.size() == hs.offset());
 
@@ -1092,7 +1138,10 @@ static QByteArray bindFont(const QVector<QTtfTable>& _tables)
     QByteArray font;
     const int header_size = sizeof(qint32) + 4*sizeof(quint16);
     const int directory_size = 4*sizeof(quint32)*tables.size();
-    font.resize(header_size + directory_size);
+    int font_size = header_size + directory_size;
+    for (int i = 0; i < tables.size(); ++i)
+        font_size += (tables.at(i).data.size() + 3) & ~3;
+    font.resize(font_size);
 
     int log2 = 0;
     int pow = 1;
@@ -1140,12 +1189,15 @@ static QByteArray bindFont(const QVector<QTtfTable>& _tables)
             //qDebug() << "table " << TAG(t.tag) << "has size " << t.data.size() << "stream at " << f.offset();
         }
     }
+    char *font_data = font.data() + header_size + directory_size;
     for (int i = 0; i < tables.size(); ++i) {
         const QByteArray &t = tables.at(i).data;
-        font += t;
-        int s = t.size();
-        while (s & 3) { font += '\0'; ++s; }
+        memcpy(font_data, t.constData(), t.size());
+        font_data += t.size();
+        for (int s = t.size(); s & 3; ++s)
+            *font_data++ = '\0';
     }
+    Q_ASSERT(font_data == font.constData() + font_size);
 
     if (!head_offset) {
         qWarning("QFontSubset: Font misses 'head' table");
@@ -1215,18 +1267,39 @@ QByteArray QFontSubset::toTruetype() const
     QVector<QTtfGlyph> glyphs;
     glyphs.reserve(numGlyphs);
 
+    // Faces without an identity can't be shared, and placeholder glyphs are cheap to generate.
+    const QFontEngine::FaceId faceId = fontEngine->faceId();
+    const bool useFaceCache = !noEmbed && (!faceId.filename.isEmpty() || !faceId.uuid.isEmpty());
+    QTtfFaceData cachedFace;
+    if (useFaceCache) {
+        QTtfFaceCache *cache = qt_ttfFaceCache();
+        QMutexLocker locker(&cache->mutex);
+        if (const QTtfFaceData *data = cache->faces.object(faceId))
+            cachedFace = *data;
+    }
+    QHash<glyph_t, QTtfGlyph> generatedGlyphs;
+
     uint sumAdvances = 0;
     for (int i = 0; i < numGlyphs; ++i) {
         glyph_t g = glyph_indices.at(i);
-        QPainterPath path;
-        glyph_metrics_t metric;
-        fontEngine->getUnscaledGlyph(g, &path, &metric);
-        if (noEmbed) {
-            path = QPainterPath();
-            if (g == 0)
-                path.addRect(QRectF(0, 0, 1000, 1000));
+        QTtfGlyph glyph;
+        const QHash<glyph_t, QTtfGlyph>::const_iterator cached = cachedFace.glyphs.constFind(g);
+        if (cached != cachedFace.glyphs.constEnd()) {
+            glyph = cached.value();
+            glyph.index = i;
+        } else {
+            QPainterPath path;
+            glyph_metrics_t metric;
+            fontEngine->getUnscaledGlyph(g, &path, &metric);
+            if (noEmbed) {
+                path = QPainterPath();
+                if (g == 0)
+                    path.addRect(QRectF(0, 0, 1000, 1000));
+            }
+            glyph = generateGlyph(i, path, metric.xoff.toReal(), metric.x.toReal(), properties.emSquare.toReal());
+            if (useFaceCache)
+                generatedGlyphs.insert(g, glyph);
         }
-        QTtfGlyph glyph = generateGlyph(i, path, metric.xoff.toReal(), metric.x.toReal(), properties.emSquare.toReal());
 
         font.head.xMin = qMin(font.head.xMin, glyph.xMin);
         font.head.xMax = qMax(font.head.xMax, glyph.xMax);
@@ -1252,9 +1325,43 @@ QByteArray QFontSubset::toTruetype() const
     tables.append(generateHhea(font.hhea));
     tables.append(generateMaxp(font.maxp));
     // name
+    if (useFaceCache && !cachedFace.hasTables) {
+        cachedFace.nameTable = fontEngine->getSfntTable(MAKE_TAG('n', 'a', 'm', 'e'));
+        cachedFace.os2Table = fontEngine->getSfntTable(MAKE_TAG('O', 'S', '/', '2'));
+    }
+    if (useFaceCache && (!cachedFace.hasTables || !generatedGlyphs.isEmpty())) {
+        QTtfFaceCache *cache = qt_ttfFaceCache();
+        QMutexLocker locker(&cache->mutex);
+        QTtfFaceData *data = cache->faces.take(faceId);
+        if (!data)
+            data = new QTtfFaceData;
+        if (!data->hasTables) {
+            data->nameTable = cachedFace.nameTable;
+            data->os2Table = cachedFace.os2Table;
+            data->hasTables = true;
+            data->cost += data->nameTable.size() + data->os2Table.size();
+        }
+        for (QHash<glyph_t, QTtfGlyph>::const_iterator it = generatedGlyphs.constBegin(); it != generatedGlyphs.constEnd(); ++it) {
+            if (!data->glyphs.contains(it.key())) {
+                data->glyphs.insert(it.key(), it.value());
+                data->cost += glyphCost(it.value());
+            }
+        }
+        if (data->cost > QTtfFaceCache::MaxCost) {
+            // keep the tables, start over with the glyphs of the current document
+            data->glyphs = generatedGlyphs;
+            data->cost = data->nameTable.size() + data->os2Table.size();
+            for (QHash<glyph_t, QTtfGlyph>::const_iterator it = generatedGlyphs.constBegin(); it != generatedGlyphs.constEnd(); ++it)
+                data->cost += glyphCost(it.value());
+        }
+        cache->faces.insert(faceId, data, data->cost);
+    }
+
     QTtfTable name_table;
     name_table.tag = MAKE_TAG('n', 'a', 'm', 'e');
-    if (!noEmbed)
+    if (useFaceCache)
+        name_table.data = cachedFace.nameTable;
+    else if (!noEmbed)
         name_table.data = fontEngine->getSfntTable(name_table.tag);
     if (name_table.data.isEmpty()) {
         qttf_name_table name;
@@ -1272,7 +1379,7 @@ QByteArray QFontSubset::toTruetype() const
     if (!noEmbed) {
         QTtfTable os2;
         os2.tag = MAKE_TAG('O', 'S', '/', '2');
-        os2.data = fontEngine->getSfntTable(os2.tag);
+        os2.data = useFaceCache ? cachedFace.os2Table : fontEngine->getSfntTable(os2.tag);
         if (!os2.data.isEmpty())
             tables.append(os2);
     }
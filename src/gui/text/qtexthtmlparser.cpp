@@ -573,6 +573,10 @@ void QTextHtmlParser::parse(const QString &text, const QTextDocument *_resourceP
     len = txt.length();
     textEditMode = false;
     resourceProvider = _resourceProvider;
+#ifndef QT_NO_CSSPARSER
+    inheritedDeclarationsPath.clear();
+    styleAttributeCache.clear();
+#endif
     parse();
     //dumpHtml();
 }
@@ -634,7 +638,11 @@ void QTextHtmlParser::parse()
         } else if (c == QLatin1Char('&')) {
             nodes.last().text += parseEntity();
         } else {
-            nodes.last().text += c;
+            // append the whole run of plain text up to the next markup at once
+            const int start = pos - 1;
+            while (pos < len && txt.at(pos) != QLatin1Char('<') && txt.at(pos) != QLatin1Char('&'))
+                ++pos;
+            nodes.last().text += txt.midRef(start, pos - start);
         }
     }
 }
@@ -663,6 +671,7 @@ void QTextHtmlParser::parseTag()
             sheet.origin = QCss::StyleSheetOrigin_Author;
             parser.parse(&sheet, Qt::CaseInsensitive);
             inlineStyleSheets.append(sheet);
+            inheritedDeclarationsPath.clear();
             resolveStyleSheetImports(sheet);
 #endif
         }
@@ -1443,18 +1452,6 @@ static void setWidthAttribute(QTextLength *width, const QString &valueStr)
     }
 }
 
-#ifndef QT_NO_CSSPARSER
-void QTextHtmlParserNode::parseStyleAttribute(const QString &value, const QTextDocument *resourceProvider)
-{
-    const QString css = QLatin1String("* {") + value + QLatin1Char('}');
-    QCss::Parser parser(css);
-    QCss::StyleSheet sheet;
-    parser.parse(&sheet, Qt::CaseInsensitive);
-    if (sheet.styleRules.count() != 1) return;
-    applyCssDeclarations(sheet.styleRules.at(0).declarations, resourceProvider);
-}
-#endif
-
 QStringList QTextHtmlParser::parseAttributes()
 {
     QStringList attrs;
@@ -1637,7 +1634,9 @@ void QTextHtmlParser::applyAttributes(const QStringList &attributes)
 
         if (key == QLatin1String("style")) {
 #ifndef QT_NO_CSSPARSER
-            node->parseStyleAttribute(value, resourceProvider);
+            const QVector<QCss::Declaration> decls = declarationsForStyleAttribute(value);
+            if (!decls.isEmpty())
+                node->applyCssDeclarations(decls, resourceProvider);
 #endif
         } else if (key == QLatin1String("align")) {
             value = std::move(value).toLower();
@@ -1819,6 +1818,7 @@ void QTextHtmlParser::importStyleSheet(const QString &href)
         QCss::StyleSheet sheet;
         parser.parse(&sheet, Qt::CaseInsensitive);
         externalStyleSheets.append(ExternalStyleSheet(href, sheet));
+        inheritedDeclarationsPath.clear();
         resolveStyleSheetImports(sheet);
     }
 }
@@ -2027,6 +2027,13 @@ QVector<QCss::Declaration> QTextHtmlParser::declarationsForNode(int node) const
     const char *extraPseudo = 0;
     if (nodes.at(node).id == Html_a && nodes.at(node).hasHref)
         extraPseudo = "link";
+    if (!extraPseudo) {
+        decls = inheritedDeclarations(selector, nodes.at(node).parent);
+        // Ensure that our own style is taken into consideration
+        decls += standardDeclarationForNode(nodes.at(node));
+        decls += selector.declarationsForNode(n);
+        return decls;
+    }
     // Ensure that our own style is taken into consideration
     decls = standardDeclarationForNode(nodes.at(node));
     decls += selector.declarationsForNode(n, extraPseudo);
@@ -2044,6 +2051,64 @@ QVector<QCss::Declaration> QTextHtmlParser::declarationsForNode(int node) const
     return decls;
 }
 
+// Returns the declarations that the children of \a node inherit from it and
+// its ancestors, in the order declarationsForNode() applies them. The result
+// for every node on the path to the most recently styled node is kept, so
+// that the selectors of an ancestor are matched once rather than once per
+// descendant.
+QVector<QCss::Declaration> QTextHtmlParser::inheritedDeclarations(QCss::StyleSelector &selector, int node) const
+{
+    QVarLengthArray<int, 32> missing;
+    int d = depth(node);
+    while (node) {
+        if (d <= inheritedDeclarationsPath.size() && inheritedDeclarationsPath.at(d - 1).node == node)
+            break;
+        missing.append(node);
+        node = at(node).parent;
+        --d;
+    }
+    inheritedDeclarationsPath.resize(d);
+
+    for (int i = missing.size() - 1; i >= 0; --i) {
+        InheritedDeclarations entry;
+        entry.node = missing.at(i);
+        if (!inheritedDeclarationsPath.isEmpty())
+            entry.declarations = inheritedDeclarationsPath.constLast().declarations;
+        QCss::StyleSelector::NodePtr n;
+        n.id = entry.node;
+        const QVector<QCss::Declaration> decls = selector.declarationsForNode(n);
+        for (int j = decls.size() - 1; j >= 0; --j) {
+            if (decls.at(j).d->inheritable)
+                entry.declarations.append(decls.at(j));
+        }
+        inheritedDeclarationsPath.append(entry);
+    }
+
+    if (inheritedDeclarationsPath.isEmpty())
+        return QVector<QCss::Declaration>();
+    return inheritedDeclarationsPath.constLast().declarations;
+}
+
+QVector<QCss::Declaration> QTextHtmlParser::declarationsForStyleAttribute(const QString &value)
+{
+    const auto it = styleAttributeCache.constFind(value);
+    if (it != styleAttributeCache.constEnd())
+        return it.value();
+
+    const QString css = QLatin1String("* {") + value + QLatin1Char('}');
+    QCss::Parser parser(css);
+    QCss::StyleSheet sheet;
+    parser.parse(&sheet, Qt::CaseInsensitive);
+    QVector<QCss::Declaration> decls;
+    if (sheet.styleRules.count() == 1)
+        decls = sheet.styleRules.at(0).declarations;
+
+    if (styleAttributeCache.size() >= 1024)
+        styleAttributeCache.clear();
+    styleAttributeCache.insert(value, decls);
+    return decls;
+}
+
 bool QTextHtmlParser::nodeIsChildOf(int i, QTextHTMLElements id) const
 {
     while (i) {
@@ -52,6 +52,7 @@
 //
 
 #include <QtGui/private/qtguiglobal_p.h>
+#include "QtCore/qhash.h"
 #include "QtCore/qvector.h"
 #include "QtGui/qbrush.h"
 #include "QtGui/qcolor.h"
@@ -242,8 +243,6 @@ struct QTextHtmlParserNode {
 
     bool isNestedList(const QTextHtmlParser *parser) const;
 
-    void parseStyleAttribute(const QString &value, const QTextDocument *resourceProvider);
-
 #if QT_CONFIG(cssparser)
     void applyCssDeclarations(const QVector<QCss::Declaration> &declarations, const QTextDocument *resourceProvider);
 
@@ -320,6 +319,8 @@ protected:
 
 #if QT_CONFIG(cssparser)
     QVector<QCss::Declaration> declarationsForNode(int node) const;
+    QVector<QCss::Declaration> inheritedDeclarations(QCss::StyleSelector &selector, int node) const;
+    QVector<QCss::Declaration> declarationsForStyleAttribute(const QString &value);
     void resolveStyleSheetImports(const QCss::StyleSheet &sheet);
     void importStyleSheet(const QString &href);
 
@@ -334,12 +335,25 @@ protected:
     friend class QTypeInfo<ExternalStyleSheet>;
     QVector<ExternalStyleSheet> externalStyleSheets;
     QVector<QCss::StyleSheet> inlineStyleSheets;
+
+    // declarations inherited by the children of each node on the path to the
+    // most recently styled node, indexed by depth - 1
+    struct InheritedDeclarations
+    {
+        int node;
+        QVector<QCss::Declaration> declarations;
+    };
+    friend class QTypeInfo<InheritedDeclarations>;
+    mutable QVector<InheritedDeclarations> inheritedDeclarationsPath;
+    // parsed style="..." attributes; documents tend to repeat the same few
+    QHash<QString, QVector<QCss::Declaration> > styleAttributeCache;
 #endif
 
     const QTextDocument *resourceProvider;
 };
 #if QT_CONFIG(cssparser)
 Q_DECLARE_TYPEINFO(QTextHtmlParser::ExternalStyleSheet, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(QTextHtmlParser::InheritedDeclarations, Q_MOVABLE_TYPE);
 #endif
 
 QT_END_NAMESPACE
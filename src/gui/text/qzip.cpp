@@ -43,16 +43,28 @@
 
 #include "qzipreader_p.h"
 #include "qzipwriter_p.h"
+#include <private/qbytearray_p.h>
+#include <private/qcompressiondevice_p.h>
 #include <qdatetime.h>
 #include <qendian.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qhash.h>
+#if QT_CONFIG(thread)
+#include <qatomic.h>
+#include <qrunnable.h>
+#include <qsemaphore.h>
+#include <qthread.h>
+#include <qthreadpool.h>
+#endif
 
 #include <zlib.h>
 
 // Zip standard version for archives handled by this API
 // (actually, the only basic support of this version is implemented but it is enough for now)
 #define ZIP_VERSION 20
+// Zip standard version needed for entries and archives using the zip64 extensions
+#define ZIP64_VERSION 45
 
 #if 0
 #define ZDEBUG qDebug
@@ -72,6 +84,11 @@ static inline ushort readUShort(const uchar *data)
     return (data[0]) + (data[1]<<8);
 }
 
+static inline quint64 readULongLong(const uchar *data)
+{
+    return quint64(readUInt(data)) | (quint64(readUInt(data + 4)) << 32);
+}
+
 static inline void writeUInt(uchar *data, uint i)
 {
     data[0] = i & 0xff;
@@ -86,6 +103,12 @@ static inline void writeUShort(uchar *data, ushort i)
     data[1] = (i>>8) & 0xff;
 }
 
+static inline void writeULongLong(uchar *data, quint64 i)
+{
+    writeUInt(data, uint(i));
+    writeUInt(data + 4, uint(i >> 32));
+}
+
 static inline void copyUInt(uchar *dest, const uchar *src)
 {
     dest[0] = src[0];
@@ -407,6 +430,30 @@ struct EndOfDirectory
 };
 Q_DECLARE_TYPEINFO(EndOfDirectory, Q_PRIMITIVE_TYPE);
 
+struct Zip64EndOfDirectory
+{
+    uchar signature[4]; // 0x06064b50
+    uchar record_size[8];
+    uchar version_made[2];
+    uchar version_needed[2];
+    uchar this_disk[4];
+    uchar start_of_directory_disk[4];
+    uchar num_dir_entries_this_disk[8];
+    uchar num_dir_entries[8];
+    uchar directory_size[8];
+    uchar dir_start_offset[8];
+};
+Q_DECLARE_TYPEINFO(Zip64EndOfDirectory, Q_PRIMITIVE_TYPE);
+
+struct Zip64EndOfDirectoryLocator
+{
+    uchar signature[4]; // 0x07064b50
+    uchar start_of_directory_disk[4];
+    uchar eod_offset[8];
+    uchar num_disks[4];
+};
+Q_DECLARE_TYPEINFO(Zip64EndOfDirectoryLocator, Q_PRIMITIVE_TYPE);
+
 struct FileHeader
 {
     CentralFileHeader h;
@@ -416,6 +463,95 @@ struct FileHeader
 };
 Q_DECLARE_TYPEINFO(FileHeader, Q_MOVABLE_TYPE);
 
+// the header ID of the zip64 extended information extra field
+static const ushort Zip64ExtraFieldId = 0x0001;
+
+/*
+    Returns the sizes of the entry described by \a header and the offset of its
+    local header, taking a zip64 extended information extra field into account.
+*/
+static void readEntryLocation(const FileHeader &header, quint64 *uncompressedSize,
+                              quint64 *compressedSize, quint64 *localHeaderOffset)
+{
+    *uncompressedSize = readUInt(header.h.uncompressed_size);
+    *compressedSize = readUInt(header.h.compressed_size);
+    *localHeaderOffset = readUInt(header.h.offset_local_header);
+    if (*uncompressedSize != 0xffffffff && *compressedSize != 0xffffffff
+            && *localHeaderOffset != 0xffffffff) {
+        return;
+    }
+
+    const uchar *extra = reinterpret_cast<const uchar *>(header.extra_field.constData());
+    const int extraLength = header.extra_field.size();
+    for (int pos = 0; pos + 4 <= extraLength; ) {
+        const ushort id = readUShort(extra + pos);
+        const int end = qMin(pos + 4 + readUShort(extra + pos + 2), extraLength);
+        if (id == Zip64ExtraFieldId) {
+            // only the values that overflowed in the header are present, in this order
+            int p = pos + 4;
+            for (quint64 *value : { uncompressedSize, compressedSize, localHeaderOffset }) {
+                if (*value != 0xffffffff)
+                    continue;
+                if (p + 8 > end)
+                    break;
+                *value = readULongLong(extra + p);
+                p += 8;
+            }
+            return;
+        }
+        pos = end;
+    }
+}
+
+/*
+    Stores the sizes of the entry described by \a header and the offset of its
+    local header, moving the values that do not fit into 32 bits into a zip64
+    extended information extra field.
+*/
+static void writeEntryLocation(FileHeader *header, quint64 uncompressedSize,
+                               quint64 compressedSize, quint64 localHeaderOffset)
+{
+    QByteArray zip64(4, Qt::Uninitialized);
+    auto store = [&zip64](uchar *field, quint64 value) {
+        if (value < 0xffffffff) {
+            writeUInt(field, uint(value));
+        } else {
+            uchar data[8];
+            writeULongLong(data, value);
+            zip64.append(reinterpret_cast<const char *>(data), sizeof(data));
+            writeUInt(field, 0xffffffff);
+        }
+    };
+    store(header->h.uncompressed_size, uncompressedSize);
+    store(header->h.compressed_size, compressedSize);
+    store(header->h.offset_local_header, localHeaderOffset);
+
+    if (zip64.size() > 4) {
+        writeUShort(reinterpret_cast<uchar *>(zip64.data()), Zip64ExtraFieldId);
+        writeUShort(reinterpret_cast<uchar *>(zip64.data()) + 2, zip64.size() - 4);
+        header->extra_field = zip64;
+        writeUShort(header->h.version_needed, ZIP64_VERSION);
+    } else {
+        header->extra_field.clear();
+    }
+    writeUShort(header->h.extra_field_length, header->extra_field.size());
+}
+
+/*
+    Returns the zip64 extended information extra field of a local header, which
+    always holds both sizes.
+*/
+static QByteArray localZip64ExtraField(quint64 uncompressedSize, quint64 compressedSize)
+{
+    QByteArray field(20, Qt::Uninitialized);
+    uchar *data = reinterpret_cast<uchar *>(field.data());
+    writeUShort(data, Zip64ExtraFieldId);
+    writeUShort(data + 2, 16);
+    writeULongLong(data + 4, uncompressedSize);
+    writeULongLong(data + 12, compressedSize);
+    return field;
+}
+
 class QZipPrivate
 {
 public:
@@ -437,7 +573,7 @@ public:
     bool dirtyFileTree;
     QVector<FileHeader> fileHeaders;
     QByteArray comment;
-    uint start_of_directory;
+    qint64 start_of_directory;
 };
 
 QZipReader::FileInfo QZipPrivate::fillFileInfo(int index) const
@@ -492,7 +628,9 @@ QZipReader::FileInfo QZipPrivate::fillFileInfo(int index) const
     const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
     fileInfo.filePath = inUtf8 ? QString::fromUtf8(header.file_name) : QString::fromLocal8Bit(header.file_name);
     fileInfo.crc = readUInt(header.h.crc_32);
-    fileInfo.size = readUInt(header.h.uncompressed_size);
+    quint64 uncompressedSize, compressedSize, localHeaderOffset;
+    readEntryLocation(header, &uncompressedSize, &compressedSize, &localHeaderOffset);
+    fileInfo.size = qint64(uncompressedSize);
     fileInfo.lastModified = readMSDosDate(header.h.last_mod_file);
 
     // fix the file path, if broken (convert separators, eat leading and trailing ones)
@@ -516,8 +654,95 @@ public:
     }
 
     void scanFiles();
+    void readCentralDirectory(qint64 offset, qint64 size, qint64 num_dir_entries);
+    int indexOf(const QString &fileName);
+    qint64 entryDataOffset(const FileHeader &header, qint64 localHeaderOffset, int *compressionMethod);
 
     QZipReader::Status status;
+    QHash<QString, int> fileIndex;
+};
+
+/*
+    A read-only view of a range of the archive. The range is mapped into memory
+    when the archive is a file, so that only the pages actually looked at get
+    loaded, and read into a buffer otherwise.
+*/
+class QZipArchiveView
+{
+public:
+    QZipArchiveView(QIODevice *device, qint64 offset, qint64 length)
+        : file(qobject_cast<QFileDevice *>(device)), mapped(nullptr), length(0)
+    {
+        if (offset < 0 || length <= 0)
+            return;
+        if (file)
+            mapped = file->map(offset, length);
+        if (mapped) {
+            this->length = length;
+        } else if (device->seek(offset)) {
+            buffer = device->read(length);
+            this->length = buffer.size();
+        }
+    }
+
+    ~QZipArchiveView()
+    {
+        if (mapped)
+            file->unmap(mapped);
+    }
+
+    const uchar *data() const
+    { return mapped ? mapped : reinterpret_cast<const uchar *>(buffer.constData()); }
+    qint64 size() const { return length; }
+
+private:
+    QFileDevice *file;
+    uchar *mapped;
+    QByteArray buffer;
+    qint64 length;
+
+    Q_DISABLE_COPY(QZipArchiveView)
+};
+
+/*
+    A sequential device reading the bytes of one archive member as they are
+    stored in the archive. Every read seeks the shared archive device first, so
+    several members can be read at the same time.
+*/
+class QZipRangeDevice : public QIODevice
+{
+public:
+    QZipRangeDevice(QIODevice *archive, qint64 offset, qint64 length)
+        : archive(archive), offset(offset), length(length), consumed(0)
+    {
+    }
+
+    bool isSequential() const override { return true; }
+    bool atEnd() const override { return consumed == length && QIODevice::atEnd(); }
+    qint64 bytesAvailable() const override { return length - consumed + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override
+    {
+        maxlen = qMin(maxlen, length - consumed);
+        if (maxlen <= 0)
+            return consumed == length ? -1 : 0;
+        if (!archive->seek(offset + consumed))
+            return -1;
+        const qint64 read = archive->read(data, maxlen);
+        if (read <= 0)
+            return -1;
+        consumed += read;
+        return read;
+    }
+
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QIODevice *archive;
+    const qint64 offset;
+    const qint64 length;
+    qint64 consumed;
 };
 
 class QZipWriterPrivate : public QZipPrivate
@@ -527,17 +752,38 @@ public:
         : QZipPrivate(device, ownDev),
         status(QZipWriter::NoError),
         permissions(QFile::ReadOwner | QFile::WriteOwner),
-        compressionPolicy(QZipWriter::AlwaysCompress)
+        compressionPolicy(QZipWriter::AlwaysCompress),
+        parallelCompression(false),
+        pendingSize(0)
     {
     }
 
     QZipWriter::Status status;
     QFile::Permissions permissions;
     QZipWriter::CompressionPolicy compressionPolicy;
+    bool parallelCompression;
 
     enum EntryType { Directory, File, Symlink };
 
+    struct Entry
+    {
+        FileHeader header;
+        QByteArray contents;
+        QByteArray data; // the contents as stored in the archive
+        bool compress;
+    };
+
+    // entries waiting to be compressed in parallel, in archive order
+    QVector<Entry> pendingEntries;
+    qint64 pendingSize;
+
     void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+    void addEntry(const QString &fileName, QIODevice *source);
+    Entry createEntry(EntryType type, const QString &fileName, qint64 size) const;
+    static void compressEntry(Entry *entry);
+    void writeEntry(Entry *entry);
+    void writePendingEntries();
+    void writeCentralDirectory();
 };
 
 static LocalFileHeader toLocalHeader(const CentralFileHeader &ch)
@@ -579,63 +825,100 @@ void QZipReaderPrivate::scanFiles()
         return;
     }
 
-    // find EndOfDirectory header
+    // find EndOfDirectory header; it is followed by a comment of at most 65535
+    // bytes and, in zip64 archives, preceded by the zip64 locator
+    const qint64 archiveSize = device->size();
+    const qint64 tailOffset = qMax(Q_INT64_C(0), archiveSize - qint64(sizeof(Zip64EndOfDirectoryLocator)
+                                                                       + sizeof(EndOfDirectory) + 65535));
+    QZipArchiveView tail(device, tailOffset, archiveSize - tailOffset);
+    const uchar *tailData = tail.data();
     int i = 0;
-    int start_of_directory = -1;
-    int num_dir_entries = 0;
-    EndOfDirectory eod;
-    while (start_of_directory == -1) {
-        const int pos = device->size() - int(sizeof(EndOfDirectory)) - i;
+    qint64 eodPos = -1;
+    while (eodPos == -1) {
+        const qint64 pos = tail.size() - qint64(sizeof(EndOfDirectory)) - i;
         if (pos < 0 || i > 65535) {
             qWarning("QZip: EndOfDirectory not found");
             return;
         }
 
-        device->seek(pos);
-        device->read((char *)&eod, sizeof(EndOfDirectory));
-        if (readUInt(eod.signature) == 0x06054b50)
-            break;
-        ++i;
+        if (readUInt(tailData + pos) == 0x06054b50)
+            eodPos = pos;
+        else
+            ++i;
     }
 
     // have the eod
-    start_of_directory = readUInt(eod.dir_start_offset);
-    num_dir_entries = readUShort(eod.num_dir_entries);
-    ZDEBUG("start_of_directory at %d, num_dir_entries=%d", start_of_directory, num_dir_entries);
+    EndOfDirectory eod;
+    memcpy(&eod, tailData + eodPos, sizeof(EndOfDirectory));
+    qint64 start_of_directory = readUInt(eod.dir_start_offset);
+    qint64 end_of_directory = tailOffset + eodPos;
+    qint64 num_dir_entries = readUShort(eod.num_dir_entries);
     int comment_length = readUShort(eod.comment_length);
     if (comment_length != i)
         qWarning("QZip: failed to parse zip file.");
-    comment = device->read(qMin(comment_length, i));
+    comment = QByteArray(reinterpret_cast<const char *>(tailData) + eodPos + sizeof(EndOfDirectory),
+                         qMin(comment_length, i));
+
+    // zip64 archives keep the values that may overflow in a record of their own
+    const qint64 locatorPos = eodPos - qint64(sizeof(Zip64EndOfDirectoryLocator));
+    if (locatorPos >= 0 && readUInt(tailData + locatorPos) == 0x07064b50) {
+        Zip64EndOfDirectoryLocator locator;
+        memcpy(&locator, tailData + locatorPos, sizeof(Zip64EndOfDirectoryLocator));
+        const qint64 eod64Offset = qint64(readULongLong(locator.eod_offset));
+        Zip64EndOfDirectory eod64;
+        if (!device->seek(eod64Offset)
+                || device->read((char *)&eod64, sizeof(Zip64EndOfDirectory)) != qint64(sizeof(Zip64EndOfDirectory))
+                || readUInt(eod64.signature) != 0x06064b50) {
+            qWarning("QZip: Zip64 EndOfDirectory not found");
+            return;
+        }
+        start_of_directory = qint64(readULongLong(eod64.dir_start_offset));
+        end_of_directory = eod64Offset;
+        num_dir_entries = qint64(readULongLong(eod64.num_dir_entries));
+    }
+    ZDEBUG("start_of_directory at %lld, num_dir_entries=%lld", start_of_directory, num_dir_entries);
 
+    readCentralDirectory(start_of_directory, end_of_directory - start_of_directory, num_dir_entries);
+}
 
-    device->seek(start_of_directory);
-    for (i = 0; i < num_dir_entries; ++i) {
+void QZipReaderPrivate::readCentralDirectory(qint64 offset, qint64 size, qint64 num_dir_entries)
+{
+    QZipArchiveView directory(device, offset, size);
+    const uchar *data = directory.data();
+    size = directory.size();
+
+    qint64 pos = 0;
+    auto readField = [data, size, &pos](int length, QByteArray *field) {
+        if (pos + length > size)
+            return false;
+        *field = QByteArray(reinterpret_cast<const char *>(data) + pos, length);
+        pos += length;
+        return true;
+    };
+
+    fileHeaders.reserve(int(qMin(num_dir_entries, size / qint64(sizeof(CentralFileHeader)))));
+    for (qint64 i = 0; i < num_dir_entries; ++i) {
         FileHeader header;
-        int read = device->read((char *) &header.h, sizeof(CentralFileHeader));
-        if (read < (int)sizeof(CentralFileHeader)) {
+        if (pos + qint64(sizeof(CentralFileHeader)) > size) {
             qWarning("QZip: Failed to read complete header, index may be incomplete");
             break;
         }
+        memcpy(&header.h, data + pos, sizeof(CentralFileHeader));
+        pos += sizeof(CentralFileHeader);
         if (readUInt(header.h.signature) != 0x02014b50) {
             qWarning("QZip: invalid header signature, index may be incomplete");
             break;
         }
 
-        int l = readUShort(header.h.file_name_length);
-        header.file_name = device->read(l);
-        if (header.file_name.length() != l) {
+        if (!readField(readUShort(header.h.file_name_length), &header.file_name)) {
             qWarning("QZip: Failed to read filename from zip index, index may be incomplete");
             break;
         }
-        l = readUShort(header.h.extra_field_length);
-        header.extra_field = device->read(l);
-        if (header.extra_field.length() != l) {
+        if (!readField(readUShort(header.h.extra_field_length), &header.extra_field)) {
             qWarning("QZip: Failed to read extra field in zip file, skipping file, index may be incomplete");
             break;
         }
-        l = readUShort(header.h.file_comment_length);
-        header.file_comment = device->read(l);
-        if (header.file_comment.length() != l) {
+        if (!readField(readUShort(header.h.file_comment_length), &header.file_comment)) {
             qWarning("QZip: Failed to read read file comment, index may be incomplete");
             break;
         }
@@ -645,69 +928,68 @@ void QZipReaderPrivate::scanFiles()
     }
 }
 
-void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const QByteArray &contents/*, QFile::Permissions permissions, QZip::Method m*/)
+int QZipReaderPrivate::indexOf(const QString &fileName)
 {
-#ifndef NDEBUG
-    static const char *const entryTypes[] = {
-        "directory",
-        "file     ",
-        "symlink  " };
-    ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
-#endif
+    scanFiles();
+    if (fileIndex.isEmpty() && !fileHeaders.isEmpty()) {
+        // insert backwards, so that the first of several entries of the same name wins
+        fileIndex.reserve(fileHeaders.size());
+        for (int i = fileHeaders.size() - 1; i >= 0; --i)
+            fileIndex.insert(QString::fromLocal8Bit(fileHeaders.at(i).file_name), i);
+    }
+    return fileIndex.value(fileName, -1);
+}
 
-    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
-        status = QZipWriter::FileOpenError;
-        return;
+/*
+    Returns the offset of the data of the entry described by \a header, whose
+    local header is at \a localHeaderOffset, or -1 if the data cannot be
+    extracted.
+*/
+qint64 QZipReaderPrivate::entryDataOffset(const FileHeader &header, qint64 localHeaderOffset,
+                                          int *compressionMethod)
+{
+    ushort version_needed = readUShort(header.h.version_needed);
+    if (version_needed > ZIP64_VERSION) {
+        qWarning("QZip: .ZIP specification version %d implementationis needed to extract the data.", version_needed);
+        return -1;
     }
-    device->seek(start_of_directory);
 
+    ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
+    if ((general_purpose_bits & Encrypted) != 0) {
+        qWarning("QZip: Unsupported encryption method is needed to extract the data.");
+        return -1;
+    }
+
+    LocalFileHeader lh;
+    if (!device->seek(localHeaderOffset)
+            || device->read((char *)&lh, sizeof(LocalFileHeader)) != qint64(sizeof(LocalFileHeader))) {
+        qWarning("QZip: Failed to read local file header");
+        return -1;
+    }
+    *compressionMethod = readUShort(lh.compression_method);
+    return localHeaderOffset + qint64(sizeof(LocalFileHeader))
+            + readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
+}
+
+QZipWriterPrivate::Entry QZipWriterPrivate::createEntry(EntryType type, const QString &fileName, qint64 size) const
+{
     // don't compress small files
     QZipWriter::CompressionPolicy compression = compressionPolicy;
     if (compressionPolicy == QZipWriter::AutoCompress) {
-        if (contents.length() < 64)
+        if (size < 64)
             compression = QZipWriter::NeverCompress;
         else
             compression = QZipWriter::AlwaysCompress;
     }
 
-    FileHeader header;
+    Entry entry;
+    entry.compress = compression == QZipWriter::AlwaysCompress;
+    FileHeader &header = entry.header;
     memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
     writeUShort(header.h.version_needed, ZIP_VERSION);
-    writeUInt(header.h.uncompressed_size, contents.length());
     writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
-    QByteArray data = contents;
-    if (compression == QZipWriter::AlwaysCompress) {
-        writeUShort(header.h.compression_method, CompressionMethodDeflated);
-
-       ulong len = contents.length();
-        // shamelessly copied form zlib
-        len += (len >> 12) + (len >> 14) + 11;
-        int res;
-        do {
-            data.resize(len);
-            res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length());
-
-            switch (res) {
-            case Z_OK:
-                data.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
-    }
-// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
-    writeUInt(header.h.compressed_size, data.length());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uchar *)contents.constData(), contents.length());
-    writeUInt(header.h.crc_32, crc_32);
 
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     ushort general_purpose_bits = Utf8Names; // always use utf-8
@@ -745,19 +1027,324 @@ void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
         break;
     }
     writeUInt(header.h.external_file_attributes, mode << 16);
-    writeUInt(header.h.offset_local_header, start_of_directory);
+    return entry;
+}
+
+/*
+    Compresses the contents of \a entry according to its compression flag and
+    computes their checksum. Only touches \a entry, so independent entries can
+    be compressed concurrently.
+*/
+void QZipWriterPrivate::compressEntry(Entry *entry)
+{
+    const QByteArray &contents = entry->contents;
+    QByteArray data = contents;
+    if (entry->compress) {
+        writeUShort(entry->header.h.compression_method, CompressionMethodDeflated);
 
+       ulong len = contents.length();
+        // shamelessly copied form zlib
+        len += (len >> 12) + (len >> 14) + 11;
+        int res;
+        do {
+            data.resize(len);
+            res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length());
 
+            switch (res) {
+            case Z_OK:
+                data.resize(len);
+                break;
+            case Z_MEM_ERROR:
+                qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
+                data.resize(0);
+                break;
+            case Z_BUF_ERROR:
+                len *= 2;
+                break;
+            }
+        } while (res == Z_BUF_ERROR);
+    }
+// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
+    entry->data = data;
+    writeUInt(entry->header.h.crc_32, qCrc32(contents.constData(), size_t(contents.size())));
+}
+
+void QZipWriterPrivate::writeEntry(Entry *entry)
+{
+    FileHeader &header = entry->header;
+    writeEntryLocation(&header, entry->contents.size(), entry->data.size(), start_of_directory);
     fileHeaders.append(header);
 
+    // in-memory contents never need the zip64 sizes in the local header
     LocalFileHeader h = toLocalHeader(header.h);
+    writeUShort(h.extra_field_length, 0);
+    device->seek(start_of_directory);
     device->write((const char *)&h, sizeof(LocalFileHeader));
     device->write(header.file_name);
-    device->write(data);
+    device->write(entry->data);
     start_of_directory = device->pos();
     dirtyFileTree = true;
 }
 
+void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const QByteArray &contents/*, QFile::Permissions permissions, QZip::Method m*/)
+{
+#ifndef NDEBUG
+    static const char *const entryTypes[] = {
+        "directory",
+        "file     ",
+        "symlink  " };
+    ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
+#endif
+
+    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = QZipWriter::FileOpenError;
+        return;
+    }
+
+    Entry entry = createEntry(type, fileName, contents.size());
+    entry.contents = contents;
+    if (parallelCompression) {
+        // Bounds the memory held by contents that are waiting for compression
+        static const qint64 MaximumPendingSize = 64 * 1024 * 1024;
+
+        pendingEntries.append(entry);
+        pendingSize += contents.size();
+        if (pendingSize >= MaximumPendingSize)
+            writePendingEntries();
+        return;
+    }
+
+    compressEntry(&entry);
+    writeEntry(&entry);
+}
+
+/*
+    Adds a file entry with the contents of \a source. Large files are
+    compressed straight into the archive instead of being read into memory
+    first; their local header is written again once the sizes and the checksum
+    are known.
+*/
+void QZipWriterPrivate::addEntry(const QString &fileName, QIODevice *source)
+{
+    // Below this size, reading the whole file is cheaper and allows parallel compression
+    static const qint64 MinimumStreamedSize = 16 * 1024 * 1024;
+
+    const qint64 size = source->isSequential() ? -1 : source->size() - source->pos();
+    if (size < MinimumStreamedSize || device->isSequential()) {
+        addEntry(File, fileName, source->readAll());
+        return;
+    }
+
+    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = QZipWriter::FileOpenError;
+        return;
+    }
+
+    // keep the entries in the order they were added in
+    writePendingEntries();
+
+    Entry entry = createEntry(File, fileName, size);
+    FileHeader &header = entry.header;
+    if (entry.compress)
+        writeUShort(header.h.compression_method, CompressionMethodDeflated);
+
+    // deflate can grow incompressible data slightly, leave some room for that
+    const bool zip64 = quint64(size) + quint64(size >> 10) + 1024 >= 0xffffffff;
+    if (zip64)
+        writeUShort(header.h.version_needed, ZIP64_VERSION);
+
+    const qint64 headerOffset = start_of_directory;
+    LocalFileHeader h = toLocalHeader(header.h);
+    QByteArray extra = zip64 ? localZip64ExtraField(0, 0) : QByteArray();
+    writeUShort(h.extra_field_length, extra.size());
+    device->seek(headerOffset);
+    device->write((const char *)&h, sizeof(LocalFileHeader));
+    device->write(header.file_name);
+    device->write(extra);
+    const qint64 dataOffset = device->pos();
+
+    QCompressionDevice deflater(device, QCompressionDevice::RawDeflate);
+    QIODevice *out = device;
+    if (entry.compress) {
+        deflater.open(QIODevice::WriteOnly);
+        out = &deflater;
+    }
+
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    quint32 crc_32 = 0;
+    qint64 uncompressedSize = 0;
+    bool ok = true;
+    for (;;) {
+        const qint64 read = source->read(buffer.data(), buffer.size());
+        if (read <= 0) {
+            ok = read == 0;
+            break;
+        }
+        crc_32 = qCrc32(buffer.constData(), size_t(read), crc_32);
+        uncompressedSize += read;
+        if (out->write(buffer.constData(), read) != read) {
+            ok = false;
+            break;
+        }
+    }
+    if (entry.compress)
+        deflater.close();
+
+    const qint64 dataEnd = device->pos();
+    const qint64 compressedSize = dataEnd - dataOffset;
+    if (!ok || (!zip64 && (uncompressedSize >= 0xffffffff || compressedSize >= 0xffffffff))) {
+        qWarning("QZip: Failed to add %s to the archive", qPrintable(fileName));
+        status = QZipWriter::FileWriteError;
+        return;
+    }
+
+    writeUInt(header.h.crc_32, crc_32);
+    copyUInt(h.crc_32, header.h.crc_32);
+    if (zip64) {
+        writeUInt(h.compressed_size, 0xffffffff);
+        writeUInt(h.uncompressed_size, 0xffffffff);
+        extra = localZip64ExtraField(uncompressedSize, compressedSize);
+    } else {
+        writeUInt(h.compressed_size, uint(compressedSize));
+        writeUInt(h.uncompressed_size, uint(uncompressedSize));
+    }
+    device->seek(headerOffset);
+    device->write((const char *)&h, sizeof(LocalFileHeader));
+    device->write(header.file_name);
+    device->write(extra);
+    device->seek(dataEnd);
+
+    writeEntryLocation(&header, uncompressedSize, compressedSize, headerOffset);
+    fileHeaders.append(header);
+    start_of_directory = dataEnd;
+    dirtyFileTree = true;
+}
+
+#if QT_CONFIG(thread)
+/*
+    Compresses pending entries in a thread of the pool, taking the next
+    uncompressed entry until there are none left.
+*/
+class QZipEntryCompressor : public QRunnable
+{
+public:
+    QZipEntryCompressor(QZipWriterPrivate::Entry *entries, int count, QAtomicInt *next,
+                        QSemaphore *done)
+        : entries(entries), count(count), next(next), done(done)
+    {
+    }
+
+    void run() override
+    {
+        compressEntries(entries, count, next);
+        done->release();
+    }
+
+    static void compressEntries(QZipWriterPrivate::Entry *entries, int count, QAtomicInt *next)
+    {
+        for (int i = next->fetchAndAddRelaxed(1); i < count; i = next->fetchAndAddRelaxed(1))
+            QZipWriterPrivate::compressEntry(entries + i);
+    }
+
+private:
+    QZipWriterPrivate::Entry *entries;
+    int count;
+    QAtomicInt *next;
+    QSemaphore *done;
+};
+#endif // QT_CONFIG(thread)
+
+void QZipWriterPrivate::writePendingEntries()
+{
+    const int count = pendingEntries.size();
+    if (count == 0)
+        return;
+
+    Entry *entries = pendingEntries.data();
+#if QT_CONFIG(thread)
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QAtomicInt next(0);
+    QSemaphore done;
+    int started = 0;
+
+    // the calling thread compresses entries as well
+    const int helperCount = qMin(count, QThread::idealThreadCount()) - 1;
+    for (int i = 0; i < helperCount; ++i) {
+        QZipEntryCompressor *compressor = new QZipEntryCompressor(entries, count, &next, &done);
+        if (!pool->tryStart(compressor)) {
+            delete compressor;
+            break;
+        }
+        ++started;
+    }
+
+    QZipEntryCompressor::compressEntries(entries, count, &next);
+    done.acquire(started);
+#else
+    for (int i = 0; i < count; ++i)
+        compressEntry(entries + i);
+#endif
+
+    for (int i = 0; i < count; ++i)
+        writeEntry(entries + i);
+    pendingEntries.clear();
+    pendingSize = 0;
+}
+
+void QZipWriterPrivate::writeCentralDirectory()
+{
+    //qDebug("QZip::close writing directory, %d entries", fileHeaders.size());
+    device->seek(start_of_directory);
+    // write new directory
+    for (int i = 0; i < fileHeaders.size(); ++i) {
+        const FileHeader &header = fileHeaders.at(i);
+        device->write((const char *)&header.h, sizeof(CentralFileHeader));
+        device->write(header.file_name);
+        device->write(header.extra_field);
+        device->write(header.file_comment);
+    }
+    const qint64 dir_size = device->pos() - start_of_directory;
+    const qint64 num_dir_entries = fileHeaders.size();
+
+    // the zip64 records are only needed when a value overflows the end of directory
+    if (num_dir_entries >= 0xffff || dir_size >= 0xffffffff || start_of_directory >= 0xffffffff) {
+        const qint64 eod64Offset = device->pos();
+        Zip64EndOfDirectory eod64;
+        memset(&eod64, 0, sizeof(Zip64EndOfDirectory));
+        writeUInt(eod64.signature, 0x06064b50);
+        writeULongLong(eod64.record_size, sizeof(Zip64EndOfDirectory) - 12);
+        writeUShort(eod64.version_made, (HostUnix << 8) | ZIP64_VERSION);
+        writeUShort(eod64.version_needed, ZIP64_VERSION);
+        writeULongLong(eod64.num_dir_entries_this_disk, num_dir_entries);
+        writeULongLong(eod64.num_dir_entries, num_dir_entries);
+        writeULongLong(eod64.directory_size, dir_size);
+        writeULongLong(eod64.dir_start_offset, start_of_directory);
+        device->write((const char *)&eod64, sizeof(Zip64EndOfDirectory));
+
+        Zip64EndOfDirectoryLocator locator;
+        memset(&locator, 0, sizeof(Zip64EndOfDirectoryLocator));
+        writeUInt(locator.signature, 0x07064b50);
+        writeULongLong(locator.eod_offset, eod64Offset);
+        writeUInt(locator.num_disks, 1);
+        device->write((const char *)&locator, sizeof(Zip64EndOfDirectoryLocator));
+    }
+
+    // write end of directory
+    EndOfDirectory eod;
+    memset(&eod, 0, sizeof(EndOfDirectory));
+    writeUInt(eod.signature, 0x06054b50);
+    //uchar this_disk[2];
+    //uchar start_of_directory_disk[2];
+    writeUShort(eod.num_dir_entries_this_disk, qMin(num_dir_entries, Q_INT64_C(0xffff)));
+    writeUShort(eod.num_dir_entries, qMin(num_dir_entries, Q_INT64_C(0xffff)));
+    writeUInt(eod.directory_size, qMin(dir_size, Q_INT64_C(0xffffffff)));
+    writeUInt(eod.dir_start_offset, qMin(start_of_directory, Q_INT64_C(0xffffffff)));
+    writeUShort(eod.comment_length, comment.length());
+
+    device->write((const char *)&eod, sizeof(EndOfDirectory));
+    device->write(comment);
+}
+
 //////////////////////////////  Reader
 
 /*!
@@ -935,42 +1522,27 @@ QZipReader::FileInfo QZipReader::entryInfoAt(int index) const
 */
 QByteArray QZipReader::fileData(const QString &fileName) const
 {
-    d->scanFiles();
-    int i;
-    for (i = 0; i < d->fileHeaders.size(); ++i) {
-        if (QString::fromLocal8Bit(d->fileHeaders.at(i).file_name) == fileName)
-            break;
-    }
-    if (i == d->fileHeaders.size())
+    const int i = d->indexOf(fileName);
+    if (i < 0)
         return QByteArray();
 
     FileHeader header = d->fileHeaders.at(i);
 
-    ushort version_needed = readUShort(header.h.version_needed);
-    if (version_needed > ZIP_VERSION) {
-        qWarning("QZip: .ZIP specification version %d implementationis needed to extract the data.", version_needed);
+    quint64 uncompressedSize, compressedSize, localHeaderOffset;
+    readEntryLocation(header, &uncompressedSize, &compressedSize, &localHeaderOffset);
+    if (uncompressedSize > quint64(INT_MAX) || compressedSize > quint64(INT_MAX)) {
+        qWarning("QZip: File is too large to be extracted into memory.");
         return QByteArray();
     }
+    const int compressed_size = int(compressedSize);
+    const int uncompressed_size = int(uncompressedSize);
+    //qDebug("uncompressing file %d: local header at %llu", i, localHeaderOffset);
 
-    ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
-    int compressed_size = readUInt(header.h.compressed_size);
-    int uncompressed_size = readUInt(header.h.uncompressed_size);
-    int start = readUInt(header.h.offset_local_header);
-    //qDebug("uncompressing file %d: local header at %d", i, start);
-
-    d->device->seek(start);
-    LocalFileHeader lh;
-    d->device->read((char *)&lh, sizeof(LocalFileHeader));
-    uint skip = readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
-    d->device->seek(d->device->pos() + skip);
-
-    int compression_method = readUShort(lh.compression_method);
-    //qDebug("file=%s: compressed_size=%d, uncompressed_size=%d", fileName.toLocal8Bit().data(), compressed_size, uncompressed_size);
-
-    if ((general_purpose_bits & Encrypted) != 0) {
-        qWarning("QZip: Unsupported encryption method is needed to extract the data.");
+    int compression_method;
+    const qint64 start = d->entryDataOffset(header, qint64(localHeaderOffset), &compression_method);
+    if (start < 0 || !d->device->seek(start))
         return QByteArray();
-    }
+    //qDebug("file=%s: compressed_size=%d, uncompressed_size=%d", fileName.toLocal8Bit().data(), compressed_size, uncompressed_size);
 
     //qDebug("file at %lld", d->device->pos());
     QByteArray compressed = d->device->read(compressed_size);
@@ -1013,6 +1585,52 @@ QByteArray QZipReader::fileData(const QString &fileName) const
     return QByteArray();
 }
 
+/*!
+    \since 5.12
+
+    Returns a sequential device reading the uncompressed contents of the file
+    \a fileName from the zip archive, or \c nullptr if the file does not exist
+    or cannot be extracted.
+
+    Unlike fileData(), the contents are decompressed while they are read, so
+    that large files never have to fit into memory. The device is already open
+    and the caller takes ownership of it; it must not be used after the reader
+    has been closed or destroyed.
+
+    \sa fileData()
+*/
+QIODevice *QZipReader::openFile(const QString &fileName) const
+{
+    const int i = d->indexOf(fileName);
+    if (i < 0)
+        return nullptr;
+
+    const FileHeader &header = d->fileHeaders.at(i);
+    quint64 uncompressedSize, compressedSize, localHeaderOffset;
+    readEntryLocation(header, &uncompressedSize, &compressedSize, &localHeaderOffset);
+
+    int compression_method;
+    const qint64 start = d->entryDataOffset(header, qint64(localHeaderOffset), &compression_method);
+    if (start < 0)
+        return nullptr;
+
+    if (compression_method != CompressionMethodStored && compression_method != CompressionMethodDeflated) {
+        qWarning("QZip: Unsupported compression method %d is needed to extract the data.", compression_method);
+        return nullptr;
+    }
+
+    QZipRangeDevice *range = new QZipRangeDevice(d->device, start, qint64(compressedSize));
+    if (compression_method == CompressionMethodStored) {
+        range->open(QIODevice::ReadOnly);
+        return range;
+    }
+
+    QCompressionDevice *inflater = new QCompressionDevice(range, QCompressionDevice::RawDeflate);
+    range->setParent(inflater);
+    inflater->open(QIODevice::ReadOnly);
+    return inflater;
+}
+
 /*!
     Extracts the full contents of the zip file into \a destinationDir on
     the local filesystem.
@@ -1053,13 +1671,23 @@ bool QZipReader::extractAll(const QString &destinationDir) const
         }
     }
 
+    // files are streamed, so they don't have to fit into memory
+    QByteArray buffer;
     for (const FileInfo &fi : allFiles) {
         const QString absPath = destinationDir + QDir::separator() + fi.filePath;
         if (fi.isFile) {
             QFile f(absPath);
             if (!f.open(QIODevice::WriteOnly))
                 return false;
-            f.write(fileData(fi.filePath));
+            QScopedPointer<QIODevice> entry(openFile(fi.filePath));
+            if (entry) {
+                buffer.resize(64 * 1024);
+                qint64 read;
+                while ((read = entry->read(buffer.data(), buffer.size())) > 0) {
+                    if (f.write(buffer.constData(), read) != read)
+                        return false;
+                }
+            }
             f.setPermissions(fi.permissions);
             f.close();
         }
@@ -1259,6 +1887,42 @@ QFile::Permissions QZipWriter::creationPermissions() const
     return d->permissions;
 }
 
+/*!
+    \since 5.12
+
+    Sets whether files added with their contents in memory are compressed in
+    parallel to \a enable.
+
+    When enabled, such files are queued and compressed concurrently by the
+    threads of QThreadPool::globalInstance() once enough of them have been
+    queued, before a file is added from a large device, and when the archive is
+    closed. The files keep the order in which they were added. Until then,
+    status() does not reflect errors writing them.
+
+    \note parallel compression is disabled by default
+
+    \sa isParallelCompressionEnabled(), addFile()
+*/
+void QZipWriter::setParallelCompressionEnabled(bool enable)
+{
+    if (!enable)
+        d->writePendingEntries();
+    d->parallelCompression = enable;
+}
+
+/*!
+    \since 5.12
+
+    Returns \c true if files added with their contents in memory are
+    compressed in parallel; otherwise returns \c false.
+
+    \sa setParallelCompressionEnabled()
+*/
+bool QZipWriter::isParallelCompressionEnabled() const
+{
+    return d->parallelCompression;
+}
+
 /*!
     Add a file to the archive with \a data as the file contents.
     The file will be stored in the archive using the \a fileName which
@@ -1282,6 +1946,10 @@ void QZipWriter::addFile(const QString &fileName, const QByteArray &data)
     filedata.
     The file will be stored in the archive using the \a fileName which
     includes the full path in the archive.
+
+    Large files on random-access devices are compressed straight into the
+    archive while they are read, and use the zip64 extensions if they exceed
+    4 GB.
 */
 void QZipWriter::addFile(const QString &fileName, QIODevice *device)
 {
@@ -1295,7 +1963,7 @@ void QZipWriter::addFile(const QString &fileName, QIODevice *device)
             return;
         }
     }
-    d->addEntry(QZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), device->readAll());
+    d->addEntry(QDir::fromNativeSeparators(fileName), device);
     if (opened)
         device->close();
 }
@@ -1333,31 +2001,8 @@ void QZipWriter::close()
         return;
     }
 
-    //qDebug("QZip::close writing directory, %d entries", d->fileHeaders.size());
-    d->device->seek(d->start_of_directory);
-    // write new directory
-    for (int i = 0; i < d->fileHeaders.size(); ++i) {
-        const FileHeader &header = d->fileHeaders.at(i);
-        d->device->write((const char *)&header.h, sizeof(CentralFileHeader));
-        d->device->write(header.file_name);
-        d->device->write(header.extra_field);
-        d->device->write(header.file_comment);
-    }
-    int dir_size = d->device->pos() - d->start_of_directory;
-    // write end of directory
-    EndOfDirectory eod;
-    memset(&eod, 0, sizeof(EndOfDirectory));
-    writeUInt(eod.signature, 0x06054b50);
-    //uchar this_disk[2];
-    //uchar start_of_directory_disk[2];
-    writeUShort(eod.num_dir_entries_this_disk, d->fileHeaders.size());
-    writeUShort(eod.num_dir_entries, d->fileHeaders.size());
-    writeUInt(eod.directory_size, dir_size);
-    writeUInt(eod.dir_start_offset, d->start_of_directory);
-    writeUShort(eod.comment_length, d->comment.length());
-
-    d->device->write((const char *)&eod, sizeof(EndOfDirectory));
-    d->device->write(d->comment);
+    d->writePendingEntries();
+    d->writeCentralDirectory();
     d->device->close();
 }
 
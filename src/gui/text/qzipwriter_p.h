@@ -97,6 +97,9 @@ public:
     void setCreationPermissions(QFile::Permissions permissions);
     QFile::Permissions creationPermissions() const;
 
+    void setParallelCompressionEnabled(bool enable);
+    bool isParallelCompressionEnabled() const;
+
     void addFile(const QString &fileName, const QByteArray &data);
 
     void addFile(const QString &fileName, QIODevice *device);
@@ -3858,6 +3858,13 @@ bool QFontEngineFT::initFromFontEngine(const QFontEngineFT *fe)
     // will be using it
     freetype->ref.ref();
 
+    copyRenderingSettings(fe);
+
+    return true;
+}
+
+void QFontEngineFT::copyRenderingSettings(const QFontEngineFT *fe)
+{
     default_load_flags = fe->default_load_flags;
     default_hint_style = fe->default_hint_style;
     antialias = fe->antialias;
@@ -3867,8 +3874,6 @@ bool QFontEngineFT::initFromFontEngine(const QFontEngineFT *fe)
     subpixelType = fe->subpixelType;
     lcdFilterType = fe->lcdFilterType;
     embeddedbitmap = fe->embeddedbitmap;
-
-    return true;
 }
 
 QFontEngine *QFontEngineFT::cloneWithSize(qreal pixelSize) const
@@ -3884,6 +3889,29 @@ QFontEngine *QFontEngineFT::cloneWithSize(qreal pixelSize) const
     }
 }
 
+bool QFontEngineFT::supportsConcurrentRasterization() const
+{
+    return freetype && (!face_id.filename.isEmpty() || !freetype->fontData.isEmpty());
+}
+
+/*
+    Returns an engine with the same rendering settings as this one, but backed by
+    the FreeType face of the calling thread (FreeType libraries and faces are
+    per-thread, see qt_getFreetypeData()), so it can render glyphs without taking
+    this engine's face lock. The returned engine must be deleted on the thread that
+    created it.
+*/
+QFontEngine *QFontEngineFT::cloneForRasterization() const
+{
+    QFontEngineFT *fe = new QFontEngineFT(fontDef);
+    if (!fe->init(face_id, antialias, defaultFormat, freetype->fontData)) {
+        delete fe;
+        return 0;
+    }
+    fe->copyRenderingSettings(this);
+    return fe;
+}
+
 Qt::HANDLE QFontEngineFT::handle() const
 {
     return non_locked_face();
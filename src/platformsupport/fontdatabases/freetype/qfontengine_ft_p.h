@@ -290,6 +290,8 @@ private:
     void setDefaultHintStyle(HintStyle style) override;
 
     QFontEngine *cloneWithSize(qreal pixelSize) const override;
+    bool supportsConcurrentRasterization() const override;
+    QFontEngine *cloneForRasterization() const override;
     Qt::HANDLE handle() const override;
     bool initFromFontEngine(const QFontEngineFT *fontEngine);
 
@@ -328,6 +330,8 @@ private:
     friend class QFreeTypeFontDatabase;
     friend class QFontEngineMultiFontConfig;
 
+    void copyRenderingSettings(const QFontEngineFT *fontEngine);
+
     struct QCustomBoldGlyphSet : public QGlyphSet
     {
         int customBoldWidthx;
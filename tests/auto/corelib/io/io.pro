@@ -2,6 +2,7 @@ TEMPLATE=subdirs
 SUBDIRS=\
     qabstractfileengine \
     qbuffer \
+    qcompressiondevice \
     qdataurl \
     qdebug \
     qdir \
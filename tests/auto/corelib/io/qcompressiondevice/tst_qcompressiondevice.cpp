@@ -0,0 +1,315 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDataStream>
+#include <private/qbytearray_p.h>
+#include <private/qcompressiondevice_p.h>
+
+Q_DECLARE_METATYPE(QCompressionDevice::Format)
+
+class tst_QCompressionDevice : public QObject
+{
+    Q_OBJECT
+private slots:
+    void open();
+    void roundTrip_data();
+    void roundTrip();
+    void compatibleWithQCompress();
+    void gzipHeader();
+    void compressionLevel();
+    void dataStream();
+    void flush();
+    void truncated();
+    void corrupt();
+    void openUnderlyingDevice();
+};
+
+static QByteArray testData(int size)
+{
+    // half compressible text, half noise
+    QByteArray data;
+    data.reserve(size);
+    quint32 seed = 1;
+    while (data.size() < size) {
+        if ((data.size() / 1000) % 2) {
+            seed = seed * 1103515245 + 12345;
+            data += char(seed >> 16);
+        } else {
+            data += "The quick brown fox jumps over the lazy dog. "[data.size() % 45];
+        }
+    }
+    return data;
+}
+
+static QByteArray compress(const QByteArray &data, QCompressionDevice::Format format,
+                           int bufferSize = 64 * 1024, int level = -1)
+{
+    QByteArray compressed;
+    QBuffer buffer(&compressed);
+    buffer.open(QIODevice::WriteOnly);
+    QCompressionDevice device(&buffer, format);
+    device.setBufferSize(bufferSize);
+    device.setCompressionLevel(level);
+    if (!device.open(QIODevice::WriteOnly))
+        return QByteArray();
+    // write in uneven pieces
+    for (int i = 0; i < data.size(); i += 1000)
+        device.write(data.constData() + i, qMin(1000, data.size() - i));
+    device.close();
+    return compressed;
+}
+
+void tst_QCompressionDevice::open()
+{
+    QBuffer buffer;
+    QCompressionDevice device(&buffer);
+    QCOMPARE(device.device(), &buffer);
+    QCOMPARE(device.format(), QCompressionDevice::Zlib);
+    QVERIFY(device.isSequential());
+
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Only ReadOnly or WriteOnly is supported");
+    QVERIFY(!device.open(QIODevice::ReadWrite));
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Only ReadOnly or WriteOnly is supported");
+    QVERIFY(!device.open(QIODevice::WriteOnly | QIODevice::Append));
+
+    buffer.open(QIODevice::ReadOnly);
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: The device is not open in a compatible mode");
+    QVERIFY(!device.open(QIODevice::WriteOnly));
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::setCompressionLevel: Device is already open");
+    device.setCompressionLevel(9);
+    QCOMPARE(device.compressionLevel(), -1);
+
+    QCompressionDevice noDevice(nullptr);
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: No device");
+    QVERIFY(!noDevice.open(QIODevice::ReadOnly));
+}
+
+void tst_QCompressionDevice::roundTrip_data()
+{
+    QTest::addColumn<QCompressionDevice::Format>("format");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("bufferSize");
+
+    const QCompressionDevice::Format formats[] = {
+        QCompressionDevice::Zlib, QCompressionDevice::Gzip, QCompressionDevice::RawDeflate
+    };
+    auto metaEnum = QMetaEnum::fromType<QCompressionDevice::Format>();
+    for (QCompressionDevice::Format format : formats) {
+        const char *name = metaEnum.valueToKey(format);
+        QTest::addRow("%s-empty", name) << format << 0 << 64 * 1024;
+        QTest::addRow("%s-1", name) << format << 1 << 64 * 1024;
+        QTest::addRow("%s-100k", name) << format << 100000 << 64 * 1024;
+        QTest::addRow("%s-100k-smallbuffer", name) << format << 100000 << 16;
+        QTest::addRow("%s-2M", name) << format << 2000000 << 4096;
+    }
+}
+
+void tst_QCompressionDevice::roundTrip()
+{
+    QFETCH(QCompressionDevice::Format, format);
+    QFETCH(int, size);
+    QFETCH(int, bufferSize);
+
+    const QByteArray data = testData(size);
+    QByteArray compressed = compress(data, format, bufferSize);
+    QVERIFY(!compressed.isEmpty());
+    if (size > 1000)
+        QVERIFY(compressed.size() < data.size());
+
+    // read back all at once, and in small pieces
+    {
+        QBuffer buffer(&compressed);
+        QCompressionDevice device(&buffer, format);
+        device.setBufferSize(bufferSize);
+        QVERIFY(device.open(QIODevice::ReadOnly));
+        QCOMPARE(device.readAll(), data);
+        QVERIFY(device.atEnd());
+        QCOMPARE(device.read(1), QByteArray());
+    }
+    {
+        QBuffer buffer(&compressed);
+        QCompressionDevice device(&buffer, format);
+        device.setBufferSize(bufferSize);
+        QVERIFY(device.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+        QByteArray result;
+        char chunk[777];
+        qint64 read;
+        while ((read = device.read(chunk, sizeof chunk)) > 0)
+            result.append(chunk, int(read));
+        QCOMPARE(read, qint64(0));
+        QCOMPARE(result, data);
+        QVERIFY(device.atEnd());
+    }
+}
+
+void tst_QCompressionDevice::compatibleWithQCompress()
+{
+    const QByteArray data = testData(50000);
+
+    // qCompress() output is a zlib stream after a four-byte size
+    QByteArray fromQCompress = qCompress(data).mid(4);
+    QBuffer buffer(&fromQCompress);
+    QCompressionDevice device(&buffer);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QCOMPARE(device.readAll(), data);
+
+    QByteArray sizePrefix(4, Qt::Uninitialized);
+    qToBigEndian(quint32(data.size()), sizePrefix.data());
+    QCOMPARE(qUncompress(sizePrefix + compress(data, QCompressionDevice::Zlib)), data);
+}
+
+void tst_QCompressionDevice::gzipHeader()
+{
+    const QByteArray compressed = compress("hello", QCompressionDevice::Gzip);
+    QVERIFY(compressed.startsWith("\x1f\x8b\x08"));
+    // the trailer holds the CRC-32 and the size of the data
+    QCOMPARE(qFromLittleEndian<quint32>(compressed.constData() + compressed.size() - 8),
+             qCrc32("hello", 5));
+    QCOMPARE(qFromLittleEndian<quint32>(compressed.constData() + compressed.size() - 4), 5u);
+}
+
+void tst_QCompressionDevice::compressionLevel()
+{
+    const QByteArray data = testData(100000);
+    const QByteArray stored = compress(data, QCompressionDevice::RawDeflate, 64 * 1024, 0);
+    const QByteArray fast = compress(data, QCompressionDevice::RawDeflate, 64 * 1024, 1);
+    const QByteArray best = compress(data, QCompressionDevice::RawDeflate, 64 * 1024, 9);
+    QVERIFY(stored.size() > data.size());
+    QVERIFY(fast.size() < stored.size());
+    QVERIFY(best.size() <= fast.size());
+}
+
+void tst_QCompressionDevice::dataStream()
+{
+    QMap<QString, QByteArray> map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(QString::number(i), testData(i));
+
+    QByteArray compressed;
+    {
+        QBuffer buffer(&compressed);
+        QCompressionDevice device(&buffer, QCompressionDevice::Gzip);
+        QVERIFY(device.open(QIODevice::WriteOnly));
+        QDataStream out(&device);
+        out << map << QString("end");
+    }
+    QVERIFY(!compressed.isEmpty());
+
+    QBuffer buffer(&compressed);
+    QCompressionDevice device(&buffer, QCompressionDevice::Gzip);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QDataStream in(&device);
+    QMap<QString, QByteArray> result;
+    QString end;
+    in >> result >> end;
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(result, map);
+    QCOMPARE(end, QString("end"));
+}
+
+void tst_QCompressionDevice::flush()
+{
+    QByteArray compressed;
+    QBuffer buffer(&compressed);
+    buffer.open(QIODevice::WriteOnly);
+    QCompressionDevice device(&buffer);
+    QVERIFY(device.open(QIODevice::WriteOnly));
+    device.write("hello, world");
+    QVERIFY(device.flush());
+
+    // everything written so far can be decompressed without the end of the stream
+    QByteArray partial = compressed;
+    QBuffer partialBuffer(&partial);
+    QCompressionDevice reader(&partialBuffer);
+    QVERIFY(reader.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    char chunk[12];
+    QCOMPARE(reader.read(chunk, sizeof chunk), qint64(sizeof chunk));
+    QCOMPARE(QByteArray(chunk, sizeof chunk), QByteArray("hello, world"));
+
+    device.write("!");
+    device.close();
+    QVERIFY(!device.flush());
+    QCOMPARE(compressed.size() > partial.size(), true);
+}
+
+void tst_QCompressionDevice::truncated()
+{
+    const QByteArray data = testData(100000);
+    QByteArray compressed = compress(data, QCompressionDevice::Zlib);
+    compressed.chop(compressed.size() / 2);
+
+    QBuffer buffer(&compressed);
+    QCompressionDevice device(&buffer);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    const QByteArray result = device.readAll();
+    QVERIFY(result.size() < data.size());
+    QVERIFY(data.startsWith(result));
+    QVERIFY(!device.errorString().isEmpty());
+}
+
+void tst_QCompressionDevice::corrupt()
+{
+    QByteArray garbage("this is not compressed data at all");
+    QBuffer buffer(&garbage);
+    QCompressionDevice device(&buffer);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    char c;
+    QCOMPARE(device.read(&c, 1), qint64(-1));
+    QVERIFY(!device.errorString().isEmpty());
+}
+
+void tst_QCompressionDevice::openUnderlyingDevice()
+{
+    QByteArray compressed;
+    QBuffer buffer(&compressed);
+    {
+        QCompressionDevice device(&buffer);
+        QVERIFY(device.open(QIODevice::WriteOnly));
+        QVERIFY(buffer.isWritable());
+        QVERIFY(!buffer.isReadable());
+        device.write("data");
+        device.close();
+        QVERIFY(!buffer.isOpen());
+    }
+    {
+        QCompressionDevice device(&buffer);
+        QVERIFY(device.open(QIODevice::ReadOnly));
+        QVERIFY(buffer.isReadable());
+        QVERIFY(!buffer.isWritable());
+        QCOMPARE(device.readAll(), QByteArray("data"));
+    }
+    QVERIFY(!buffer.isOpen());
+}
+
+QTEST_APPLESS_MAIN(tst_QCompressionDevice)
+#include "tst_qcompressiondevice.moc"
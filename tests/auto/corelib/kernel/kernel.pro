@@ -5,6 +5,7 @@ SUBDIRS=\
     qelapsedtimer \
     qeventdispatcher \
     qeventloop \
+    qeventloopinstrumentation \
     qmath \
     qmetaobject \
     qmetaobjectbuilder \
@@ -34,6 +35,7 @@ SUBDIRS=\
     qsocketnotifier
 
 !qtConfig(private_tests): SUBDIRS -= \
+    qeventloopinstrumentation \
     qsocketnotifier \
     qsharedmemory
 
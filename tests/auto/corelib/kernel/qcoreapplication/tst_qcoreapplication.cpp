@@ -532,6 +532,116 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class SequenceEvent : public QEvent
+{
+public:
+    SequenceEvent(int producer, int sequence)
+        : QEvent(QEvent::User), producer(producer), sequence(sequence)
+    { }
+
+    int producer;
+    int sequence;
+};
+
+class SequenceEventReceiver : public QObject
+{
+public:
+    QVector<QPair<int, int> > received;
+    bool event(QEvent *event) override
+    {
+        if (event->type() != QEvent::User)
+            return QObject::event(event);
+        SequenceEvent *e = static_cast<SequenceEvent *>(event);
+        received.append(qMakePair(e->producer, e->sequence));
+        return true;
+    }
+};
+
+class SequenceEventProducer : public QThread
+{
+public:
+    SequenceEventProducer(QObject *receiver, int producer, int count)
+        : receiver(receiver), producer(producer), count(count)
+    { }
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i)
+            QCoreApplication::postEvent(receiver, new SequenceEvent(producer, i));
+    }
+
+private:
+    QObject *receiver;
+    int producer;
+    int count;
+};
+
+void tst_QCoreApplication::postEventFromMultipleThreads()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const int producerCount = 4;
+    const int eventCount = 1000;
+    SequenceEventReceiver receiver;
+
+    {
+        // events of each producer arrive in the order they were posted
+        QVector<SequenceEventProducer *> producers;
+        for (int i = 0; i < producerCount; ++i)
+            producers.append(new SequenceEventProducer(&receiver, i, eventCount));
+        for (SequenceEventProducer *producer : qAsConst(producers))
+            producer->start();
+        for (SequenceEventProducer *producer : qAsConst(producers))
+            QVERIFY(producer->wait(30000));
+        qDeleteAll(producers);
+
+        QCoreApplication::sendPostedEvents();
+        QCOMPARE(receiver.received.size(), producerCount * eventCount);
+        QVector<int> next(producerCount, 0);
+        for (const auto &pair : qAsConst(receiver.received))
+            QCOMPARE(pair.second, next[pair.first]++);
+        receiver.received.clear();
+    }
+
+    {
+        // priorities are honored for events posted from another thread
+        struct PriorityProducer : QThread
+        {
+            QObject *receiver;
+            void run() override
+            {
+                QCoreApplication::postEvent(receiver, new SequenceEvent(0, 0), Qt::LowEventPriority);
+                QCoreApplication::postEvent(receiver, new SequenceEvent(0, 1));
+                QCoreApplication::postEvent(receiver, new SequenceEvent(0, 2), Qt::HighEventPriority);
+            }
+        } producer;
+        producer.receiver = &receiver;
+        producer.start();
+        QVERIFY(producer.wait(30000));
+
+        QCoreApplication::sendPostedEvents();
+        QCOMPARE(receiver.received.size(), 3);
+        QCOMPARE(receiver.received.at(0).second, 2);
+        QCOMPARE(receiver.received.at(1).second, 1);
+        QCOMPARE(receiver.received.at(2).second, 0);
+        receiver.received.clear();
+    }
+
+    {
+        // events posted from another thread can be removed before delivery
+        SequenceEventProducer producer(&receiver, 0, 10);
+        producer.start();
+        QVERIFY(producer.wait(30000));
+
+        QCoreApplication::removePostedEvents(&receiver, QEvent::User);
+        QCoreApplication::sendPostedEvents();
+        QVERIFY(receiver.received.isEmpty());
+    }
+}
 #endif // QT_CONFIG(thread)
 
 void tst_QCoreApplication::applicationPid()
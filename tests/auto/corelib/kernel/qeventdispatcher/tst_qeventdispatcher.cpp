@@ -34,6 +34,13 @@
 #endif
 #include <QtTest/QtTest>
 
+#ifdef Q_OS_LINUX
+#  include <QtCore/QSocketNotifier>
+#  include <QtCore/QTemporaryFile>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
@@ -67,6 +74,10 @@ private slots:
     void sendPostedEvents_data();
     void sendPostedEvents();
     void processEventsOnlySendsQueuedEvents();
+#ifdef Q_OS_LINUX
+    void unixBackends_data();
+    void unixBackends();
+#endif
 };
 
 bool tst_QEventDispatcher::event(QEvent *e)
@@ -314,5 +325,146 @@ void tst_QEventDispatcher::processEventsOnlySendsQueuedEvents()
     QCOMPARE(object.eventsReceived, 4);
 }
 
+#ifdef Q_OS_LINUX
+class UnixBackendThread : public QThread
+{
+public:
+    explicit UnixBackendThread(bool edgeTriggered) : edgeTriggered(edgeTriggered) {}
+
+    QString failure;
+
+protected:
+    void run() override
+    {
+        check();
+        // leave the loop running so that quit() from the main thread
+        // exercises the cross-thread wake up
+        if (failure.isEmpty())
+            exec();
+    }
+
+private:
+    static void spin(int msecs)
+    {
+        QEventLoop loop;
+        QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    void check()
+    {
+#define CHECK(cond) \
+        do { \
+            if (!(cond)) { \
+                failure = QString::fromLatin1("%1 (line %2)").arg(QLatin1String(#cond)).arg(__LINE__); \
+                return; \
+            } \
+        } while (false)
+
+        int fds[2];
+        CHECK(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        struct Closer {
+            int *fds;
+            ~Closer() { ::close(fds[0]); ::close(fds[1]); }
+        } closer = { fds };
+
+        char buf[16];
+        int reads = 0;
+        QSocketNotifier reader(fds[0], QSocketNotifier::Read);
+        QObject::connect(&reader, &QSocketNotifier::activated, [&reads]() { ++reads; });
+
+        CHECK(::write(fds[1], "a", 1) == 1);
+        spin(50);
+        // unread data keeps firing level-triggered notifiers only
+        if (edgeTriggered)
+            CHECK(reads == 1);
+        else
+            CHECK(reads > 1);
+
+        CHECK(::read(fds[0], buf, sizeof(buf)) == 1);
+        reads = 0;
+        spin(50);
+        CHECK(reads == 0);
+
+        CHECK(::write(fds[1], "b", 1) == 1);
+        spin(50);
+        CHECK(reads > 0);
+        CHECK(::read(fds[0], buf, sizeof(buf)) == 1);
+
+        reader.setEnabled(false);
+        CHECK(::write(fds[1], "c", 1) == 1);
+        reads = 0;
+        spin(50);
+        CHECK(reads == 0);
+        reader.setEnabled(true);
+        spin(50);
+        CHECK(reads > 0);
+        CHECK(::read(fds[0], buf, sizeof(buf)) == 1);
+
+        int writes = 0;
+        QSocketNotifier writer(fds[1], QSocketNotifier::Write);
+        QObject::connect(&writer, &QSocketNotifier::activated, [&writes]() { ++writes; });
+        spin(50);
+        CHECK(writes > 0);
+        writer.setEnabled(false);
+
+        // regular files cannot be watched with epoll and are always ready
+        QTemporaryFile file;
+        CHECK(file.open());
+        int fileReads = 0;
+        QSocketNotifier fileReader(file.handle(), QSocketNotifier::Read);
+        QObject::connect(&fileReader, &QSocketNotifier::activated, [&fileReads]() { ++fileReads; });
+        spin(50);
+        CHECK(fileReads > 0);
+        fileReader.setEnabled(false);
+
+        // timers must not fire early, even with sub-millisecond remainders
+        QElapsedTimer elapsed;
+        elapsed.start();
+        spin(PreciseTimerInterval);
+        CHECK(elapsed.nsecsElapsed() >= PreciseTimerInterval * 1000000LL);
+#undef CHECK
+    }
+
+    const bool edgeTriggered;
+};
+
+void tst_QEventDispatcher::unixBackends_data()
+{
+    QTest::addColumn<QByteArray>("mode");
+    QTest::addColumn<bool>("edgeTriggered");
+
+    QTest::newRow("poll") << QByteArray("0") << false;
+    QTest::newRow("epoll") << QByteArray("1") << false;
+    QTest::newRow("epoll-edge") << QByteArray("2") << true;
+}
+
+// QEventDispatcherUNIX picks its backend when it is created, so each
+// backend is exercised in a fresh thread
+void tst_QEventDispatcher::unixBackends()
+{
+    QFETCH(QByteArray, mode);
+    QFETCH(bool, edgeTriggered);
+
+    const QByteArray oldMode = qgetenv("QT_EVENT_DISPATCHER_EPOLL");
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", mode);
+
+    UnixBackendThread thread(edgeTriggered);
+    thread.start();
+    // give the thread time to block in its event loop
+    QThread::msleep(500);
+    thread.quit();
+    const bool finished = thread.wait(5000);
+
+    if (oldMode.isNull())
+        qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+    else
+        qputenv("QT_EVENT_DISPATCHER_EPOLL", oldMode);
+
+    QVERIFY2(thread.failure.isEmpty(), qPrintable(thread.failure));
+    QVERIFY(finished);
+}
+#endif
+
 QTEST_MAIN(tst_QEventDispatcher)
 #include "tst_qeventdispatcher.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qeventloopinstrumentation
+QT = core-private testlib
+SOURCES = tst_qeventloopinstrumentation.cpp
@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtCore/qabstracteventdispatcher.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/private/qeventloopinstrumentation_p.h>
+
+class SlowObject : public QObject
+{
+    Q_OBJECT
+public:
+    bool event(QEvent *e) override
+    {
+        if (e->type() == QEvent::User) {
+            QThread::msleep(2);
+            return true;
+        }
+        return QObject::event(e);
+    }
+};
+
+struct Measurement
+{
+    QEventLoopMeasurement measurement;
+    quint64 value;
+    int eventType;
+    QByteArray className;
+};
+
+static QVector<Measurement> callbackMeasurements;
+
+static void instrumentationCallback(QEventLoopMeasurement measurement, quint64 value,
+                                    int eventType, const char *className)
+{
+    callbackMeasurements.append({ measurement, value, eventType, QByteArray(className) });
+}
+
+class tst_QEventLoopInstrumentation : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void histogram();
+    void disabled();
+    void eventDelivery();
+    void postedEventQueueDepth();
+    void timerLateness();
+    void loopIteration();
+    void callback();
+};
+
+void tst_QEventLoopInstrumentation::init()
+{
+    qt_resetEventLoopStatistics();
+    qt_setEventLoopInstrumentationEnabled(true);
+}
+
+void tst_QEventLoopInstrumentation::cleanup()
+{
+    qt_setEventLoopInstrumentationEnabled(false);
+    qt_setEventLoopInstrumentationCallback(nullptr);
+    callbackMeasurements.clear();
+}
+
+void tst_QEventLoopInstrumentation::histogram()
+{
+    QCOMPARE(QEventLoopHistogram::bucketOf(0), 0);
+    QCOMPARE(QEventLoopHistogram::bucketOf(1), 1);
+    QCOMPARE(QEventLoopHistogram::bucketOf(2), 2);
+    QCOMPARE(QEventLoopHistogram::bucketOf(3), 2);
+    QCOMPARE(QEventLoopHistogram::bucketOf(4), 3);
+    QCOMPARE(QEventLoopHistogram::bucketOf(1000), 10);
+    QCOMPARE(QEventLoopHistogram::bucketOf(std::numeric_limits<quint64>::max()),
+             int(QEventLoopHistogram::BucketCount) - 1);
+    QCOMPARE(QEventLoopHistogram::bucketUpperBound(0), quint64(0));
+    QCOMPARE(QEventLoopHistogram::bucketUpperBound(10), quint64(1023));
+
+    QEventLoopHistogram histogram = QEventLoopHistogram();
+    QCOMPARE(histogram.percentile(50), quint64(0));
+    for (int i = 0; i < 90; ++i)
+        histogram.add(10);
+    for (int i = 0; i < 10; ++i)
+        histogram.add(1000);
+    QCOMPARE(histogram.count, quint64(100));
+    QCOMPARE(histogram.total, quint64(90 * 10 + 10 * 1000));
+    QCOMPARE(histogram.maximum, quint64(1000));
+    QCOMPARE(histogram.buckets[4], quint64(90));
+    QCOMPARE(histogram.buckets[10], quint64(10));
+    QCOMPARE(histogram.percentile(50), quint64(15));
+    QCOMPARE(histogram.percentile(90), quint64(15));
+    QCOMPARE(histogram.percentile(91), quint64(1000));
+    QCOMPARE(histogram.percentile(100), quint64(1000));
+}
+
+void tst_QEventLoopInstrumentation::disabled()
+{
+    qt_setEventLoopInstrumentationEnabled(false);
+
+    SlowObject object;
+    QEvent event(QEvent::User);
+    QCoreApplication::sendEvent(&object, &event);
+    QCoreApplication::postEvent(&object, new QEvent(QEvent::User));
+    QCoreApplication::sendPostedEvents();
+
+    const QEventLoopStatistics statistics = qt_eventLoopStatistics();
+    for (const QEventLoopHistogram &histogram : statistics.measurements)
+        QCOMPARE(histogram.count, quint64(0));
+    QVERIFY(statistics.eventTypes.isEmpty());
+    QVERIFY(statistics.receiverClasses.isEmpty());
+}
+
+void tst_QEventLoopInstrumentation::eventDelivery()
+{
+    SlowObject object;
+    QEvent event(QEvent::User);
+    QCoreApplication::sendEvent(&object, &event);
+
+    // the receiver is deleted during the delivery
+    SlowObject *deleted = new SlowObject;
+    deleted->deleteLater();
+    QCoreApplication::sendPostedEvents(deleted, QEvent::DeferredDelete);
+
+    const QEventLoopStatistics statistics = qt_eventLoopStatistics();
+    const QEventLoopHistogram slow = statistics.receiverClasses.value("SlowObject");
+    QCOMPARE(slow.count, quint64(2));
+    QVERIFY(slow.maximum >= 2 * 1000 * 1000);
+    QCOMPARE(statistics.eventTypes.value(QEvent::User).count, quint64(1));
+    QCOMPARE(statistics.eventTypes.value(QEvent::DeferredDelete).count, quint64(1));
+    QVERIFY(statistics.measurements[QEventLoopEventDelivery].count >= 2);
+
+    qt_resetEventLoopStatistics();
+    QVERIFY(qt_eventLoopStatistics().receiverClasses.isEmpty());
+}
+
+void tst_QEventLoopInstrumentation::postedEventQueueDepth()
+{
+    SlowObject object;
+    QCoreApplication::sendPostedEvents();
+    qt_resetEventLoopStatistics();
+
+    for (int i = 0; i < 3; ++i)
+        QCoreApplication::postEvent(&object, new QEvent(QEvent::User));
+    QCoreApplication::sendPostedEvents();
+
+    const QEventLoopHistogram depth =
+            qt_eventLoopStatistics().measurements[QEventLoopPostedEventQueueDepth];
+    QCOMPARE(depth.count, quint64(1));
+    QCOMPARE(depth.maximum, quint64(3));
+    QCOMPARE(qt_eventLoopStatistics().receiverClasses.value("SlowObject").count, quint64(3));
+}
+
+void tst_QEventLoopInstrumentation::timerLateness()
+{
+    QTimer timer;
+    timer.setTimerType(Qt::PreciseTimer);
+    timer.setSingleShot(true);
+    QSignalSpy spy(&timer, &QTimer::timeout);
+    timer.start(10);
+    QVERIFY(spy.wait());
+
+    const QEventLoopStatistics statistics = qt_eventLoopStatistics();
+    QVERIFY(statistics.measurements[QEventLoopTimerLateness].count >= 1);
+    QVERIFY(statistics.receiverClasses.value("QTimer").count >= 1);
+    QVERIFY(statistics.eventTypes.value(QEvent::Timer).count >= 1);
+}
+
+void tst_QEventLoopInstrumentation::loopIteration()
+{
+    if (!QAbstractEventDispatcher::instance()->inherits("QEventDispatcherUNIX"))
+        QSKIP("Only QEventDispatcherUNIX measures its iterations");
+
+    for (int i = 0; i < 3; ++i)
+        QCoreApplication::processEvents();
+
+    QVERIFY(qt_eventLoopStatistics().measurements[QEventLoopIteration].count >= 3);
+}
+
+void tst_QEventLoopInstrumentation::callback()
+{
+    qt_setEventLoopInstrumentationCallback(instrumentationCallback);
+
+    SlowObject object;
+    QEvent event(QEvent::User);
+    QCoreApplication::sendEvent(&object, &event);
+
+    QCOMPARE(callbackMeasurements.size(), 1);
+    QCOMPARE(callbackMeasurements.at(0).measurement, QEventLoopEventDelivery);
+    QCOMPARE(callbackMeasurements.at(0).eventType, int(QEvent::User));
+    QCOMPARE(callbackMeasurements.at(0).className, QByteArray("SlowObject"));
+    QVERIFY(callbackMeasurements.at(0).value >= 2 * 1000 * 1000);
+
+    qt_setEventLoopInstrumentationCallback(nullptr);
+    QCoreApplication::sendEvent(&object, &event);
+    QCOMPARE(callbackMeasurements.size(), 1);
+}
+
+QTEST_MAIN(tst_QEventLoopInstrumentation)
+#include "tst_qeventloopinstrumentation.moc"
@@ -72,6 +72,7 @@ private:
 private slots:
     void defined();
     void threadSafety();
+    void lookupWhileRegistering();
     void namespaces();
     void qMetaTypeId();
     void properties();
@@ -456,6 +457,54 @@ void tst_QMetaType::threadSafety()
     QCOMPARE(Bar::failureCount, 0);
 }
 
+class MetaTypeLookupThread : public QThread
+{
+    Q_OBJECT
+public:
+    QVector<QByteArray> names;
+    QVector<int> ids;
+    QAtomicInt stop;
+    int failureCount = 0;
+
+protected:
+    void run() override
+    {
+        while (!stop.load()) {
+            for (int i = 0; i < names.size(); ++i) {
+                if (QMetaType::type(names.at(i)) != ids.at(i)
+                    || QMetaType::typeName(ids.at(i)) != names.at(i)
+                    || QMetaType::sizeOf(ids.at(i)) != int(sizeof(Bar))) {
+                    ++failureCount;
+                }
+            }
+        }
+    }
+};
+
+void tst_QMetaType::lookupWhileRegistering()
+{
+    // the custom types are looked up without locking, make sure that the
+    // registry growing meanwhile doesn't affect the existing types
+    MetaTypeLookupThread lookupThread;
+    for (int i = 0; i < 20; ++i) {
+        const QByteArray name = "LookedUpBar" + QByteArray::number(i);
+        lookupThread.names.append(name);
+        lookupThread.ids.append(qRegisterMetaType<Bar>(name.constData()));
+    }
+    lookupThread.start();
+
+    for (int i = 0; i < 2000; ++i) {
+        const QByteArray name = "RegisteredWhileLookingUpBar" + QByteArray::number(i);
+        const int id = qRegisterMetaType<Bar>(name.constData());
+        QCOMPARE(QMetaType::type(name), id);
+        QCOMPARE(QMetaType::typeName(id), name.constData());
+    }
+
+    lookupThread.stop.store(1);
+    QVERIFY(lookupThread.wait());
+    QCOMPARE(lookupThread.failureCount, 0);
+}
+
 namespace TestSpace
 {
     struct Foo { double d; };
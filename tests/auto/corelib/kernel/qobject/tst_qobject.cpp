@@ -50,6 +50,8 @@
 #endif
 
 #include <math.h>
+#include <algorithm>
+#include <memory>
 
 class tst_QObject : public QObject
 {
@@ -98,6 +100,8 @@ private slots:
     void connectToSender();
     void qobjectConstCast();
     void uniqConnection();
+    void coalescedConnection();
+    void coalescedConnectionAcrossThreads();
     void uniqConnectionPtr();
     void interfaceIid();
     void deleteQObjectWhenDeletingEvent();
@@ -144,6 +148,7 @@ private slots:
     void connectStaticSlotWithObject();
     void disconnectDoesNotLeakFunctor();
     void contextDoesNotLeakFunctor();
+    void disconnectWhileEmittingInOtherThread();
     void connectBase();
     void connectWarnings();
     void qmlConnect();
@@ -3535,6 +3540,119 @@ void tst_QObject::uniqConnection()
     delete r2;
 }
 
+struct UnqueueableType {};
+
+class UnqueueableSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void value(UnqueueableType);
+};
+
+void tst_QObject::coalescedConnection()
+{
+    SenderObject sender;
+    QObject context;
+    QVector<int> values;
+    QStringList strings;
+    int plainCount = 0;
+    connect(&sender, &SenderObject::signal7, &context, [&](int i, const QString &s) {
+        values << i;
+        strings << s;
+    }, Qt::ConnectionType(Qt::QueuedConnection | QObjectPrivate::CoalescedConnection));
+    connect(&sender, &SenderObject::signal7, &context, [&] { ++plainCount; }, Qt::QueuedConnection);
+
+    // only the latest arguments are delivered, once
+    for (int i = 0; i < 10; ++i)
+        emit sender.signal7(i, QString::number(i));
+    QVERIFY(values.isEmpty());
+    QCoreApplication::sendPostedEvents(&context, QEvent::MetaCall);
+    QCOMPARE(values, QVector<int>() << 9);
+    QCOMPARE(strings, QStringList() << QStringLiteral("9"));
+    QCOMPARE(plainCount, 10);
+
+    // once delivered, the next emission queues a new call
+    emit sender.signal7(10, QStringLiteral("10"));
+    QCoreApplication::sendPostedEvents(&context, QEvent::MetaCall);
+    QCOMPARE(values, QVector<int>() << 9 << 10);
+
+    // string based connections, and removal of the pending call
+    ReceiverObject receiver;
+    receiver.reset();
+    QVERIFY(connect(&sender, SIGNAL(signal1()), &receiver, SLOT(slot1()),
+                    Qt::ConnectionType(Qt::QueuedConnection | QObjectPrivate::CoalescedConnection)));
+    sender.emitSignal1();
+    sender.emitSignal1();
+    sender.emitSignal1();
+    QCOMPARE(receiver.count_slot1, 0);
+    QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+    QCOMPARE(receiver.count_slot1, 1);
+
+    sender.emitSignal1();
+    QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+    sender.emitSignal1();
+    sender.emitSignal1();
+    QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+    QCOMPARE(receiver.count_slot1, 2);
+
+    // the flag is ignored for direct calls
+    QVERIFY(connect(&sender, SIGNAL(signal2()), &receiver, SLOT(slot2()),
+                    Qt::ConnectionType(Qt::AutoConnection | QObjectPrivate::CoalescedConnection)));
+    sender.emitSignal2();
+    sender.emitSignal2();
+    QCOMPARE(receiver.count_slot2, 2);
+
+    // the argument types are checked as for other queued connections
+    UnqueueableSender unqueueable1, unqueueable2;
+    QTest::ignoreMessage(QtWarningMsg, "QObject::connect: Cannot queue arguments of type 'UnqueueableType'\n"
+                         "(Make sure 'UnqueueableType' is registered using qRegisterMetaType().)");
+    QVERIFY(!connect(&unqueueable1, SIGNAL(value(UnqueueableType)),
+                     &unqueueable2, SIGNAL(value(UnqueueableType)),
+                     Qt::ConnectionType(Qt::QueuedConnection | QObjectPrivate::CoalescedConnection)));
+}
+
+class CoalescingEmitterThread : public QThread
+{
+    Q_OBJECT
+public:
+    int count = 10000;
+
+signals:
+    void value(int);
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i)
+            emit value(i);
+    }
+};
+
+void tst_QObject::coalescedConnectionAcrossThreads()
+{
+    CoalescingEmitterThread thread;
+    QObject context;
+    QEventLoop loop;
+    QVector<int> values;
+    connect(&thread, &CoalescingEmitterThread::value, &context, [&](int i) {
+        values << i;
+        if (i == thread.count - 1)
+            loop.quit();
+    }, Qt::ConnectionType(Qt::AutoConnection | QObjectPrivate::CoalescedConnection));
+
+    thread.start();
+    QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+    loop.exec();
+    QVERIFY(thread.wait(30000));
+
+    // values arrive in order, and the last one is never lost
+    QVERIFY(!values.isEmpty());
+    QVERIFY(values.size() <= thread.count);
+    QCOMPARE(values.last(), thread.count - 1);
+    QVERIFY(std::is_sorted(values.constBegin(), values.constEnd()));
+    QCOMPARE(std::adjacent_find(values.constBegin(), values.constEnd()), values.constEnd());
+}
+
 void tst_QObject::uniqConnectionPtr()
 {
     SenderObject *s = new SenderObject;
@@ -6717,6 +6835,52 @@ void tst_QObject::contextDoesNotLeakFunctor()
     QCOMPARE(countedStructObjectsCount, 0);
 }
 
+class ContinuousEmitterThread : public QThread
+{
+    Q_OBJECT
+public:
+    SenderObject *sender = nullptr;
+    QAtomicInt stop;
+
+protected:
+    void run() override
+    {
+        while (!stop.load())
+            sender->emitSignal1();
+    }
+};
+
+void tst_QObject::disconnectWhileEmittingInOtherThread()
+{
+    // The emitting thread doesn't lock the sender, so the connections removed
+    // while it is emitting must stay usable until it is done with them.
+    SenderObject sender;
+    ContinuousEmitterThread thread;
+    thread.sender = &sender;
+    thread.start();
+
+    QAtomicInt calls;
+    auto tracker = std::make_shared<int>(0);
+    for (int i = 0; i < 2000; ++i) {
+        QObject *context = new QObject;
+        QMetaObject::Connection c = connect(&sender, &SenderObject::signal1, context,
+                                            [tracker, &calls] { calls.ref(); },
+                                            Qt::DirectConnection);
+        connect(&sender, &SenderObject::signal1, context,
+                [tracker, &calls] { calls.ref(); }, Qt::DirectConnection);
+        QThread::yieldCurrentThread();
+        if (i % 2)
+            QVERIFY(QObject::disconnect(c));
+        delete context;
+    }
+
+    thread.stop.store(1);
+    QVERIFY(thread.wait(30000));
+
+    // every functor has been destroyed, by this thread or by the emitting one
+    QCOMPARE(tracker.use_count(), 1L);
+}
+
 class SubSender : public SenderObject {
     Q_OBJECT
 };
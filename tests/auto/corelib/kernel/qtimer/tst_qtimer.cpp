@@ -63,6 +63,7 @@ private slots:
     void deleteLaterOnQTimer(); // long name, don't want to shadow QObject::deleteLater()
     void moveToThread();
     void restartedTimerFiresTooSoon();
+    void manyTimersFireInOrder();
     void timerFiresOnlyOncePerProcessEvents_data();
     void timerFiresOnlyOncePerProcessEvents();
     void timerIdPersistsAfterThreadExit();
@@ -546,6 +547,46 @@ void tst_QTimer::restartedTimerFiresTooSoon()
     QCOMPARE(object.eventLoop.exec(), 0);
 }
 
+class TimerOrderRecorder : public QObject
+{
+public:
+    QVector<int> fired;
+
+protected:
+    void timerEvent(QTimerEvent *event) override
+    {
+        fired.append(event->timerId());
+        killTimer(event->timerId());
+    }
+};
+
+void tst_QTimer::manyTimersFireInOrder()
+{
+    // start timers out of order and stop some of them again; the others
+    // must fire by timeout, and timers with equal timeouts by start order
+    TimerOrderRecorder recorder;
+    QHash<int, QPair<int, int>> started; // id -> (interval, start index)
+    for (int i = 0; i < 300; ++i) {
+        const int interval = 20 + 5 * ((i * 7) % 20);
+        const int id = recorder.startTimer(interval, Qt::PreciseTimer);
+        QVERIFY(id > 0);
+        if (i % 3 == 0)
+            recorder.killTimer(id);
+        else
+            started.insert(id, qMakePair(interval, i));
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(recorder.fired.size(), started.size(), 5000);
+    for (int i = 1; i < recorder.fired.size(); ++i) {
+        const QPair<int, int> previous = started.value(recorder.fired.at(i - 1));
+        const QPair<int, int> current = started.value(recorder.fired.at(i));
+        QVERIFY2(previous < current,
+                 qPrintable(QString::fromLatin1("timer %1 (%2 ms, #%3) fired after timer %4 (%5 ms, #%6)")
+                            .arg(recorder.fired.at(i)).arg(current.first).arg(current.second)
+                            .arg(recorder.fired.at(i - 1)).arg(previous.first).arg(previous.second)));
+    }
+}
+
 class LongLastingSlotClass : public QObject
 {
     Q_OBJECT
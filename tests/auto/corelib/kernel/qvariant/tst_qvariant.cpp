@@ -285,6 +285,8 @@ private slots:
 
     void fromStdVariant();
 
+    void sharedDataFreedInOtherThread();
+
 private:
     void dataStream_data(QDataStream::Version version);
     void loadQVariantFromDataStream(QDataStream::Version version);
@@ -4998,5 +5000,55 @@ void tst_QVariant::fromStdVariant()
 #endif
 }
 
+struct BigValue
+{
+    double values[6];
+};
+Q_DECLARE_METATYPE(BigValue)
+
+class VariantThread : public QThread
+{
+public:
+    QVector<QVariant> variants;
+
+protected:
+    void run() override
+    {
+        // frees the variants created by the main thread, and creates new
+        // ones for it to free
+        variants.clear();
+        for (int i = 0; i < 1000; ++i) {
+            variants.append(QRectF(i, i, 1, 1));
+            variants.append(QVariant::fromValue(BigValue{ { double(i) } }));
+        }
+    }
+};
+
+void tst_QVariant::sharedDataFreedInOtherThread()
+{
+    // values larger than QVariant::Private::Data are allocated separately
+    VariantThread thread;
+    for (int i = 0; i < 1000; ++i) {
+        thread.variants.append(QLineF(i, i, 1, 1));
+        thread.variants.append(QVariant::fromValue(BigValue{ { double(i) } }));
+    }
+    thread.start();
+    QVERIFY(thread.wait());
+
+    QCOMPARE(thread.variants.size(), 2000);
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(thread.variants.at(2 * i).toRectF(), QRectF(i, i, 1, 1));
+        QCOMPARE(thread.variants.at(2 * i + 1).value<BigValue>().values[0], double(i));
+    }
+    thread.variants.clear();
+
+    // and new ones can be allocated after the others were freed
+    QVector<QVariant> variants;
+    for (int i = 0; i < 1000; ++i)
+        variants.append(QRectF(i, i, 2, 2));
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(variants.at(i).toRectF(), QRectF(i, i, 2, 2));
+}
+
 QTEST_MAIN(tst_QVariant)
 #include "tst_qvariant.moc"
@@ -37,6 +37,7 @@
 #include <qthreadpool.h>
 #include <qexception.h>
 #include <qrandom.h>
+#include <private/qfuture_p.h>
 #include <private/qfutureinterface_p.h>
 
 // COM interface macro.
@@ -75,6 +76,17 @@ private slots:
     void nestedExceptions();
 #endif
     void nonGlobalThreadPool();
+    void then();
+    void thenMoveOnly();
+    void thenUnfinishedParent();
+    void thenOnThreadPool();
+    void thenCanceled();
+#ifndef QT_NO_EXCEPTIONS
+    void thenExceptions();
+    void onFailed();
+#endif
+    void whenAll();
+    void whenAny();
 };
 
 void tst_QFuture::resultStore()
@@ -1490,5 +1502,415 @@ void tst_QFuture::nonGlobalThreadPool()
     }
 }
 
+void tst_QFuture::then()
+{
+    // continuation set before the future finishes
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> doubled = QtPrivate::futureThen(promise.future(), [](int value) {
+            return value * 2;
+        });
+        QFuture<QString> future = QtPrivate::futureThen(doubled, [](int value) {
+            return QString::number(value);
+        });
+        QVERIFY(!future.isFinished());
+
+        const int value = 21;
+        promise.reportFinished(&value);
+        QVERIFY(future.isFinished());
+        QCOMPARE(future.result(), QString("42"));
+    }
+
+    // continuation set after the future finished runs right away
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        const int value = 42;
+        promise.reportFinished(&value);
+
+        bool called = false;
+        QFuture<void> future = QtPrivate::futureThen(promise.future(), [&called](int result) {
+            QCOMPARE(result, 42);
+            called = true;
+        });
+        QVERIFY(called);
+        QVERIFY(future.isFinished());
+        QVERIFY(!future.isCanceled());
+    }
+
+    // void futures, and continuations that take the future itself
+    {
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        int calls = 0;
+        QFuture<void> first = QtPrivate::futureThen(promise.future(), [&calls]() { ++calls; });
+        QFuture<int> future = QtPrivate::futureThen(first, [&calls](QFuture<void> parent) {
+            ++calls;
+            return parent.isFinished() ? 1 : 0;
+        });
+        promise.reportFinished();
+        QCOMPARE(calls, 2);
+        QCOMPARE(future.result(), 1);
+    }
+
+    // several continuations of the same future run in order
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> parent = promise.future();
+        QList<int> order;
+        QtPrivate::futureThen(parent, [&order](int) { order.append(1); });
+        QtPrivate::futureThen(parent, [&order](int) { order.append(2); });
+        const int value = 0;
+        promise.reportFinished(&value);
+        QCOMPARE(order, QList<int>() << 1 << 2);
+    }
+
+    // continuations of a future that never finishes are destroyed with it
+    {
+        QSharedPointer<int> tracker(new int(0));
+        QWeakPointer<int> weakTracker = tracker;
+        {
+            QFutureInterface<int> promise;
+            promise.reportStarted();
+            QtPrivate::futureThen(promise.future(), [tracker](int) {});
+        }
+        tracker.reset();
+        QVERIFY(weakTracker.isNull());
+    }
+}
+
+void tst_QFuture::thenUnfinishedParent()
+{
+    // the futures of continuations whose future went away unfinished are
+    // canceled, instead of leaving waitForFinished() waiting forever
+    QThreadPool pool;
+    QFuture<int> future;
+    QFuture<int> pooled;
+    QFuture<QList<QFuture<int> > > all;
+#ifndef QT_NO_EXCEPTIONS
+    QFuture<int> failed;
+#endif
+    bool called = false;
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        future = QtPrivate::futureThen(promise.future(), [&called](int value) {
+            called = true;
+            return value;
+        });
+        pooled = QtPrivate::futureThen(promise.future(), &pool, [&called](int value) {
+            called = true;
+            return value;
+        });
+        const QVector<QFuture<int> > futures(1, promise.future());
+        all = QtPrivate::whenAll(futures.constBegin(), futures.constEnd());
+#ifndef QT_NO_EXCEPTIONS
+        failed = QtPrivate::futureOnFailed(promise.future(), []() { return -1; });
+#endif
+        QVERIFY(!future.isFinished());
+    }
+
+    future.waitForFinished();
+    QVERIFY(future.isCanceled());
+    pooled.waitForFinished();
+    QVERIFY(pooled.isCanceled());
+    all.waitForFinished();
+    QVERIFY(all.isCanceled());
+#ifndef QT_NO_EXCEPTIONS
+    failed.waitForFinished();
+    QVERIFY(failed.isCanceled());
+#endif
+    QVERIFY(!called);
+}
+
+struct MoveOnlyContinuation
+{
+    explicit MoveOnlyContinuation(int offset) : offset(new int(offset)) {}
+    MoveOnlyContinuation(MoveOnlyContinuation &&) = default;
+    MoveOnlyContinuation(const MoveOnlyContinuation &) = delete;
+
+    int operator()(int value) const { return value + *offset; }
+
+    std::unique_ptr<int> offset;
+};
+
+void tst_QFuture::thenMoveOnly()
+{
+    QThreadPool pool;
+    QFutureInterface<int> promise;
+    promise.reportStarted();
+    QFuture<int> future = QtPrivate::futureThen(promise.future(), MoveOnlyContinuation(1));
+    QFuture<int> pooled = QtPrivate::futureThen(promise.future(), &pool, MoveOnlyContinuation(2));
+
+    const int value = 40;
+    promise.reportFinished(&value);
+    QCOMPARE(future.result(), 41);
+    QCOMPARE(pooled.result(), 42);
+    QVERIFY(pool.waitForDone());
+}
+
+void tst_QFuture::thenOnThreadPool()
+{
+    QThreadPool pool;
+    QFutureInterface<int> promise;
+    promise.reportStarted();
+
+    QThread *mainThread = QThread::currentThread();
+    QAtomicPointer<QThread> continuationThread;
+    QFuture<int> future = QtPrivate::futureThen(promise.future(), &pool, [&continuationThread](int value) {
+        continuationThread.store(QThread::currentThread());
+        return value + 1;
+    });
+
+    const int value = 41;
+    promise.reportFinished(&value);
+    QCOMPARE(future.result(), 42);
+    QVERIFY(pool.waitForDone());
+    QVERIFY(continuationThread.load());
+    QVERIFY(continuationThread.load() != mainThread);
+}
+
+void tst_QFuture::thenCanceled()
+{
+    // a canceled future cancels its continuations instead of calling them
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        bool called = false;
+        QFuture<int> first = QtPrivate::futureThen(promise.future(), [&called](int value) {
+            called = true;
+            return value;
+        });
+        QFuture<int> future = QtPrivate::futureThen(first, [&called](int value) {
+            called = true;
+            return value;
+        });
+        promise.reportCanceled();
+        promise.reportFinished();
+        QVERIFY(!called);
+        QVERIFY(future.isFinished());
+        QVERIFY(future.isCanceled());
+    }
+
+    // unless they take the future itself
+    {
+        QFuture<int> canceled;
+        QFuture<bool> future = QtPrivate::futureThen(canceled, [](QFuture<int> parent) {
+            return parent.isCanceled();
+        });
+        QVERIFY(future.isFinished());
+        QVERIFY(future.result());
+    }
+
+    // a canceled continuation is not called
+    {
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        bool called = false;
+        QFuture<void> future = QtPrivate::futureThen(promise.future(), [&called]() { called = true; });
+        future.cancel();
+        promise.reportFinished();
+        QVERIFY(!called);
+        QVERIFY(future.isFinished());
+    }
+}
+
+#ifndef QT_NO_EXCEPTIONS
+
+void tst_QFuture::thenExceptions()
+{
+    // the exception of the future is passed on to its continuations
+    {
+        bool called = false;
+        QFuture<void> future = QtPrivate::futureThen(createDerivedExceptionFuture(), [&called]() {
+            called = true;
+        });
+        QVERIFY(!called);
+        QVERIFY(future.isFinished());
+        bool caught = false;
+        try {
+            future.waitForFinished();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // exceptions thrown by a continuation end up in the future it returns
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = QtPrivate::futureThen(promise.future(), [](int value) -> int {
+            if (value)
+                throw DerivedException();
+            return value;
+        });
+        const int value = 1;
+        promise.reportFinished(&value);
+        bool caught = false;
+        try {
+            future.result();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // and so do other exceptions
+    {
+        QFuture<void> future = QtPrivate::futureThen(createDerivedExceptionFuture(), [](QFuture<void>) {
+            throw 42;
+        });
+        bool caught = false;
+        try {
+            future.waitForFinished();
+        } catch (QUnhandledException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+}
+
+// does not reimplement raise()
+class ClonedException : public QException
+{
+public:
+    explicit ClonedException(int code = 0) : code(code) {}
+    ClonedException *clone() const override { return new ClonedException(*this); }
+
+    int code;
+};
+
+void tst_QFuture::onFailed()
+{
+    // the handler provides the result
+    {
+        QFuture<int> incremented = QtPrivate::futureThen(createExceptionResultFuture(), [](int value) {
+            return value + 1;
+        });
+        QFuture<int> future = QtPrivate::futureOnFailed(incremented, [](const QException &) {
+            return -1;
+        });
+        QCOMPARE(future.result(), -1);
+    }
+
+    // handlers without arguments handle every exception
+    {
+        bool called = false;
+        QFuture<void> future = QtPrivate::futureOnFailed(createDerivedExceptionFuture(), [&called]() {
+            called = true;
+        });
+        QVERIFY(called);
+        future.waitForFinished();
+        QVERIFY(!future.isCanceled());
+    }
+
+    // handlers for other exceptions are passed by
+    {
+        bool called = false;
+        QFuture<void> failed = QtPrivate::futureOnFailed(createExceptionFuture(),
+                                                         [&called](const DerivedException &) {
+            called = true;
+        });
+        QFuture<void> future = QtPrivate::futureThen(failed, [&called]() { called = true; });
+        QVERIFY(!called);
+        bool caught = false;
+        try {
+            future.waitForFinished();
+        } catch (QException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // exceptions are matched by their type, even without QException::raise()
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        promise.reportException(ClonedException(42));
+        promise.reportFinished();
+        QFuture<int> future = QtPrivate::futureOnFailed(promise.future(), [](ClonedException &e) {
+            return e.code;
+        });
+        QCOMPARE(future.result(), 42);
+    }
+
+    // and so are the results of futures that did not fail
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        bool called = false;
+        QFuture<int> future = QtPrivate::futureOnFailed(promise.future(), [&called]() {
+            called = true;
+            return -1;
+        });
+        promise.reportResult(1);
+        promise.reportResult(2);
+        promise.reportFinished();
+        QVERIFY(!called);
+        QCOMPARE(future.results(), QList<int>() << 1 << 2);
+    }
+}
+
+#endif // QT_NO_EXCEPTIONS
+
+void tst_QFuture::whenAll()
+{
+    QVector<QFutureInterface<int> > promises(3);
+    QVector<QFuture<int> > futures;
+    for (QFutureInterface<int> &promise : promises) {
+        promise.reportStarted();
+        futures.append(promise.future());
+    }
+
+    QFuture<QList<QFuture<int> > > all = QtPrivate::whenAll(futures.constBegin(), futures.constEnd());
+    for (int i = 0; i < promises.size(); ++i) {
+        QVERIFY(!all.isFinished());
+        promises[i].reportFinished(&i);
+    }
+    QVERIFY(all.isFinished());
+    const QList<QFuture<int> > results = all.result();
+    QCOMPARE(results.size(), 3);
+    for (int i = 0; i < results.size(); ++i)
+        QCOMPARE(results.at(i).result(), i);
+
+    // nothing to wait for
+    QVector<QFuture<int> > none;
+    QFuture<QList<QFuture<int> > > empty = QtPrivate::whenAll(none.constBegin(), none.constEnd());
+    QVERIFY(empty.isFinished());
+    QVERIFY(empty.result().isEmpty());
+}
+
+void tst_QFuture::whenAny()
+{
+    QVector<QFutureInterface<int> > promises(3);
+    QVector<QFuture<int> > futures;
+    for (QFutureInterface<int> &promise : promises) {
+        promise.reportStarted();
+        futures.append(promise.future());
+    }
+
+    QFuture<QtPrivate::WhenAnyResult<int> > any = QtPrivate::whenAny(futures.constBegin(), futures.constEnd());
+    QVERIFY(!any.isFinished());
+
+    const int value = 42;
+    promises[1].reportFinished(&value);
+    QVERIFY(any.isFinished());
+    QCOMPARE(any.result().index, 1);
+    QCOMPARE(any.result().future.result(), 42);
+
+    // the first one stays the result
+    promises[0].reportFinished(&value);
+    promises[2].reportFinished(&value);
+    QCOMPARE(any.result().index, 1);
+
+    QVector<QFuture<void> > none;
+    QFuture<QtPrivate::WhenAnyResult<void> > empty = QtPrivate::whenAny(none.constBegin(), none.constEnd());
+    QVERIFY(empty.isFinished());
+    QCOMPARE(empty.result().index, -1);
+}
+
 QTEST_MAIN(tst_QFuture)
 #include "tst_qfuture.moc"
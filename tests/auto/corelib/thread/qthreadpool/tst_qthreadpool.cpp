@@ -100,6 +100,10 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void startFromWorkerThread();
+    void priorityStartFromWorkerThread();
+    void tryTakeStartedFromWorkerThread();
+    void clearStartedFromWorkerThread();
 
 private:
     QMutex m_functionTestMutex;
@@ -1343,5 +1347,165 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+void tst_QThreadPool::startFromWorkerThread()
+{
+    // the runnables started from within a thread of the pool must run
+    // concurrently when there are threads available
+    class Child : public QRunnable
+    {
+    public:
+        QSemaphore &started;
+        QSemaphore &proceed;
+        Child(QSemaphore &started, QSemaphore &proceed) : started(started), proceed(proceed) {}
+        void run()
+        {
+            started.release();
+            proceed.acquire();
+            count.ref();
+        }
+    };
+    class Parent : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QSemaphore &started;
+        QSemaphore &proceed;
+        int children;
+        Parent(QThreadPool &pool, QSemaphore &started, QSemaphore &proceed, int children)
+            : pool(pool), started(started), proceed(proceed), children(children) {}
+        void run()
+        {
+            for (int i = 0; i < children; ++i)
+                pool.start(new Child(started, proceed));
+            if (started.tryAcquire(children, 60000))
+                count.ref();
+            proceed.release(children);
+        }
+    };
+
+    const int children = 3;
+    QSemaphore started;
+    QSemaphore proceed;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(children + 1);
+    count.store(0);
+    threadPool.start(new Parent(threadPool, started, proceed, children));
+    QVERIFY(threadPool.waitForDone(5 * 60 * 1000));
+    QCOMPARE(count.load(), children + 1);
+}
+
+void tst_QThreadPool::priorityStartFromWorkerThread()
+{
+    class Runner : public QRunnable
+    {
+    public:
+        QAtomicPointer<QRunnable> &ptr;
+        Runner(QAtomicPointer<QRunnable> &ptr) : ptr(ptr) {}
+        void run()
+        {
+            ptr.testAndSetRelaxed(0, this);
+        }
+    };
+    class Parent : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QAtomicPointer<QRunnable> &ptr;
+        QRunnable *expected = nullptr;
+        Parent(QThreadPool &pool, QAtomicPointer<QRunnable> &ptr) : pool(pool), ptr(ptr) {}
+        void run()
+        {
+            pool.start(new Runner(ptr)); // kept with this thread
+            pool.start(expected = new Runner(ptr), 1);
+        }
+    };
+
+    QAtomicPointer<QRunnable> firstStarted;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    Parent *parent = new Parent(threadPool, firstStarted);
+    parent->setAutoDelete(false);
+    threadPool.start(parent);
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(firstStarted.load(), parent->expected);
+    delete parent;
+}
+
+void tst_QThreadPool::tryTakeStartedFromWorkerThread()
+{
+    class Child : public QRunnable
+    {
+    public:
+        Child() { setAutoDelete(false); }
+        void run() { count.ref(); }
+    };
+    class Parent : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        Child child;
+        bool taken = false;
+        Parent(QThreadPool &pool) : pool(pool) { setAutoDelete(false); }
+        void run()
+        {
+            // there is no other thread to run the child meanwhile
+            pool.start(&child);
+            taken = pool.tryTake(&child);
+        }
+    };
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    count.store(0);
+    Parent parent(threadPool);
+    threadPool.start(&parent);
+    QVERIFY(threadPool.waitForDone());
+    QVERIFY(parent.taken);
+    QCOMPARE(count.load(), 0);
+}
+
+void tst_QThreadPool::clearStartedFromWorkerThread()
+{
+    class Child : public QRunnable
+    {
+    public:
+        QAtomicInt &destroyed;
+        Child(QAtomicInt &destroyed) : destroyed(destroyed) {}
+        ~Child() { destroyed.ref(); }
+        void run() { count.ref(); }
+    };
+    class Parent : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QAtomicInt &destroyed;
+        QSemaphore &started;
+        QSemaphore &proceed;
+        Parent(QThreadPool &pool, QAtomicInt &destroyed, QSemaphore &started, QSemaphore &proceed)
+            : pool(pool), destroyed(destroyed), started(started), proceed(proceed) {}
+        void run()
+        {
+            for (int i = 0; i < 3; ++i)
+                pool.start(new Child(destroyed));
+            started.release();
+            proceed.acquire();
+        }
+    };
+
+    QAtomicInt destroyed;
+    QSemaphore started;
+    QSemaphore proceed;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    count.store(0);
+    threadPool.start(new Parent(threadPool, destroyed, started, proceed));
+    started.acquire();
+    threadPool.clear();
+    QCOMPARE(destroyed.load(), 3);
+    proceed.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.load(), 0);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -85,6 +85,8 @@ private slots:
     void rValueReferences();
 #endif
     void grow();
+    void smallBlocks();
+    void smallBlocksAcrossThreads();
 };
 
 template <class T> const T &const_(const T &t) { return t; }
@@ -1817,5 +1819,76 @@ void tst_QArrayData::grow()
     }
 }
 
+void tst_QArrayData::smallBlocks()
+{
+    // Small blocks allocated after others were released must be large
+    // enough for their capacity, also after having been reallocated
+    QVector<QArrayData *> blocks;
+    for (int round = 0; round < 4; ++round) {
+        for (size_t capacity = 1; capacity < 100; ++capacity) {
+            QArrayData::AllocationOptions options = (capacity % 3) ? QArrayData::Grow
+                                                                   : QArrayData::Default;
+            QArrayData *data = QArrayData::allocate(sizeof(char), Q_ALIGNOF(QArrayData),
+                                                    capacity, options);
+            QVERIFY(data);
+            if (capacity % 5 == 0) {
+                data = QArrayData::reallocateUnaligned(data, sizeof(char), capacity / 5, options);
+                QVERIFY(data);
+            }
+            ::memset(data->data(), char(capacity), data->alloc);
+            blocks.append(data);
+        }
+        for (QArrayData *data : qAsConst(blocks)) {
+            const char *bytes = static_cast<const char *>(data->data());
+            for (uint i = 0; i < data->alloc; ++i)
+                QCOMPARE(bytes[i], bytes[0]);
+        }
+        // release every other block first, so the later allocations mix sizes
+        for (int i = 0; i < blocks.size(); i += 2)
+            QArrayData::deallocate(blocks.at(i), sizeof(char), Q_ALIGNOF(QArrayData));
+        for (int i = 1; i < blocks.size(); i += 2)
+            QArrayData::deallocate(blocks.at(i), sizeof(char), Q_ALIGNOF(QArrayData));
+        blocks.clear();
+    }
+}
+
+class StringProducer : public QThread
+{
+public:
+    QStringList strings;
+    QStringList *toRelease = nullptr;
+
+    void run() override
+    {
+        for (int i = 0; i < 1000; ++i)
+            strings.append(QString::number(i));
+        // release strings created by another thread
+        if (toRelease)
+            toRelease->clear();
+    }
+};
+
+void tst_QArrayData::smallBlocksAcrossThreads()
+{
+    QStringList mainStrings;
+    for (int i = 0; i < 1000; ++i)
+        mainStrings.append(QString::number(i));
+
+    StringProducer producer;
+    producer.toRelease = &mainStrings;
+    producer.start();
+    QVERIFY(producer.wait());
+    QVERIFY(mainStrings.isEmpty());
+
+    // strings created by a thread that has finished
+    QCOMPARE(producer.strings.size(), 1000);
+    QCOMPARE(producer.strings.last(), QString::number(999));
+    producer.strings.clear();
+
+    for (int i = 0; i < 1000; ++i)
+        mainStrings.append(QString::number(i));
+    QCOMPARE(mainStrings.at(500), QString::number(500));
+}
+
 QTEST_APPLESS_MAIN(tst_QArrayData)
 #include "tst_qarraydata.moc"
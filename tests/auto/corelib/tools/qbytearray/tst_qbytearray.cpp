@@ -34,6 +34,7 @@
 #include <qhash.h>
 #include <limits.h>
 #include <private/qtools_p.h>
+#include <private/qbytearray_p.h>
 
 class tst_QByteArray : public QObject
 {
@@ -45,6 +46,9 @@ private slots:
     void swap();
     void qChecksum_data();
     void qChecksum();
+    void qCrc32_data();
+    void qCrc32();
+    void qCrc32Streaming();
     void qCompress_data();
 #ifndef QT_NO_COMPRESS
     void qCompress();
@@ -273,6 +277,90 @@ void tst_QByteArray::qChecksum()
     QCOMPARE(::qChecksum(data.constData(), len, standard), static_cast<quint16>(checksum));
 }
 
+// bit-by-bit reference implementation of the reflected CRC-32 variants
+static quint32 referenceCrc32(const QByteArray &data, quint32 polynomial)
+{
+    quint32 crc = 0xffffffff;
+    for (char c : data) {
+        crc ^= uchar(c);
+        for (int i = 0; i < 8; ++i)
+            crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+    }
+    return ~crc;
+}
+
+static QByteArray crcTestData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    quint32 state = 0x12345678;
+    for (int i = 0; i < size; ++i) {
+        state = state * 1103515245 + 12345;
+        data[i] = char(state >> 24);
+    }
+    return data;
+}
+
+void tst_QByteArray::qCrc32_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<uint>("crc32");
+    QTest::addColumn<uint>("crc32c");
+
+    QTest::newRow("empty") << QByteArray() << 0U << 0U;
+    QTest::newRow("check") << QByteArray("123456789") << 0xCBF43926U << 0xE3069283U;
+    // RFC 3720, B.4: 32 bytes of zeroes and of ones
+    QTest::newRow("zeroes") << QByteArray(32, '\0') << 0x190A55ADU << 0x8A9136AAU;
+    QTest::newRow("ones") << QByteArray(32, '\xff') << 0xFF6CAB0BU << 0x62A8AB43U;
+
+    // sizes around the ones of the blocks of the accelerated implementations
+    const QByteArray data = crcTestData(4096 + 67);
+    for (int size : {1, 7, 8, 15, 16, 17, 63, 64, 65, 127, 128, 129, 200, 1000, 4096 + 67}) {
+        for (int offset : {0, 1, 3}) {
+            const QByteArray chunk = data.mid(offset, size);
+            QTest::addRow("size%d-offset%d", size, offset)
+                    << chunk << referenceCrc32(chunk, 0xedb88320) << referenceCrc32(chunk, 0x82f63b78);
+        }
+    }
+}
+
+void tst_QByteArray::qCrc32()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(uint, crc32);
+    QFETCH(uint, crc32c);
+
+    QCOMPARE(::qCrc32(data.constData(), size_t(data.size())), quint32(crc32));
+    QCOMPARE(::qCrc32C(data.constData(), size_t(data.size())), quint32(crc32c));
+}
+
+void tst_QByteArray::qCrc32Streaming()
+{
+    const QByteArray data = crcTestData(100000);
+    const quint32 crc32 = ::qCrc32(data.constData(), size_t(data.size()));
+    const quint32 crc32c = ::qCrc32C(data.constData(), size_t(data.size()));
+    QCOMPARE(crc32, referenceCrc32(data, 0xedb88320));
+    QCOMPARE(crc32c, referenceCrc32(data, 0x82f63b78));
+
+    for (int split : {0, 1, 63, 64, 1000, 65536, 99999, 100000}) {
+        const char *p = data.constData();
+        const size_t len = size_t(data.size());
+        const size_t first = size_t(split);
+        QCOMPARE(::qCrc32(p + first, len - first, ::qCrc32(p, first)), crc32);
+        QCOMPARE(::qCrc32C(p + first, len - first, ::qCrc32C(p, first)), crc32c);
+    }
+
+    // many small pieces
+    quint32 streamed = 0;
+    quint32 streamedC = 0;
+    for (int i = 0; i < data.size(); i += 37) {
+        const size_t len = size_t(qMin(37, data.size() - i));
+        streamed = ::qCrc32(data.constData() + i, len, streamed);
+        streamedC = ::qCrc32C(data.constData() + i, len, streamedC);
+    }
+    QCOMPARE(streamed, crc32);
+    QCOMPARE(streamedC, crc32c);
+}
+
 void tst_QByteArray::qCompress_data()
 {
     QTest::addColumn<QByteArray>("ba");
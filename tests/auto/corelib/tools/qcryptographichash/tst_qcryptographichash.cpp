@@ -42,11 +42,15 @@ private slots:
     void intermediary_result_data();
     void intermediary_result();
     void sha1();
+    void sha2_data();
+    void sha2();
     void sha3_data();
     void sha3();
     void files_data();
     void files();
     void hashLength();
+    void chunkedInput_data();
+    void chunkedInput();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -202,6 +206,68 @@ void tst_QCryptographicHash::sha1()
              QByteArray("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F"));
 }
 
+void tst_QCryptographicHash::sha2_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("expectedResult");
+
+#define ROW(Tag, Algorithm, Input, Result) \
+    QTest::newRow(Tag) << Algorithm << QByteArray(Input) << QByteArray::fromHex(Result)
+
+    // test vectors from FIPS 180-2
+    ROW("sha224_empty",
+        QCryptographicHash::Sha224,
+        "",
+        "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f");
+
+    ROW("sha224_abc",
+        QCryptographicHash::Sha224,
+        "abc",
+        "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7");
+
+    ROW("sha224_two_blocks",
+        QCryptographicHash::Sha224,
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525");
+
+    ROW("sha224_million_a",
+        QCryptographicHash::Sha224,
+        QByteArray(1000000, 'a'),
+        "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67");
+
+    ROW("sha256_empty",
+        QCryptographicHash::Sha256,
+        "",
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    ROW("sha256_abc",
+        QCryptographicHash::Sha256,
+        "abc",
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    ROW("sha256_two_blocks",
+        QCryptographicHash::Sha256,
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    ROW("sha256_million_a",
+        QCryptographicHash::Sha256,
+        QByteArray(1000000, 'a'),
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+#undef ROW
+}
+
+void tst_QCryptographicHash::sha2()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, expectedResult);
+
+    QCOMPARE(QCryptographicHash::hash(data, algorithm), expectedResult);
+}
+
 void tst_QCryptographicHash::sha3_data()
 {
     QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
@@ -303,5 +369,43 @@ void tst_QCryptographicHash::hashLength()
     }
 }
 
+void tst_QCryptographicHash::chunkedInput_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("size");
+
+    // sizes around the block size and around the point where the padding
+    // no longer fits into the last block
+    static const int sizes[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000 };
+    static const QCryptographicHash::Algorithm algorithms[] = {
+        QCryptographicHash::Md5, QCryptographicHash::Sha1,
+        QCryptographicHash::Sha224, QCryptographicHash::Sha256
+    };
+    auto metaEnum = QMetaEnum::fromType<QCryptographicHash::Algorithm>();
+    for (QCryptographicHash::Algorithm algorithm : algorithms) {
+        for (int size : sizes) {
+            QTest::addRow("%s-%d", metaEnum.valueToKey(algorithm), size) << algorithm << size;
+        }
+    }
+}
+
+void tst_QCryptographicHash::chunkedInput()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, size);
+
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char(i * 7 + 3);
+    const QByteArray expected = QCryptographicHash::hash(data, algorithm);
+
+    for (int chunkSize : { 1, 3, 63, 64, 65 }) {
+        QCryptographicHash hash(algorithm);
+        for (int i = 0; i < size; i += chunkSize)
+            hash.addData(data.constData() + i, qMin(chunkSize, size - i));
+        QCOMPARE(hash.result(), expected);
+    }
+}
+
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qflathash
+QT = core-private testlib
+SOURCES = $$PWD/tst_qflathash.cpp
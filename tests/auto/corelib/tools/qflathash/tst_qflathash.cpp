@@ -0,0 +1,373 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <private/qflathash_p.h>
+#include <qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void construct();
+    void insertAndLookup();
+    void operatorBracket();
+    void remove();
+    void erase();
+    void take();
+    void implicitSharing();
+    void iterators();
+    void reserveAndSqueeze();
+    void compare();
+    void stringViewLookup();
+    void collidingKeys();
+    void randomOperations();
+    void complexValues();
+};
+
+struct Counted
+{
+    Counted() : v(0) { ++count; }
+    Counted(int v) : v(v) { ++count; }
+    Counted(const Counted &other) : v(other.v) { ++count; }
+    ~Counted() { --count; }
+    Counted &operator=(const Counted &) = default;
+    bool operator==(const Counted &other) const { return v == other.v; }
+
+    int v;
+    static int count;
+};
+
+int Counted::count = 0;
+
+void tst_QFlatHash::construct()
+{
+    QFlatHash<int, int> empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.size(), 0);
+    QCOMPARE(empty.capacity(), 0);
+    QVERIFY(!empty.contains(1));
+    QCOMPARE(empty.value(1, 42), 42);
+    QVERIFY(empty.constBegin() == empty.constEnd());
+    QCOMPARE(empty.remove(1), 0);
+
+    QFlatHash<int, QString> list{ {1, "one"}, {2, "two"}, {3, "three"} };
+    QCOMPARE(list.size(), 3);
+    QCOMPARE(list.value(2), QString("two"));
+
+    QFlatHash<int, QString> copy(list);
+    QCOMPARE(copy, list);
+    QFlatHash<int, QString> moved(std::move(copy));
+    QCOMPARE(moved, list);
+    QVERIFY(copy.isEmpty());
+
+    moved.clear();
+    QVERIFY(moved.isEmpty());
+    QCOMPARE(list.size(), 3);
+}
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash.count(i), 1);
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(!hash.contains(-1));
+
+    QFlatHash<int, int>::iterator it = hash.insert(10, 5);
+    QCOMPARE(it.key(), 10);
+    QCOMPARE(it.value(), 5);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(10), 5);
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash["a"] = 1;
+    ++hash["a"];
+    ++hash["b"];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value("a"), 2);
+    QCOMPARE(hash.value("b"), 1);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash["c"], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    for (int i = 0; i < 100; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 1);
+
+    // reinserting must reuse the slots rather than grow forever
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 100; i += 2)
+            hash.insert(i, round);
+        for (int i = 0; i < 100; i += 2)
+            hash.remove(i);
+    }
+    QCOMPARE(hash.size(), 50);
+    QVERIFY(hash.capacity() < 1000);
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 66);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, "one");
+    QCOMPARE(hash.take(1), QString("one"));
+    QCOMPARE(hash.take(1), QString());
+    QVERIFY(hash.isEmpty());
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, int> a;
+    for (int i = 0; i < 10; ++i)
+        a.insert(i, i);
+    QFlatHash<int, int> b = a;
+    QVERIFY(a.isSharedWith(b));
+    QVERIFY(!a.isDetached());
+
+    b.insert(10, 10);
+    QVERIFY(!a.isSharedWith(b));
+    QCOMPARE(a.size(), 10);
+    QCOMPARE(b.size(), 11);
+
+    QFlatHash<int, int> c = a;
+    c[0] = 100;
+    QCOMPARE(a.value(0), 0);
+    QCOMPARE(c.value(0), 100);
+
+    QFlatHash<int, int> d = a;
+    d.remove(5);
+    QVERIFY(a.contains(5));
+    QVERIFY(!d.contains(5));
+
+    QFlatHash<int, int> e = a;
+    QFlatHash<int, int>::iterator it = e.find(3);
+    *it = 33;
+    QCOMPARE(a.value(3), 3);
+    QCOMPARE(e.value(3), 33);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, -i);
+
+    QSet<int> seen;
+    int count = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), -it.key());
+        seen.insert(it.key());
+        ++count;
+    }
+    QCOMPARE(count, 500);
+    QCOMPARE(seen.size(), 500);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        it.value() = it.key();
+    for (int v : qAsConst(hash))
+        QVERIFY(v >= 0);
+
+    QList<int> keys = hash.keys();
+    QList<int> values = hash.values();
+    std::sort(keys.begin(), keys.end());
+    std::sort(values.begin(), values.end());
+    QCOMPARE(keys, values);
+    QCOMPARE(keys.size(), 500);
+    QCOMPARE(keys.first(), 0);
+    QCOMPARE(keys.last(), 499);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    QVERIFY(hash.capacity() >= 1000);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<QString, int> a;
+    QFlatHash<QString, int> b;
+    QVERIFY(a == b);
+    a.insert("x", 1);
+    QVERIFY(a != b);
+    b.insert("x", 1);
+    QVERIFY(a == b);
+    b.insert("x", 2);
+    QVERIFY(a != b);
+    b.insert("x", 1);
+    b.insert("y", 1);
+    b.remove("y");
+    QVERIFY(a == b);
+}
+
+void tst_QFlatHash::stringViewLookup()
+{
+    QFlatHash<QString, int> hash;
+    hash.insert(QStringLiteral("alpha"), 1);
+    hash.insert(QStringLiteral("beta"), 2);
+    hash.insert(QString::fromUtf8("gr\xc3\xbc\xc3\x9f"), 3);
+
+    const QString text = QStringLiteral("alpha beta gamma");
+    QVERIFY(hash.contains(QStringView(text).left(5)));
+    QCOMPARE(hash.value(QStringView(text).mid(6, 4)), 2);
+    QVERIFY(!hash.contains(QStringView(text).right(5)));
+    QCOMPARE(hash.value(QStringView(text).right(5), -1), -1);
+
+    QVERIFY(hash.contains(QLatin1String("alpha")));
+    QCOMPARE(hash.value(QLatin1String("beta")), 2);
+    QCOMPARE(hash.value(QLatin1String("gr\xfc\xdf")), 3);
+    QVERIFY(!hash.contains(QLatin1String("gamma")));
+    QVERIFY(hash.constFind(QLatin1String("gamma")) == hash.constEnd());
+
+    QFlatHash<QString, int>::iterator it = hash.find(QLatin1String("alpha"));
+    QVERIFY(it != hash.end());
+    QCOMPARE(it.key(), QStringLiteral("alpha"));
+    it = hash.find(QStringView(text).left(5));
+    QVERIFY(it != hash.end());
+    *it = 10;
+    QCOMPARE(hash.value(QStringLiteral("alpha")), 10);
+}
+
+struct BadHash
+{
+    int v;
+    bool operator==(const BadHash &other) const { return v == other.v; }
+};
+
+uint qHash(const BadHash &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::collidingKeys()
+{
+    QFlatHash<BadHash, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(BadHash{i}, i);
+    for (int i = 0; i < 200; i += 2)
+        hash.remove(BadHash{i});
+    QCOMPARE(hash.size(), 100);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(BadHash{i}, -1), i % 2 ? i : -1);
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QRandomGenerator rng(42);
+    QFlatHash<int, int> flat;
+    QHash<int, int> reference;
+    for (int i = 0; i < 100000; ++i) {
+        const int key = rng.bounded(2000);
+        switch (rng.bounded(4)) {
+        case 0:
+        case 1:
+            flat.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(flat.remove(key), reference.remove(key));
+            break;
+        case 3:
+            QCOMPARE(flat.value(key, -1), reference.value(key, -1));
+            break;
+        }
+    }
+    QCOMPARE(flat.size(), reference.size());
+    for (QHash<int, int>::const_iterator it = reference.constBegin(); it != reference.constEnd(); ++it)
+        QCOMPARE(flat.value(it.key()), it.value());
+}
+
+void tst_QFlatHash::complexValues()
+{
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 100; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::count, 100);
+        QFlatHash<int, Counted> copy = hash;
+        copy.insert(100, Counted(100));
+        QCOMPARE(Counted::count, 201);
+        for (int i = 0; i < 50; ++i)
+            hash.remove(i);
+        QCOMPARE(Counted::count, 151);
+        hash.squeeze();
+        QCOMPARE(Counted::count, 151);
+    }
+    QCOMPARE(Counted::count, 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -88,6 +88,12 @@ private slots:
     void stringToFloat();
     void doubleToString_data();
     void doubleToString();
+    void cLocaleDoubleToString_data();
+    void cLocaleDoubleToString();
+    void cLocaleDoubleToLongString();
+    void cLocaleStringToDouble_data();
+    void cLocaleStringToDouble();
+    void cLocaleDoubleRoundTrip();
     void strtod_data();
     void strtod();
     void long_long_conversion_data();
@@ -1151,6 +1157,109 @@ void tst_QLocale::doubleToString()
     QCOMPARE(locale.toString(num, mode, precision), num_str);
 }
 
+void tst_QLocale::cLocaleDoubleToString_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<char>("mode");
+    QTest::addColumn<int>("precision");
+    QTest::addColumn<QByteArray>("expected");
+
+    const int shortest = QLocale::FloatingPointShortest;
+    QTest::newRow("0.1 shortest") << 0.1 << 'g' << shortest << QByteArray("0.1");
+    QTest::newRow("1/3 shortest") << 1.0 / 3 << 'g' << shortest << QByteArray("0.3333333333333333");
+    QTest::newRow("1e21 shortest") << 1e21 << 'g' << shortest << QByteArray("1e+21");
+    QTest::newRow("1e-5 shortest") << 1e-5 << 'g' << shortest << QByteArray("1e-05");
+    QTest::newRow("123456 shortest") << 123456.0 << 'g' << shortest << QByteArray("123456");
+    QTest::newRow("-0.0") << -0.0 << 'g' << shortest << QByteArray("0");
+    QTest::newRow("-2.5 e") << -2.5 << 'e' << 3 << QByteArray("-2.500e+00");
+    QTest::newRow("1.5 E") << 1.5 << 'E' << 1 << QByteArray("1.5E+00");
+    QTest::newRow("1e100 e") << 1e100 << 'e' << 0 << QByteArray("1e+100");
+    QTest::newRow("123.456 f") << 123.456 << 'f' << 2 << QByteArray("123.46");
+    QTest::newRow("1234567 f") << 1234567.0 << 'f' << 0 << QByteArray("1234567");
+    QTest::newRow("0.0001234 f") << 0.0001234 << 'f' << 5 << QByteArray("0.00012");
+    QTest::newRow("0.000001234 g") << 0.000001234 << 'g' << 6 << QByteArray("1.234e-06");
+    QTest::newRow("12345678 G") << 12345678.0 << 'G' << 3 << QByteArray("1.23E+07");
+    QTest::newRow("inf") << qInf() << 'g' << 6 << QByteArray("inf");
+    QTest::newRow("-inf G") << -qInf() << 'G' << 6 << QByteArray("-INF");
+    QTest::newRow("nan") << qQNaN() << 'f' << 6 << QByteArray("nan");
+}
+
+void tst_QLocale::cLocaleDoubleToString()
+{
+    QFETCH(double, num);
+    QFETCH(char, mode);
+    QFETCH(int, precision);
+    QFETCH(QByteArray, expected);
+
+#ifdef QT_NO_DOUBLECONVERSION
+    if (precision == QLocale::FloatingPointShortest)
+        QSKIP("'Shortest' double conversion is not that short without libdouble-conversion");
+#endif
+
+    QCOMPARE(QLocale::c().toString(num, mode, precision).toLatin1(), expected);
+    QCOMPARE(QString::number(num, mode, precision).toLatin1(), expected);
+    QCOMPARE(QByteArray::number(num, mode, precision), expected);
+}
+
+void tst_QLocale::cLocaleDoubleToLongString()
+{
+    // longer than the stack buffers of the C locale formatting
+    char expected[400];
+    qsnprintf(expected, sizeof expected, "%.2f", 1e300);
+    QCOMPARE(qstrlen(expected), 304u);
+
+    QCOMPARE(QByteArray::number(1e300, 'f', 2), QByteArray(expected));
+    QCOMPARE(QString::number(1e300, 'f', 2), QString::fromLatin1(expected));
+    QCOMPARE(QLocale::c().toString(1e300, 'f', 2), QString::fromLatin1(expected));
+}
+
+void tst_QLocale::cLocaleStringToDouble_data()
+{
+    QTest::addColumn<QByteArray>("text");
+    QTest::addColumn<double>("num");
+    QTest::addColumn<bool>("ok");
+
+    QTest::newRow("plain") << QByteArray("1.5") << 1.5 << true;
+    QTest::newRow("exponent") << QByteArray("-2.5E-3") << -0.0025 << true;
+    QTest::newRow("whitespace") << QByteArray(" \t42\n ") << 42.0 << true;
+    QTest::newRow("inf") << QByteArray("-inf") << -qInf() << true;
+    QTest::newRow("empty") << QByteArray("") << 0.0 << false;
+    QTest::newRow("garbage") << QByteArray("1.5x") << 0.0 << false;
+    QTest::newRow("underflow") << QByteArray("1e-400") << 0.0 << false;
+}
+
+void tst_QLocale::cLocaleStringToDouble()
+{
+    QFETCH(QByteArray, text);
+    QFETCH(double, num);
+    QFETCH(bool, ok);
+
+    bool parsed;
+    QCOMPARE(text.toDouble(&parsed), num);
+    QCOMPARE(parsed, ok);
+    QCOMPARE(QLocale::c().toDouble(QString::fromLatin1(text), &parsed), num);
+    QCOMPARE(parsed, ok);
+}
+
+void tst_QLocale::cLocaleDoubleRoundTrip()
+{
+    QVector<double> values;
+    for (int i = 0; i < 1000; ++i)
+        values << qSin(i) * qPow(10, i % 40 - 20);
+    values << 0.0 << -1.0 << 1e300 << 5e-324;
+
+    for (double value : qAsConst(values)) {
+        bool ok = false;
+        const QByteArray bytes = QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+        QCOMPARE(bytes.toDouble(&ok), value);
+        QVERIFY(ok);
+        const QString string = QLocale::c().toString(value, 'g', QLocale::FloatingPointShortest);
+        QCOMPARE(string.toLatin1(), bytes);
+        QCOMPARE(QLocale::c().toDouble(string, &ok), value);
+        QVERIFY(ok);
+    }
+}
+
 void tst_QLocale::strtod_data()
 {
     QTest::addColumn<QString>("num_str");
@@ -37,6 +37,8 @@
 #include <qregularexpression.h>
 #include <qthread.h>
 
+#include <private/qregularexpression_p.h>
+
 Q_DECLARE_METATYPE(QRegularExpression::PatternOptions)
 Q_DECLARE_METATYPE(QRegularExpression::MatchType)
 Q_DECLARE_METATYPE(QRegularExpression::MatchOptions)
@@ -78,6 +80,10 @@ private slots:
     void QStringAndQStringRefEquivalence();
     void threadSafety_data();
     void threadSafety();
+    void compiledPatternCache();
+    void batchMatch_data();
+    void batchMatch();
+    void batchMatchInvalid();
 
     void wildcard_data();
     void wildcard();
@@ -2157,6 +2163,134 @@ void tst_QRegularExpression::threadSafety()
     }
 }
 
+void tst_QRegularExpression::compiledPatternCache()
+{
+    const int defaultMaxCost = qt_regularExpressionCacheStatistics().maxCost;
+    QVERIFY(defaultMaxCost > 0);
+    qt_clearRegularExpressionCache();
+
+    const QString pattern = QStringLiteral("^(?<key>\\w+)=(\\d+)$");
+    QRegularExpressionCacheStatistics before = qt_regularExpressionCacheStatistics();
+    QCOMPARE(before.count, 0);
+
+    // identical patterns share the compiled code
+    QRegularExpression first(pattern);
+    QVERIFY(first.isValid());
+    QRegularExpression second(pattern);
+    QVERIFY(second.isValid());
+    QRegularExpressionCacheStatistics after = qt_regularExpressionCacheStatistics();
+    QCOMPARE(after.misses, before.misses + 1);
+    QCOMPARE(after.hits, before.hits + 1);
+    QCOMPARE(after.count, 1);
+    QVERIFY(after.totalCost > 0);
+
+    QRegularExpressionMatch match = second.match(QStringLiteral("answer=42"));
+    QVERIFY(match.hasMatch());
+    QCOMPARE(match.captured(QStringLiteral("key")), QStringLiteral("answer"));
+    QCOMPARE(match.captured(2), QStringLiteral("42"));
+    QCOMPARE(second.captureCount(), 2);
+    QCOMPARE(second.namedCaptureGroups(), first.namedCaptureGroups());
+
+    // different compile options are a different entry
+    before = after;
+    QRegularExpression caseless(pattern, QRegularExpression::CaseInsensitiveOption);
+    QVERIFY(caseless.isValid());
+    after = qt_regularExpressionCacheStatistics();
+    QCOMPARE(after.misses, before.misses + 1);
+    QCOMPARE(after.count, 2);
+
+    // errors are cached too, and reported the same way
+    const QString invalidPattern = QStringLiteral("a(b");
+    QRegularExpression invalid(invalidPattern);
+    QVERIFY(!invalid.isValid());
+    QRegularExpression invalidAgain(invalidPattern);
+    QVERIFY(!invalidAgain.isValid());
+    QCOMPARE(invalidAgain.errorString(), invalid.errorString());
+    QCOMPARE(invalidAgain.patternErrorOffset(), invalid.patternErrorOffset());
+
+    // a detached copy, once changed, no longer uses the entry of the original
+    QRegularExpression copy = first;
+    copy.setPattern(QStringLiteral("x*"));
+    QVERIFY(copy.match(QStringLiteral("xx")).hasMatch());
+    QVERIFY(first.match(QStringLiteral("a=1")).hasMatch());
+
+    // a limit of 0 disables the cache
+    qt_setRegularExpressionCacheLimit(0);
+    before = qt_regularExpressionCacheStatistics();
+    QRegularExpression uncached(pattern);
+    QVERIFY(uncached.match(QStringLiteral("b=2")).hasMatch());
+    after = qt_regularExpressionCacheStatistics();
+    QCOMPARE(after.hits, before.hits);
+    QCOMPARE(after.misses, before.misses);
+
+    qt_setRegularExpressionCacheLimit(defaultMaxCost);
+    qt_clearRegularExpressionCache();
+}
+
+void tst_QRegularExpression::batchMatch_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QRegularExpression::MatchOptions>("matchOptions");
+    QTest::addColumn<QStringList>("subjects");
+
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0)
+            lines << QString::fromLatin1("key%1=%2").arg(i).arg(i * 7);
+        else if (i % 3 == 1)
+            lines << QString::fromLatin1("# comment %1").arg(i);
+        else
+            lines << QString();
+    }
+
+    QTest::newRow("empty-list") << "a" << QRegularExpression::MatchOptions() << QStringList();
+    QTest::newRow("lines") << "^(\\w+)=(\\d+)$" << QRegularExpression::MatchOptions() << lines;
+    QTest::newRow("optional-group") << "(?<key>\\w+)(=(\\d+))?" << QRegularExpression::MatchOptions() << lines;
+    QTest::newRow("empty-match") << "x*" << QRegularExpression::MatchOptions() << lines;
+    QTest::newRow("anchored") << "\\d+" << QRegularExpression::MatchOptions(QRegularExpression::AnchoredMatchOption)
+                              << (QStringList() << "123" << "abc123" << "" << "4");
+    QTest::newRow("invalid-utf16") << "." << QRegularExpression::MatchOptions()
+                                   << (QStringList() << QString(QChar(0xd800)) << "a");
+}
+
+void tst_QRegularExpression::batchMatch()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QRegularExpression::MatchOptions, matchOptions);
+    QFETCH(QStringList, subjects);
+
+    const QRegularExpression re(pattern);
+    QVERIFY(re.isValid());
+    const int stride = 2 * (re.captureCount() + 1);
+
+    QVector<int> expected;
+    for (const QString &subject : subjects) {
+        const QRegularExpressionMatch match = re.match(subject, 0, QRegularExpression::NormalMatch, matchOptions);
+        for (int i = 0; i <= re.captureCount(); ++i) {
+            const bool captured = match.hasMatch() && i <= match.lastCapturedIndex()
+                    && match.capturedStart(i) >= 0;
+            expected << (captured ? match.capturedStart(i) : -1)
+                     << (captured ? match.capturedEnd(i) : -1);
+        }
+    }
+    QCOMPARE(expected.size(), subjects.size() * stride);
+
+    QCOMPARE(qt_regularExpressionBatchMatch(re, subjects, matchOptions), expected);
+    QCOMPARE(qt_regularExpressionBatchMatch(re, subjects, matchOptions, ParallelBatchMatchOption), expected);
+
+    QVector<QStringView> views;
+    for (const QString &subject : subjects)
+        views << subject;
+    QCOMPARE(qt_regularExpressionBatchMatch(re, views, matchOptions), expected);
+}
+
+void tst_QRegularExpression::batchMatchInvalid()
+{
+    const QRegularExpression re(QStringLiteral("a("));
+    QTest::ignoreMessage(QtWarningMsg, "qt_regularExpressionBatchMatch(): called on an invalid QRegularExpression object");
+    QVERIFY(qt_regularExpressionBatchMatch(re, QStringList() << "a(" << "b").isEmpty());
+}
+
 void tst_QRegularExpression::wildcard_data()
 {
     QTest::addColumn<QString>("pattern");
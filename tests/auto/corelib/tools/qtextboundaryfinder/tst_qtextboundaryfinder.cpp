@@ -483,6 +483,20 @@ void tst_QTextBoundaryFinder::wordBoundaries_manual_data()
         QTest::newRow("ts 5e") << testString << expectedBreakPositions
                                << expectedStartPositions << expectedEndPositions;
     }
+    {
+        // long runs of letters, digits and ideographs
+        QString testString(QString::fromUtf8("Abcdefghij0123456789 "
+                                             "\xe4\xb8\x80\xe4\xba\x8c\xe4\xb8\x89\xe5\x9b\x9b\xe4\xba\x94"
+                                             "\xe5\x85\xad\xe4\xb8\x83\xe5\x85\xab\xe4\xb9\x9d\xe5\x8d\x81 xyz"));
+        QList<int> expectedBreakPositions, expectedStartPositions, expectedEndPositions;
+        expectedBreakPositions << 0 << 20 << 21 << 22 << 23 << 24 << 25 << 26 << 27 << 28 << 29 << 30
+                               << 31 << 32 << 35;
+        expectedStartPositions << 0 << 32;
+        expectedEndPositions   << 20 << 35;
+
+        QTest::newRow("runs") << testString << expectedBreakPositions
+                              << expectedStartPositions << expectedEndPositions;
+    }
 }
 
 void tst_QTextBoundaryFinder::wordBoundaries_manual()
@@ -621,6 +635,19 @@ void tst_QTextBoundaryFinder::lineBoundaries_manual_data()
         QTest::newRow("x(AL)x(BA)+(AL)x(BA)+(AL)x(AL)+") << testString << expectedBreakPositions
                                                          << expectedMandatoryBreakPositions;
     }
+
+    {
+        // long runs of letters and ideographs
+        QString testString(QString::fromUtf8("abcdefghijklmnop "
+                                             "\xe4\xb8\x80\xe4\xba\x8c\xe4\xb8\x89\xe5\x9b\x9b\xe4\xba\x94"
+                                             "\xe5\x85\xad\xe4\xb8\x83\xe5\x85\xab\xe4\xb9\x9d\xe5\x8d\x81 qrstuvwxyz"));
+        QList<int> expectedBreakPositions, expectedMandatoryBreakPositions;
+        expectedBreakPositions << 0 << 17 << 18 << 19 << 20 << 21 << 22 << 23 << 24 << 25 << 26 << 28 << 38;
+        expectedMandatoryBreakPositions << 0 << 38;
+
+        QTest::newRow("x(AL)*+(SP)+(ID)*+(SP)+(AL)*+") << testString << expectedBreakPositions
+                                                       << expectedMandatoryBreakPositions;
+    }
 }
 
 void tst_QTextBoundaryFinder::lineBoundaries_manual()
@@ -56,6 +56,7 @@ private slots:
     void checkOffset_data();
     void checkOffset();
     void stressTest();
+    void threadedLookups();
     void windowsId();
     void isValidId_data();
     void isValidId();
@@ -650,6 +651,49 @@ void tst_QTimeZone::stressTest()
     }
 }
 
+void tst_QTimeZone::threadedLookups()
+{
+    // Zones are shared between threads; each looks offsets up in its own QTimeZone
+    // objects, and checks the quick offset lookups against the full offsetData()
+    struct LookupThread : QThread
+    {
+        void run() override
+        {
+            QVector<QDateTime> times;
+            for (int year = 1960; year <= 2110; year += 3) {
+                times << QDateTime(QDate(year, 3, 30), QTime(1, 30), Qt::UTC)
+                      << QDateTime(QDate(year, 10, 30), QTime(1, 30), Qt::UTC);
+            }
+            for (const QByteArray &id : QTimeZone::availableTimeZoneIds()) {
+                const QTimeZone zone(id);
+                if (!zone.isValid()) {
+                    ++mismatches;
+                    continue;
+                }
+                if (!zone.hasTransitions()) // Fixed offset zones have no offsetData()
+                    continue;
+                for (const QDateTime &when : qAsConst(times)) {
+                    const QTimeZone::OffsetData data = zone.offsetData(when);
+                    if (zone.offsetFromUtc(when) != data.offsetFromUtc
+                        || zone.standardTimeOffset(when) != data.standardTimeOffset
+                        || zone.daylightTimeOffset(when) != data.daylightTimeOffset) {
+                        ++mismatches;
+                    }
+                }
+            }
+        }
+        int mismatches = 0;
+    };
+
+    LookupThread threads[4];
+    for (LookupThread &thread : threads)
+        thread.start();
+    for (LookupThread &thread : threads) {
+        QVERIFY(thread.wait(60000));
+        QCOMPARE(thread.mismatches, 0);
+    }
+}
+
 void tst_QTimeZone::windowsId()
 {
 /*
@@ -20,6 +20,7 @@ SUBDIRS=\
     qdatetime \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
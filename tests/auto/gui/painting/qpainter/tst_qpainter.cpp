@@ -45,6 +45,7 @@
 #include <qrandom.h>
 
 #include <private/qdrawhelper_p.h>
+#include <private/qpainter_p.h>
 #include <qpainter.h>
 #include <qqueue.h>
 #include <qscreen.h>
@@ -283,6 +284,7 @@ private slots:
 
     void RasterOp_NotDestination();
     void drawTextNoHinting();
+    void drawTextLayoutCache();
 
     void drawPolyline_data();
     void drawPolyline();
@@ -5023,6 +5025,73 @@ void tst_QPainter::drawTextNoHinting()
     QVERIFY(true);
 }
 
+static QImage drawTextForLayoutCache(QRectF *boundingRect)
+{
+    const QString text = QStringLiteral("The quick &brown fox\njumps over the lazy dog");
+    const int flags[] = {
+        Qt::AlignLeft | Qt::AlignTop,
+        Qt::AlignCenter | Qt::TextWordWrap,
+        Qt::AlignRight | Qt::AlignBottom | Qt::TextShowMnemonic,
+        Qt::AlignLeft | Qt::TextSingleLine | Qt::TextDontClip
+    };
+
+    QImage image(200, 400, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    for (int i = 0; i < int(sizeof(flags) / sizeof(flags[0])); ++i)
+        p.drawText(QRectF(10, 10 + i * 90, 120, 80), flags[i], text, i ? 0 : boundingRect);
+    return image;
+}
+
+static QImage drawMnemonicTextForLayoutCache(const QString &text)
+{
+    QImage image(100, 40, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.drawText(image.rect(), Qt::AlignCenter | Qt::TextShowMnemonic, text);
+    return image;
+}
+
+void tst_QPainter::drawTextLayoutCache()
+{
+    qt_clearTextLayoutCache();
+    qt_setTextLayoutCacheLimit(0);
+    QRectF uncachedBounds;
+    const QImage uncached = drawTextForLayoutCache(&uncachedBounds);
+    QCOMPARE(qt_textLayoutCacheStatistics().count, 0);
+
+    qt_setTextLayoutCacheLimit(1024 * 1024);
+    const QTextLayoutCacheStatistics before = qt_textLayoutCacheStatistics();
+    QRectF firstBounds;
+    const QImage first = drawTextForLayoutCache(&firstBounds);
+    const QTextLayoutCacheStatistics afterFirst = qt_textLayoutCacheStatistics();
+    QRectF secondBounds;
+    const QImage second = drawTextForLayoutCache(&secondBounds);
+    const QTextLayoutCacheStatistics afterSecond = qt_textLayoutCacheStatistics();
+
+    QVERIFY(afterFirst.count > 0);
+    QVERIFY(afterFirst.totalCost <= afterFirst.maxCost);
+    QCOMPARE(afterFirst.hits, before.hits);
+    QCOMPARE(afterSecond.hits - afterFirst.hits, afterFirst.misses - before.misses);
+    QCOMPARE(first, uncached);
+    QCOMPARE(second, uncached);
+    QCOMPARE(firstBounds, uncachedBounds);
+    QCOMPARE(secondBounds, uncachedBounds);
+
+    // Both texts read "File" once the mnemonic markers are removed, but the
+    // underline must stay under the letter each of them marks.
+    qt_setTextLayoutCacheLimit(0);
+    const QImage uncachedFile = drawMnemonicTextForLayoutCache(QStringLiteral("&File"));
+    const QImage uncachedFIle = drawMnemonicTextForLayoutCache(QStringLiteral("F&ile"));
+    QVERIFY(uncachedFile != uncachedFIle);
+    qt_setTextLayoutCacheLimit(1024 * 1024);
+    QCOMPARE(drawMnemonicTextForLayoutCache(QStringLiteral("&File")), uncachedFile);
+    QCOMPARE(drawMnemonicTextForLayoutCache(QStringLiteral("F&ile")), uncachedFIle);
+
+    qt_setTextLayoutCacheLimit(0);
+    QCOMPARE(qt_textLayoutCacheStatistics().count, 0);
+}
+
 void tst_QPainter::drawPolyline_data()
 {
     QTest::addColumn< QVector<QPointF> >("points");
@@ -31,6 +31,8 @@
 
 #include <qrawfont.h>
 #include <private/qrawfont_p.h>
+#include <private/qfontengine_p.h>
+#include <private/qtextureglyphcache_p.h>
 
 class tst_QRawFont: public QObject
 {
@@ -96,6 +98,8 @@ private slots:
     void qtbug65923_partal_clone_data();
     void qtbug65923_partal_clone();
 
+    void concurrentGlyphRasterization();
+
 private:
     QString testFont;
     QString testFontBoldItalic;
@@ -1086,6 +1090,54 @@ void tst_QRawFont::qtbug65923_partal_clone()
     QVERIFY(!outerFont.boundingRect(42).isEmpty());
 }
 
+static QImage glyphImage(const QImageTextureGlyphCache &cache, glyph_t glyph)
+{
+    const QTextureGlyphCache::GlyphAndSubPixelPosition key(glyph, 0);
+    if (!cache.coords.contains(key))
+        return QImage();
+    const QTextureGlyphCache::Coord c = cache.coords.value(key);
+    return c.isNull() ? QImage() : cache.image().copy(c.x, c.y, c.w, c.h);
+}
+
+void tst_QRawFont::concurrentGlyphRasterization()
+{
+    QRawFont font(testFont, 24, QFont::PreferNoHinting);
+    QVERIFY(font.isValid());
+    QFontEngine *fontEngine = QRawFontPrivate::get(font)->fontEngine;
+    if (!fontEngine->supportsConcurrentRasterization())
+        QSKIP("The font engine does not support concurrent rasterization");
+
+    const int glyphCount = fontEngine->glyphCount();
+    QVERIFY(glyphCount >= 64);
+    QVector<glyph_t> glyphs(glyphCount);
+    for (int i = 0; i < glyphCount; ++i)
+        glyphs[i] = i;
+    const QVector<QFixedPoint> positions(glyphCount);
+
+    // A clone must render exactly like the engine it was made from.
+    QScopedPointer<QFontEngine> clone(fontEngine->cloneForRasterization());
+    QVERIFY(clone);
+    for (glyph_t glyph : glyphs)
+        QCOMPARE(clone->alphaMapForGlyph(glyph, 0, QTransform()), fontEngine->alphaMapForGlyph(glyph, 0, QTransform()));
+
+    // Filling all glyphs at once splits the rasterization across the thread pool,
+    // while small batches are rendered on this thread. Both must yield the same masks.
+    QImageTextureGlyphCache concurrentCache(QFontEngine::Format_A8, QTransform());
+    QVERIFY(concurrentCache.populate(fontEngine, glyphCount, glyphs.constData(), positions.constData()));
+    concurrentCache.fillInPendingGlyphs();
+
+    QImageTextureGlyphCache serialCache(QFontEngine::Format_A8, QTransform());
+    for (int i = 0; i < glyphCount; i += 16) {
+        const int count = qMin(16, glyphCount - i);
+        QVERIFY(serialCache.populate(fontEngine, count, glyphs.constData() + i, positions.constData() + i));
+        serialCache.fillInPendingGlyphs();
+    }
+
+    QCOMPARE(concurrentCache.coords.size(), serialCache.coords.size());
+    for (glyph_t glyph : glyphs)
+        QCOMPARE(glyphImage(concurrentCache, glyph), glyphImage(serialCache, glyph));
+}
+
 #endif // QT_NO_RAWFONT
 
 QTEST_MAIN(tst_QRawFont)
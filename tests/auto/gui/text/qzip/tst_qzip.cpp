@@ -30,6 +30,12 @@
 #include <QDebug>
 #include <private/qzipwriter_p.h>
 #include <private/qzipreader_p.h>
+#include <private/qbytearray_p.h>
+
+static quint32 checksum(const QByteArray &data)
+{
+    return qCrc32(data.constData(), size_t(data.size()));
+}
 
 class tst_QZip : public QObject
 {
@@ -40,6 +46,11 @@ private slots:
     void symlinks();
     void readTest();
     void createArchive();
+    void parallelCompression();
+    void openFile();
+    void streamedFile();
+    void zip64Directory();
+    void zip64ExtraField();
 };
 
 void tst_QZip::basicUnpack()
@@ -135,5 +146,169 @@ void tst_QZip::createArchive()
     QCOMPARE(zip2.fileData("My Filename"), fileContents);
 }
 
+void tst_QZip::parallelCompression()
+{
+    QVector<QByteArray> contents;
+    for (int i = 0; i < 100; ++i)
+        contents.append(QByteArray::number(i).repeated(i * 97));
+
+    QBuffer buffer;
+    QZipWriter zip(&buffer);
+    QVERIFY(!zip.isParallelCompressionEnabled());
+    zip.setParallelCompressionEnabled(true);
+    QVERIFY(zip.isParallelCompressionEnabled());
+    zip.setCompressionPolicy(QZipWriter::AutoCompress);
+    zip.addDirectory("dir");
+    for (int i = 0; i < contents.size(); ++i)
+        zip.addFile(QString("dir/file%1").arg(i), contents.at(i));
+    zip.addSymLink("link", "dir/file1");
+    zip.close();
+    QCOMPARE(zip.status(), QZipWriter::NoError);
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip2(&buffer2);
+    const QVector<QZipReader::FileInfo> files = zip2.fileInfoList();
+    QCOMPARE(files.count(), contents.size() + 2);
+    QCOMPARE(files.first().filePath, QString("dir"));
+    QVERIFY(files.first().isDir);
+    QCOMPARE(files.last().filePath, QString("link"));
+    QVERIFY(files.last().isSymLink);
+    for (int i = 0; i < contents.size(); ++i) {
+        const QZipReader::FileInfo &file = files.at(i + 1);
+        QCOMPARE(file.filePath, QString("dir/file%1").arg(i));
+        QCOMPARE(file.size, qint64(contents.at(i).size()));
+        QCOMPARE(zip2.fileData(file.filePath), contents.at(i));
+    }
+}
+
+void tst_QZip::openFile()
+{
+    const QByteArray small("stored");
+    const QByteArray large = QByteArray("compressed contents\n").repeated(10000);
+
+    QBuffer buffer;
+    QZipWriter zip(&buffer);
+    zip.setCompressionPolicy(QZipWriter::AutoCompress);
+    zip.addFile("small", small);
+    zip.addFile("large", large);
+    zip.close();
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip2(&buffer2);
+    QVERIFY(!zip2.openFile("missing"));
+
+    QScopedPointer<QIODevice> smallFile(zip2.openFile("small"));
+    QScopedPointer<QIODevice> largeFile(zip2.openFile("large"));
+    QVERIFY(smallFile);
+    QVERIFY(largeFile);
+    QVERIFY(smallFile->isReadable());
+    QVERIFY(largeFile->isSequential());
+
+    // reads of different files can be interleaved
+    QByteArray largeData = largeFile->read(100);
+    QCOMPARE(smallFile->readAll(), small);
+    while (!largeFile->atEnd()) {
+        const QByteArray chunk = largeFile->read(4096);
+        if (chunk.isEmpty())
+            break;
+        largeData += chunk;
+    }
+    QCOMPARE(largeData, large);
+    QCOMPARE(zip2.fileData("large"), large);
+}
+
+void tst_QZip::streamedFile()
+{
+    // large enough to be compressed straight into the archive
+    QByteArray contents;
+    for (int i = 0; contents.size() < 20 * 1024 * 1024; ++i)
+        contents += QByteArray::number(i) + ' ';
+    QBuffer source(&contents);
+
+    QBuffer buffer;
+    QZipWriter zip(&buffer);
+    zip.addFile("first", QByteArray("first"));
+    zip.addFile("large", &source);
+    zip.addFile("last", QByteArray("last"));
+    zip.close();
+    QCOMPARE(zip.status(), QZipWriter::NoError);
+    QVERIFY(buffer.size() < contents.size());
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip2(&buffer2);
+    const QVector<QZipReader::FileInfo> files = zip2.fileInfoList();
+    QCOMPARE(files.count(), 3);
+    QCOMPARE(files.at(1).filePath, QString("large"));
+    QCOMPARE(files.at(1).size, qint64(contents.size()));
+    QCOMPARE(files.at(1).crc, uint(checksum(contents)));
+    QCOMPARE(zip2.fileData("large"), contents);
+    QCOMPARE(zip2.fileData("last"), QByteArray("last"));
+}
+
+void tst_QZip::zip64Directory()
+{
+    // more entries than the end of directory record can count
+    const int count = 0x10000 + 10;
+
+    QBuffer buffer;
+    QZipWriter zip(&buffer);
+    zip.setCompressionPolicy(QZipWriter::NeverCompress);
+    for (int i = 0; i < count; ++i)
+        zip.addFile(QString::number(i), QByteArray::number(i));
+    zip.close();
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip2(&buffer2);
+    QCOMPARE(zip2.count(), count);
+    QCOMPARE(zip2.entryInfoAt(count - 1).filePath, QString::number(count - 1));
+    QCOMPARE(zip2.fileData(QString::number(count - 1)), QByteArray::number(count - 1));
+}
+
+void tst_QZip::zip64ExtraField()
+{
+    // an archive whose single entry keeps its sizes and offset in zip64 extra fields
+    const QByteArray name("big");
+    const QByteArray contents("zip64 contents");
+    const quint32 crc = checksum(contents);
+
+    QByteArray archive;
+    QDataStream stream(&archive, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << quint32(0x04034b50) << quint16(45) << quint16(0) << quint16(0) << quint32(0)
+           << crc << quint32(0xffffffff) << quint32(0xffffffff)
+           << quint16(name.size()) << quint16(20);
+    stream.writeRawData(name.constData(), name.size());
+    stream << quint16(1) << quint16(16) << quint64(contents.size()) << quint64(contents.size());
+    stream.writeRawData(contents.constData(), contents.size());
+
+    const quint64 directoryOffset = archive.size();
+    stream << quint32(0x02014b50) << quint16((3 << 8) | 45) << quint16(45) << quint16(0)
+           << quint16(0) << quint32(0) << crc << quint32(0xffffffff) << quint32(0xffffffff)
+           << quint16(name.size()) << quint16(28) << quint16(0) << quint16(0) << quint16(0)
+           << quint32(0100644 << 16) << quint32(0xffffffff);
+    stream.writeRawData(name.constData(), name.size());
+    stream << quint16(1) << quint16(24) << quint64(contents.size()) << quint64(contents.size())
+           << quint64(0);
+
+    const quint64 eod64Offset = archive.size();
+    stream << quint32(0x06064b50) << quint64(44) << quint16((3 << 8) | 45) << quint16(45)
+           << quint32(0) << quint32(0) << quint64(1) << quint64(1)
+           << quint64(eod64Offset - directoryOffset) << directoryOffset;
+    stream << quint32(0x07064b50) << quint32(0) << eod64Offset << quint32(1);
+    stream << quint32(0x06054b50) << quint16(0) << quint16(0) << quint16(0xffff) << quint16(0xffff)
+           << quint32(0xffffffff) << quint32(0xffffffff) << quint16(0);
+
+    QBuffer buffer(&archive);
+    QZipReader zip(&buffer);
+    QCOMPARE(zip.count(), 1);
+    const QZipReader::FileInfo file = zip.entryInfoAt(0);
+    QCOMPARE(file.filePath, QString(name));
+    QCOMPARE(file.size, qint64(contents.size()));
+    QCOMPARE(zip.fileData(name), contents);
+    QScopedPointer<QIODevice> device(zip.openFile(name));
+    QVERIFY(device);
+    QCOMPARE(device->readAll(), contents);
+}
+
 QTEST_MAIN(tst_QZip)
 #include "tst_qzip.moc"
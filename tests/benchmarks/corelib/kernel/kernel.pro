@@ -5,7 +5,9 @@ SUBDIRS = \
         qmetatype \
         qobject \
         qvariant \
-        qcoreapplication
+        qcoreapplication \
+        qsocketnotifier \
+        qtimer
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
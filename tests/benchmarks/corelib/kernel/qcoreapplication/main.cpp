@@ -35,6 +35,41 @@ Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void event_posting_multiple_producers_data();
+    void event_posting_multiple_producers();
+};
+
+class QueuedCallReceiver : public QObject
+{
+Q_OBJECT
+public:
+    int expected = 0;
+    int received = 0;
+    QEventLoop *loop = nullptr;
+
+public slots:
+    void receive()
+    {
+        if (++received == expected)
+            loop->quit();
+    }
+};
+
+class ProducerThread : public QThread
+{
+Q_OBJECT
+public:
+    int count = 0;
+
+signals:
+    void produced();
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i)
+            emit produced();
+    }
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -64,6 +99,46 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+void QCoreApplicationBenchmark::event_posting_multiple_producers_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<int>("size");
+    for (int producers : { 1, 2, 4, 8 })
+        QTest::addRow("%d producers", producers) << producers << 20000;
+}
+
+void QCoreApplicationBenchmark::event_posting_multiple_producers()
+{
+    QFETCH(int, producers);
+    QFETCH(int, size);
+
+    // each producer thread emits a signal queued to an object in this thread
+    QueuedCallReceiver receiver;
+    QVector<ProducerThread *> threads;
+    for (int i = 0; i < producers; ++i) {
+        ProducerThread *thread = new ProducerThread;
+        thread->count = size;
+        connect(thread, &ProducerThread::produced,
+                &receiver, &QueuedCallReceiver::receive, Qt::QueuedConnection);
+        threads.append(thread);
+    }
+
+    QBENCHMARK {
+        QEventLoop loop;
+        receiver.loop = &loop;
+        receiver.received = 0;
+        receiver.expected = producers * size;
+        for (ProducerThread *thread : qAsConst(threads))
+            thread->start();
+        loop.exec();
+        for (ProducerThread *thread : qAsConst(threads))
+            thread->wait();
+    }
+    QCOMPARE(receiver.received, producers * size);
+
+    qDeleteAll(threads);
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
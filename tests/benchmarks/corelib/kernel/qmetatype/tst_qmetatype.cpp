@@ -28,6 +28,8 @@
 
 #include <qtest.h>
 #include <QtCore/qmetatype.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvector.h>
 
 class tst_QMetaType : public QObject
 {
@@ -46,6 +48,8 @@ private slots:
     void typeBuiltinNotNormalized();
     void typeCustom();
     void typeCustomNotNormalized();
+    void typeCustomMultipleThreads_data();
+    void typeCustomMultipleThreads();
     void typeNotRegistered();
     void typeNotRegisteredNotNormalized();
 
@@ -157,6 +161,56 @@ void tst_QMetaType::typeCustomNotNormalized()
     }
 }
 
+class LookupThread : public QThread
+{
+public:
+    QByteArray typeName;
+    int count = 0;
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i) {
+            const int type = QMetaType::type(typeName);
+            QMetaType::typeName(type);
+            QMetaType::sizeOf(type);
+        }
+    }
+};
+
+void tst_QMetaType::typeCustomMultipleThreads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    for (int threadCount : { 1, 2, 4, 8 })
+        QTest::addRow("%d threads", threadCount) << threadCount;
+}
+
+// QMetaType::type(), typeName() and sizeOf() from several threads at once,
+// with many custom types registered
+void tst_QMetaType::typeCustomMultipleThreads()
+{
+    QFETCH(int, threadCount);
+    for (int i = 0; i < 1000; ++i)
+        qRegisterMetaType<Foo>(("Foo" + QByteArray::number(i)).constData());
+
+    QVector<LookupThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        LookupThread *thread = new LookupThread;
+        thread->typeName = "Foo999";
+        thread->count = 10000;
+        threads.append(thread);
+    }
+
+    QBENCHMARK {
+        for (LookupThread *thread : qAsConst(threads))
+            thread->start();
+        for (LookupThread *thread : qAsConst(threads))
+            thread->wait();
+    }
+
+    qDeleteAll(threads);
+}
+
 void tst_QMetaType::typeNotRegistered()
 {
     Q_ASSERT(QMetaType::type("Bar") == 0);
@@ -28,6 +28,7 @@
 #include <QtCore>
 #include <QtWidgets/QTreeView>
 #include <qtest.h>
+#include <private/qobject_p.h>
 #include "object.h"
 #include <qcoreapplication.h>
 #include <qdatetime.h>
@@ -45,18 +46,48 @@ private slots:
     void signal_slot_benchmark_data();
     void signal_many_receivers();
     void signal_many_receivers_data();
+    void signal_slot_multiple_threads_data();
+    void signal_slot_multiple_threads();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void queued_emission_benchmark_data();
+    void queued_emission_benchmark();
+};
+
+class ValueSender : public QObject
+{
+Q_OBJECT
+signals:
+    void valueChanged(int value, const QString &text);
 };
 
 struct Functor {
     void operator()(){}
 };
 
+class EmitterThread : public QThread
+{
+Q_OBJECT
+public:
+    Object *sender = nullptr; // if null, the thread emits from an object of its own
+    int count = 0;
+
+protected:
+    void run() override
+    {
+        Object ownSender;
+        Object receiver;
+        QObject::connect(&ownSender, &Object::signal0, &receiver, &Object::slot0);
+        Object *emitter = sender ? sender : &ownSender;
+        for (int i = 0; i < count; ++i)
+            emitter->emitSignal0();
+    }
+};
+
 void QObjectBenchmark::signal_slot_benchmark_data()
 {
     QTest::addColumn<int>("type");
@@ -151,6 +182,43 @@ void QObjectBenchmark::signal_many_receivers()
     }
 }
 
+void QObjectBenchmark::signal_slot_multiple_threads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("sharedSender");
+    for (int threadCount : { 1, 2, 4, 8 }) {
+        QTest::addRow("%d threads, own senders", threadCount) << threadCount << false;
+        QTest::addRow("%d threads, shared sender", threadCount) << threadCount << true;
+    }
+}
+
+void QObjectBenchmark::signal_slot_multiple_threads()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, sharedSender);
+
+    Object sender;
+    Object receiver;
+    QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0, Qt::DirectConnection);
+
+    QVector<EmitterThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        EmitterThread *thread = new EmitterThread;
+        thread->sender = sharedSender ? &sender : nullptr;
+        thread->count = 100000;
+        threads.append(thread);
+    }
+
+    QBENCHMARK {
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->start();
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->wait();
+    }
+
+    qDeleteAll(threads);
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
@@ -258,6 +326,35 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+void QObjectBenchmark::queued_emission_benchmark_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::newRow("queued") << int(Qt::QueuedConnection);
+    QTest::newRow("queued, coalesced") << int(Qt::QueuedConnection | QObjectPrivate::CoalescedConnection);
+}
+
+void QObjectBenchmark::queued_emission_benchmark()
+{
+    QFETCH(int, type);
+
+    // a burst of emissions, such as progress updates, followed by a turn
+    // of the receiver's event loop
+    ValueSender sender;
+    QObject receiver;
+    int lastValue = -1;
+    QObject::connect(&sender, &ValueSender::valueChanged, &receiver,
+                     [&lastValue](int value, const QString &) { lastValue = value; },
+                     Qt::ConnectionType(type));
+    const QString text = QStringLiteral("progress");
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            emit sender.valueChanged(i, text);
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+    }
+    QCOMPARE(lastValue, 999);
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
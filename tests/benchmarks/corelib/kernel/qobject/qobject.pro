@@ -1,4 +1,4 @@
-QT += widgets testlib
+QT += widgets testlib core-private
 
 TEMPLATE = app
 TARGET = tst_bench_qobject
@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QThread>
+#include <QtTest/QtTest>
+
+#ifdef Q_OS_LINUX
+#  include <sys/eventfd.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
+class tst_QSocketNotifier : public QObject
+{
+    Q_OBJECT
+private slots:
+    void activity_data();
+    void activity();
+};
+
+#ifdef Q_OS_LINUX
+// Owns the descriptors and notifiers; lives in the thread whose event
+// dispatcher is being measured.
+class SocketFarm : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SocketFarm(QSemaphore *done) : done(done) {}
+
+    QVector<int> writeEnds;
+
+public slots:
+    void setUp(int idle, int active)
+    {
+        for (int i = 0; i < idle; ++i) {
+            const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd == -1)
+                qFatal("eventfd: %s", qPrintable(qt_error_string()));
+            ownedFds.append(fd);
+            notifiers.append(new QSocketNotifier(fd, QSocketNotifier::Read, this));
+        }
+
+        for (int i = 0; i < active; ++i) {
+            int fds[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) == -1)
+                qFatal("socketpair: %s", qPrintable(qt_error_string()));
+            ownedFds << fds[0] << fds[1];
+            writeEnds.append(fds[1]);
+            QSocketNotifier *notifier = new QSocketNotifier(fds[0], QSocketNotifier::Read, this);
+            connect(notifier, &QSocketNotifier::activated, this, &SocketFarm::readyRead);
+            notifiers.append(notifier);
+        }
+    }
+
+    void tearDown()
+    {
+        qDeleteAll(notifiers);
+        notifiers.clear();
+        for (int fd : qAsConst(ownedFds))
+            ::close(fd);
+        ownedFds.clear();
+        writeEnds.clear();
+    }
+
+private slots:
+    void readyRead(int fd)
+    {
+        char c;
+        while (::read(fd, &c, 1) == 1)
+            done->release();
+    }
+
+private:
+    QSemaphore *done;
+    QVector<QSocketNotifier *> notifiers;
+    QVector<int> ownedFds;
+};
+#endif
+
+void tst_QSocketNotifier::activity_data()
+{
+    QTest::addColumn<QByteArray>("mode");
+    QTest::addColumn<int>("idle");
+
+    static const struct {
+        const char *name;
+        const char *mode;
+    } backends[] = {
+        { "poll", "0" },
+        { "epoll", "1" },
+        { "epoll-edge", "2" }
+    };
+
+    for (const auto &backend : backends) {
+        for (int idle : { 0, 1000, 10000 }) {
+            QTest::addRow("%s, %d idle", backend.name, idle)
+                << QByteArray(backend.mode) << idle;
+        }
+    }
+}
+
+// one round trip through 100 active sockets while the dispatcher also
+// watches a number of idle descriptors
+void tst_QSocketNotifier::activity()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("This benchmark compares the Linux event dispatcher backends");
+#else
+    QFETCH(QByteArray, mode);
+    QFETCH(int, idle);
+    const int active = 100;
+
+    // QEventDispatcherUNIX picks its backend when it is created in the
+    // new thread, so keep the variable set until the thread is running
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", mode);
+    QThread thread;
+    thread.start();
+
+    QSemaphore done;
+    SocketFarm farm(&done);
+    farm.moveToThread(&thread);
+    QMetaObject::invokeMethod(&farm, "setUp", Qt::BlockingQueuedConnection,
+                              Q_ARG(int, idle), Q_ARG(int, active));
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+    QCOMPARE(farm.writeEnds.size(), active);
+
+    QBENCHMARK {
+        for (int fd : qAsConst(farm.writeEnds)) {
+            if (::write(fd, "x", 1) != 1)
+                QFAIL(qPrintable(qt_error_string()));
+        }
+        done.acquire(active);
+    }
+
+    QMetaObject::invokeMethod(&farm, "tearDown", Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+#endif
+}
+
+QTEST_MAIN(tst_QSocketNotifier)
+#include "main.moc"
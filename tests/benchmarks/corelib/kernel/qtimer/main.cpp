@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void startStop_data();
+    void startStop();
+    void restart_data();
+    void restart();
+    void activateWithManyTimers_data();
+    void activateWithManyTimers();
+};
+
+// counts the timer events it receives
+class TimerObject : public QObject
+{
+public:
+    int activations = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) override { ++activations; }
+};
+
+static void addTimerCounts()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("timerType");
+
+    for (int count : { 10, 1000, 10000 }) {
+        QTest::addRow("%d precise", count) << count << int(Qt::PreciseTimer);
+        QTest::addRow("%d coarse", count) << count << int(Qt::CoarseTimer);
+    }
+}
+
+// spread intervals so that timers are not started in timeout order
+static int intervalFor(int i)
+{
+    return 60000 + (i * 7919) % 30000;
+}
+
+void tst_QTimer::startStop_data()
+{
+    addTimerCounts();
+}
+
+void tst_QTimer::startStop()
+{
+    QFETCH(int, count);
+    QFETCH(int, timerType);
+
+    // one timer per object, like per-connection timeouts
+    std::unique_ptr<TimerObject[]> objects(new TimerObject[count]);
+    QVector<int> ids(count);
+
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            ids[i] = objects[i].startTimer(intervalFor(i), Qt::TimerType(timerType));
+        for (int i = 0; i < count; ++i)
+            objects[i].killTimer(ids.at(i));
+    }
+}
+
+void tst_QTimer::restart_data()
+{
+    addTimerCounts();
+}
+
+// the per-connection timeout pattern: every timer gets restarted while
+// many others stay registered
+void tst_QTimer::restart()
+{
+    QFETCH(int, count);
+    QFETCH(int, timerType);
+
+    std::unique_ptr<TimerObject[]> objects(new TimerObject[count]);
+    QVector<int> ids(count);
+    for (int i = 0; i < count; ++i)
+        ids[i] = objects[i].startTimer(intervalFor(i), Qt::TimerType(timerType));
+
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i) {
+            objects[i].killTimer(ids.at(i));
+            ids[i] = objects[i].startTimer(intervalFor(i), Qt::TimerType(timerType));
+        }
+    }
+
+    for (int i = 0; i < count; ++i)
+        objects[i].killTimer(ids.at(i));
+}
+
+void tst_QTimer::activateWithManyTimers_data()
+{
+    addTimerCounts();
+}
+
+// a zero timer firing 1000 times while many long timers are pending
+void tst_QTimer::activateWithManyTimers()
+{
+    QFETCH(int, count);
+    QFETCH(int, timerType);
+
+    std::unique_ptr<TimerObject[]> idle(new TimerObject[count]);
+    QVector<int> ids(count);
+    for (int i = 0; i < count; ++i)
+        ids[i] = idle[i].startTimer(intervalFor(i), Qt::TimerType(timerType));
+
+    TimerObject busy;
+    const int busyId = busy.startTimer(0);
+
+    QBENCHMARK {
+        busy.activations = 0;
+        while (busy.activations < 1000)
+            QCoreApplication::processEvents();
+    }
+
+    busy.killTimer(busyId);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(idle[i].activations, 0);
+        idle[i].killTimer(ids.at(i));
+    }
+}
+
+QTEST_MAIN(tst_QTimer)
+#include "main.moc"
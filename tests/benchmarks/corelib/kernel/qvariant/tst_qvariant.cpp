@@ -29,6 +29,7 @@
 #include <QtCore>
 #ifdef QT_GUI_LIB
 #  include <QtGui/QPixmap>
+#  include <QtGui/QTransform>
 #endif
 #include <qtest.h>
 
@@ -85,6 +86,13 @@ private slots:
     void createCoreType();
     void createCoreTypeCopy_data();
     void createCoreTypeCopy();
+
+    void rectFVariantRoundTrip();
+    void lineFVariantRoundTrip();
+    void bigClassVariantRoundTrip();
+#ifdef QT_GUI_LIB
+    void transformVariantRoundTrip();
+#endif
 };
 
 struct BigClass
@@ -373,6 +381,43 @@ void tst_qvariant::createCoreTypeCopy()
     }
 }
 
+// Stores values that don't fit in QVariant::Private::Data in a variant
+// and gets them back, like item models do with data().
+template <typename T>
+static void variantRoundTrip(const T &val)
+{
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i) {
+            const QVariant v = QVariant::fromValue(val);
+            QVariant copy = v;
+            copy.detach();
+            copy.value<T>();
+        }
+    }
+}
+
+void tst_qvariant::rectFVariantRoundTrip()
+{
+    variantRoundTrip(QRectF(1, 2, 3, 4));
+}
+
+void tst_qvariant::lineFVariantRoundTrip()
+{
+    variantRoundTrip(QLineF(1, 2, 3, 4));
+}
+
+void tst_qvariant::bigClassVariantRoundTrip()
+{
+    variantRoundTrip(BigClass());
+}
+
+#ifdef QT_GUI_LIB
+void tst_qvariant::transformVariantRoundTrip()
+{
+    variantRoundTrip(QTransform::fromTranslate(1, 2));
+}
+#endif
+
 QTEST_MAIN(tst_qvariant)
 
 #include "tst_qvariant.moc"
@@ -40,6 +40,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void tinyTasks_data();
+    void tinyTasks();
+    void tinyTasksFromWorkerThreads_data();
+    void tinyTasksFromWorkerThreads();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +79,82 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+enum { TinyTaskCount = 10000000 };
+
+static void addThreadCountRows()
+{
+    QTest::addColumn<int>("threadCount");
+    const int ideal = QThread::idealThreadCount();
+    for (int threadCount = 1; threadCount < ideal; threadCount *= 2)
+        QTest::addRow("%d threads", threadCount) << threadCount;
+    QTest::addRow("%d threads", ideal) << ideal;
+}
+
+class CountingRunnable : public QRunnable
+{
+public:
+    QAtomicInt &count;
+    CountingRunnable(QAtomicInt &count) : count(count) {}
+    void run() override {
+        count.ref();
+    }
+};
+
+void tst_QThreadPool::tinyTasks_data()
+{
+    addThreadCountRows();
+}
+
+void tst_QThreadPool::tinyTasks()
+{
+    QFETCH(int, threadCount);
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt count;
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < TinyTaskCount; ++i)
+            threadPool.start(new CountingRunnable(count));
+        threadPool.waitForDone();
+    }
+    QCOMPARE(count.load(), int(TinyTaskCount));
+}
+
+// splits its share of the tasks in two until only one is left
+class SplittingRunnable : public QRunnable
+{
+public:
+    QThreadPool &threadPool;
+    QAtomicInt &count;
+    int tasks;
+    SplittingRunnable(QThreadPool &threadPool, QAtomicInt &count, int tasks)
+        : threadPool(threadPool), count(count), tasks(tasks) {}
+    void run() override {
+        if (tasks == 1) {
+            count.ref();
+            return;
+        }
+        threadPool.start(new SplittingRunnable(threadPool, count, tasks / 2));
+        threadPool.start(new SplittingRunnable(threadPool, count, tasks - tasks / 2));
+    }
+};
+
+void tst_QThreadPool::tinyTasksFromWorkerThreads_data()
+{
+    addThreadCountRows();
+}
+
+void tst_QThreadPool::tinyTasksFromWorkerThreads()
+{
+    QFETCH(int, threadCount);
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt count;
+    QBENCHMARK_ONCE {
+        threadPool.start(new SplittingRunnable(threadPool, count, TinyTaskCount));
+        threadPool.waitForDone();
+    }
+    QCOMPARE(count.load(), int(TinyTaskCount));
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
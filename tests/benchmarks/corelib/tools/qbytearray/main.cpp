@@ -32,6 +32,9 @@
 #include <QString>
 
 #include <qtest.h>
+#include <private/qbytearray_p.h>
+
+#include <zlib.h>
 
 
 class tst_qbytearray : public QObject
@@ -48,6 +51,19 @@ private slots:
     void latin1Uppercasing_xlate_checked();
     void latin1Uppercasing_category();
     void latin1Uppercasing_bitcheck();
+
+    void crc32_zlib_data() { crc32_data(); }
+    void crc32_zlib();
+    void crc32_qt_data() { crc32_data(); }
+    void crc32_qt();
+    void crc32c_qt_data() { crc32_data(); }
+    void crc32c_qt();
+
+    void shortByteArrays_data();
+    void shortByteArrays();
+
+private:
+    void crc32_data();
 };
 
 void tst_qbytearray::initTestCase()
@@ -258,6 +274,72 @@ void tst_qbytearray::latin1Uppercasing_bitcheck()
     }
 }
 
+void tst_qbytearray::crc32_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("16")       << int(16);
+    QTest::newRow("256")      << int(256);
+    QTest::newRow("4096")     << int(4096);
+    QTest::newRow("65536")    << int(65536);
+    QTest::newRow("16777216") << int(16777216);
+}
+
+void tst_qbytearray::crc32_zlib()
+{
+    QFETCH(int, size);
+    const QByteArray data(size, 'x');
+    uLong crc = 0;
+    QBENCHMARK {
+        crc = ::crc32(crc, reinterpret_cast<const Bytef *>(data.constData()), uInt(size));
+    }
+}
+
+void tst_qbytearray::crc32_qt()
+{
+    QFETCH(int, size);
+    const QByteArray data(size, 'x');
+    quint32 crc = 0;
+    QBENCHMARK {
+        crc = qCrc32(data.constData(), size_t(size), crc);
+    }
+}
+
+void tst_qbytearray::crc32c_qt()
+{
+    QFETCH(int, size);
+    const QByteArray data(size, 'x');
+    quint32 crc = 0;
+    QBENCHMARK {
+        crc = qCrc32C(data.constData(), size_t(size), crc);
+    }
+}
+
+void tst_qbytearray::shortByteArrays_data()
+{
+    QTest::addColumn<int>("length");
+
+    QTest::newRow("4") << 4;
+    QTest::newRow("16") << 16;
+    QTest::newRow("64") << 64;
+}
+
+// Creates, detaches and destroys 1000 byte arrays of the given length
+void tst_qbytearray::shortByteArrays()
+{
+    QFETCH(int, length);
+
+    const QByteArray source(length, 'x');
+    qsizetype total = 0;
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            QByteArray copy(source.constData(), source.size());
+            copy[0] = char(i);
+            total += copy.size();
+        }
+    }
+    QVERIFY(total > 0);
+}
 
 QTEST_MAIN(tst_qbytearray)
 
@@ -1,7 +1,11 @@
 TEMPLATE = app
 TARGET = tst_bench_qbytearray
 
-QT = core testlib
+QT = core-private testlib
 
 TESTDATA += main.cpp
 SOURCES += main.cpp
+
+# for comparing with zlib's crc32()
+qtHaveModule(zlib_private): QT += zlib-private
+else: LIBS += -lz
@@ -50,6 +50,8 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashSmallBlobs_data();
+    void hashSmallBlobs();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -167,6 +169,37 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::hashSmallBlobs_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<QByteArrayList>("blobs");
+
+    // 1000 pieces of data of the given size, as in a content-addressed store
+    static const int blobsizes[] = { 32, 64, 256 };
+    for (int blobsize : blobsizes) {
+        QByteArrayList blobs;
+        for (int i = 0; i < 1000; ++i)
+            blobs << QByteArray::fromRawData(blockOfData.constData() + i * 16, blobsize);
+
+        for (int algo : { QCryptographicHash::Sha1, QCryptographicHash::Sha256 })
+            QTest::newRow(algoname(algo) + QByteArray::number(blobsize)) << algo << blobs;
+    }
+}
+
+void tst_bench_QCryptographicHash::hashSmallBlobs()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArrayList, blobs);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QByteArrayList results;
+        results.reserve(blobs.size());
+        for (const QByteArray &blob : qAsConst(blobs))
+            results.append(QCryptographicHash::hash(blob, algo));
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
@@ -0,0 +1,267 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <private/qflathash_p.h>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <qtest.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertInt_data() { sizes(); }
+    void insertInt();
+    void lookupInt_data() { sizes(); }
+    void lookupInt();
+    void missInt_data() { sizes(); }
+    void missInt();
+    void insertString_data() { sizes(); }
+    void insertString();
+    void lookupString_data() { sizes(); }
+    void lookupString();
+    void lookupLatin1_data() { sizes(); }
+    void lookupLatin1();
+    void iterate_data() { sizes(); }
+    void iterate();
+    void removeReinsert_data() { sizes(); }
+    void removeReinsert();
+
+private:
+    void sizes();
+};
+
+void tst_QFlatHash::sizes()
+{
+    QTest::addColumn<bool>("flat");
+    QTest::addColumn<int>("size");
+
+    const int sizes[] = { 100, 10000, 1000000 };
+    for (int size : sizes) {
+        const QByteArray sizeString = QByteArray::number(size);
+        QTest::newRow(("QHash-" + sizeString).constData()) << false << size;
+        QTest::newRow(("QFlatHash-" + sizeString).constData()) << true << size;
+    }
+}
+
+static QStringList makeKeys(int size)
+{
+    QStringList keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys.append(QLatin1String("symbol_") + QString::number(i * 7919));
+    return keys;
+}
+
+template <typename Hash>
+static void insertInt(int size)
+{
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < size; ++i)
+            hash.insert(i * 16, i);
+    }
+}
+
+void tst_QFlatHash::insertInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    if (flat)
+        ::insertInt<QFlatHash<int, int> >(size);
+    else
+        ::insertInt<QHash<int, int> >(size);
+}
+
+template <typename Hash>
+static void lookupInt(int size, int offset)
+{
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(i * 16, i);
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            sum += hash.value(i * 16 + offset);
+    }
+    QVERIFY(sum >= 0);
+}
+
+void tst_QFlatHash::lookupInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    if (flat)
+        ::lookupInt<QFlatHash<int, int> >(size, 0);
+    else
+        ::lookupInt<QHash<int, int> >(size, 0);
+}
+
+void tst_QFlatHash::missInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    if (flat)
+        ::lookupInt<QFlatHash<int, int> >(size, 1);
+    else
+        ::lookupInt<QHash<int, int> >(size, 1);
+}
+
+template <typename Hash>
+static void insertString(const QStringList &keys)
+{
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < keys.size(); ++i)
+            hash.insert(keys.at(i), i);
+    }
+}
+
+void tst_QFlatHash::insertString()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    const QStringList keys = makeKeys(size);
+    if (flat)
+        ::insertString<QFlatHash<QString, int> >(keys);
+    else
+        ::insertString<QHash<QString, int> >(keys);
+}
+
+template <typename Hash>
+static void lookupString(const QStringList &keys)
+{
+    Hash hash;
+    for (int i = 0; i < keys.size(); ++i)
+        hash.insert(keys.at(i), i);
+    int sum = 0;
+    QBENCHMARK {
+        for (const QString &key : keys)
+            sum += hash.value(key);
+    }
+    QVERIFY(sum >= 0);
+}
+
+void tst_QFlatHash::lookupString()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    const QStringList keys = makeKeys(size);
+    if (flat)
+        ::lookupString<QFlatHash<QString, int> >(keys);
+    else
+        ::lookupString<QHash<QString, int> >(keys);
+}
+
+// Looking up Latin-1 text, e.g. from a parser's input buffer: QHash needs a
+// QString for each lookup, QFlatHash takes the QLatin1String itself.
+void tst_QFlatHash::lookupLatin1()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    const QStringList keys = makeKeys(size);
+    QList<QByteArray> latin1Keys;
+    latin1Keys.reserve(size);
+    for (const QString &key : keys)
+        latin1Keys.append(key.toLatin1());
+
+    int sum = 0;
+    if (flat) {
+        QFlatHash<QString, int> hash;
+        for (int i = 0; i < keys.size(); ++i)
+            hash.insert(keys.at(i), i);
+        QBENCHMARK {
+            for (const QByteArray &key : latin1Keys)
+                sum += hash.value(QLatin1String(key));
+        }
+    } else {
+        QHash<QString, int> hash;
+        for (int i = 0; i < keys.size(); ++i)
+            hash.insert(keys.at(i), i);
+        QBENCHMARK {
+            for (const QByteArray &key : latin1Keys)
+                sum += hash.value(QString(QLatin1String(key)));
+        }
+    }
+    QVERIFY(sum >= 0);
+}
+
+template <typename Hash>
+static void iterate(int size)
+{
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(i * 16, i);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (typename Hash::const_iterator it = hash.constBegin(), end = hash.constEnd(); it != end; ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum >= 0);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    if (flat)
+        ::iterate<QFlatHash<int, int> >(size);
+    else
+        ::iterate<QHash<int, int> >(size);
+}
+
+template <typename Hash>
+static void removeReinsert(int size)
+{
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(i, i);
+    QBENCHMARK {
+        for (int i = 0; i < size; i += 2)
+            hash.remove(i);
+        for (int i = 0; i < size; i += 2)
+            hash.insert(i, i);
+    }
+}
+
+void tst_QFlatHash::removeReinsert()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+    if (flat)
+        ::removeReinsert<QFlatHash<int, int> >(size);
+    else
+        ::removeReinsert<QHash<int, int> >(size);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
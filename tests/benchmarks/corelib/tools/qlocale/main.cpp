@@ -28,6 +28,8 @@
 
 #include <QLocale>
 #include <QTest>
+#include <QVector>
+#include <qmath.h>
 
 class tst_QLocale : public QObject
 {
@@ -37,6 +39,10 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void numberToString();
+    void byteArrayNumber();
+    void stringToDouble();
+    void byteArrayToDouble();
 };
 
 static QString data()
@@ -65,6 +71,55 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+static QVector<double> doubles()
+{
+    QVector<double> values;
+    values.reserve(1000);
+    for (int i = 0; i < 1000; ++i)
+        values << qSin(i) * qPow(10, i % 12 - 4);
+    return values;
+}
+
+void tst_QLocale::numberToString()
+{
+    const QVector<double> values = doubles();
+    QBENCHMARK {
+        for (double d : values)
+            QString::number(d, 'g', QLocale::FloatingPointShortest);
+    }
+}
+
+void tst_QLocale::byteArrayNumber()
+{
+    const QVector<double> values = doubles();
+    QBENCHMARK {
+        for (double d : values)
+            QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    }
+}
+
+void tst_QLocale::stringToDouble()
+{
+    QStringList strings;
+    for (double d : doubles())
+        strings << QString::number(d, 'g', QLocale::FloatingPointShortest);
+    QBENCHMARK {
+        for (const QString &s : qAsConst(strings))
+            s.toDouble();
+    }
+}
+
+void tst_QLocale::byteArrayToDouble()
+{
+    QList<QByteArray> strings;
+    for (double d : doubles())
+        strings << QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    QBENCHMARK {
+        for (const QByteArray &s : qAsConst(strings))
+            s.toDouble();
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
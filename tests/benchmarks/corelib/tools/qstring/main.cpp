@@ -49,6 +49,9 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void shortStrings_data();
+    void shortStrings();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -188,6 +191,61 @@ void tst_QString::toCaseFolded()
     }
 }
 
+enum ShortStringWorkload {
+    CreateIds,
+    ConcatenateTags,
+    DetachCopies,
+    FillCells
+};
+
+void tst_QString::shortStrings_data()
+{
+    QTest::addColumn<int>("workload");
+
+    QTest::newRow("create ids") << int(CreateIds);
+    QTest::newRow("concatenate tags") << int(ConcatenateTags);
+    QTest::newRow("detach copies") << int(DetachCopies);
+    QTest::newRow("fill cells") << int(FillCells);
+}
+
+// Each workload creates and destroys 1000 strings of a few characters
+void tst_QString::shortStrings()
+{
+    QFETCH(int, workload);
+
+    const QString prefix = QStringLiteral("tag");
+    QStringList cells;
+    cells.reserve(1000);
+    qsizetype total = 0;
+
+    QBENCHMARK {
+        switch (workload) {
+        case CreateIds:
+            for (int i = 0; i < 1000; ++i)
+                total += QString::number(i).size();
+            break;
+        case ConcatenateTags:
+            for (int i = 0; i < 1000; ++i)
+                total += (prefix + QLatin1Char(char('a' + i % 26))).size();
+            break;
+        case DetachCopies:
+            for (int i = 0; i < 1000; ++i) {
+                QString copy = prefix;
+                copy[0] = QLatin1Char('T');
+                total += copy.size();
+            }
+            break;
+        case FillCells:
+            for (int i = 0; i < 1000; ++i)
+                cells.append(QString::fromLatin1("cell") + QString::number(i % 100));
+            total += cells.size();
+            cells.clear();
+            break;
+        }
+    }
+    QVERIFY(total > 0);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
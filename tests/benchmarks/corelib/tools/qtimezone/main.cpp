@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QTimeZone>
+#include <QDateTime>
 #include <QTest>
 #include <qdebug.h>
 
@@ -36,8 +37,35 @@ class tst_QTimeZone : public QObject
 
 private Q_SLOTS:
     void isTimeZoneIdAvailable();
+    void systemZone();
+    void zoneByName_data();
+    void zoneByName();
+    void offsetFromUtc_data();
+    void offsetFromUtc();
+    void toTimeZone();
 };
 
+static QList<QByteArray> enoughZones()
+{
+    const QList<QByteArray> available = QTimeZone::availableTimeZoneIds();
+    QList<QByteArray> result;
+    // Some zones in each region, rather than the whole database
+    for (int i = 0; i < available.size(); i += 7)
+        result << available.at(i);
+    return result;
+}
+
+static QVector<qint64> enoughTimes()
+{
+    QVector<qint64> result;
+    const qint64 start = QDateTime(QDate(1900, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    const qint64 end = QDateTime(QDate(2100, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    const qint64 step = (end - start) / 997;
+    for (qint64 t = start; t < end; t += step)
+        result << t;
+    return result;
+}
+
 void tst_QTimeZone::isTimeZoneIdAvailable()
 {
     const QList<QByteArray> available = QTimeZone::availableTimeZoneIds();
@@ -47,6 +75,66 @@ void tst_QTimeZone::isTimeZoneIdAvailable()
     }
 }
 
+void tst_QTimeZone::systemZone()
+{
+    QBENCHMARK {
+        QTimeZone::systemTimeZone();
+    }
+}
+
+void tst_QTimeZone::zoneByName_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::newRow("UTC") << QByteArray("UTC");
+    QTest::newRow("Europe/Oslo") << QByteArray("Europe/Oslo");
+    QTest::newRow("America/Los_Angeles") << QByteArray("America/Los_Angeles");
+    QTest::newRow("Australia/Brisbane") << QByteArray("Australia/Brisbane");
+}
+
+void tst_QTimeZone::zoneByName()
+{
+    QFETCH(QByteArray, name);
+    QTimeZone zone;
+    QBENCHMARK {
+        zone = QTimeZone(name);
+    }
+    Q_UNUSED(zone);
+}
+
+void tst_QTimeZone::offsetFromUtc_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::newRow("UTC") << QByteArray("UTC");
+    QTest::newRow("Europe/Oslo") << QByteArray("Europe/Oslo");
+    QTest::newRow("America/Los_Angeles") << QByteArray("America/Los_Angeles");
+    QTest::newRow("Australia/Brisbane") << QByteArray("Australia/Brisbane");
+}
+
+void tst_QTimeZone::offsetFromUtc()
+{
+    QFETCH(QByteArray, name);
+    const QTimeZone zone(name);
+    const QVector<qint64> times = enoughTimes();
+    int total = 0;
+    QBENCHMARK {
+        for (qint64 t : times)
+            total += zone.offsetFromUtc(QDateTime::fromMSecsSinceEpoch(t, Qt::UTC));
+    }
+    Q_UNUSED(total);
+}
+
+void tst_QTimeZone::toTimeZone()
+{
+    QVector<QTimeZone> zones;
+    for (const QByteArray &id : enoughZones())
+        zones << QTimeZone(id);
+    const QDateTime utc(QDate(2018, 6, 1), QTime(12, 0), Qt::UTC);
+    QBENCHMARK {
+        for (const QTimeZone &zone : qAsConst(zones))
+            utc.toTimeZone(zone).time();
+    }
+}
+
 QTEST_MAIN(tst_QTimeZone)
 
 #include "main.moc"
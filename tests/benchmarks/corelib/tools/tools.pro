@@ -6,6 +6,7 @@ SUBDIRS = \
         qcontiguouscache \
         qcryptographichash \
         qdatetime \
+        qflathash \
         qlist \
         qlocale \
         qmap \
@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 SUBDIRS = \
         drawtexture \
         qcolor \
+        qpdfwriter \
         qpainter \
         qregion \
         qtransform \
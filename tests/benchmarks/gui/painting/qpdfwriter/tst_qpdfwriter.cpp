@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QBuffer>
+#include <QPainter>
+#include <QPdfWriter>
+
+// this test benchmarks exporting text to PDF, which is dominated by embedding
+// font subsets (QFontSubset) for the fonts used in the document
+class tst_QPdfWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void exportText_data();
+    void exportText();
+};
+
+void tst_QPdfWriter::exportText_data()
+{
+    QTest::addColumn<QString>("text");
+
+    QString latin = QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod "
+                                   "tempor incididunt ut labore et dolore magna aliqua. ");
+    // a few hundred distinct CJK Unified Ideographs, so that the subsets are sizable
+    QString cjk;
+    for (ushort uc = 0x4E00; uc < 0x4E00 + 600; ++uc) {
+        cjk += QChar(uc);
+        if (uc % 40 == 0)
+            cjk += QChar(0x3002);
+    }
+
+    QTest::newRow("latin") << latin.repeated(40);
+    QTest::newRow("cjk") << cjk.repeated(2);
+    QTest::newRow("mixed") << (latin + cjk).repeated(2);
+}
+
+void tst_QPdfWriter::exportText()
+{
+    QFETCH(QString, text);
+
+    // each iteration exports a separate document, like batch PDF generation does
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QPdfWriter writer(&buffer);
+        writer.setPageSize(QPagedPaintDevice::A4);
+        QPainter painter(&writer);
+        const QRect rect = painter.viewport().adjusted(500, 500, -500, -500);
+        painter.drawText(rect, Qt::TextWordWrap, text);
+        painter.end();
+    }
+}
+
+QTEST_MAIN(tst_QPdfWriter)
+
+#include "tst_qpdfwriter.moc"
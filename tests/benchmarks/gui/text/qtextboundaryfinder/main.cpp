@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTextBoundaryFinder>
+#include <QTextLayout>
+#include <qtest.h>
+
+// this test benchmarks the determination of text boundaries (QUnicodeTools::initCharAttributes),
+// both directly and as part of laying out text
+class tst_QTextBoundaryFinder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void boundaryFinder_data();
+    void boundaryFinder();
+    void layout_data();
+    void layout();
+
+private:
+    void addTextData();
+};
+
+static QString repeated(const QString &s, int size)
+{
+    QString result;
+    result.reserve(size + s.size());
+    while (result.size() < size)
+        result += s;
+    return result;
+}
+
+void tst_QTextBoundaryFinder::addTextData()
+{
+    QTest::addColumn<QString>("text");
+
+    const QString latin = QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do "
+                                         "eiusmod tempor incididunt ut labore et dolore magna aliqua 1234. ");
+    // a run of CJK Unified Ideographs, followed by an ideographic full stop
+    QString cjk;
+    for (ushort uc = 0x4E2D; uc < 0x4E2D + 48; ++uc)
+        cjk += QChar(uc);
+    cjk += QChar(0x3002);
+    const QString mixed = latin + cjk;
+    const QString accented = QString::fromUtf8("D\xc3\xa9j\xc3\xa0 vu, na\xc3\xafve fa\xc3\xa7" "ade, "
+                                               "cre\xcc\x80me bru\xcc\x82le\xcc\x81" "e. ");
+
+    QTest::newRow("latin") << repeated(latin, 16 * 1024);
+    QTest::newRow("cjk") << repeated(cjk, 16 * 1024);
+    QTest::newRow("mixed") << repeated(mixed, 16 * 1024);
+    QTest::newRow("accented") << repeated(accented, 16 * 1024);
+}
+
+void tst_QTextBoundaryFinder::boundaryFinder_data()
+{
+    addTextData();
+}
+
+void tst_QTextBoundaryFinder::boundaryFinder()
+{
+    QFETCH(QString, text);
+
+    QBENCHMARK {
+        QTextBoundaryFinder graphemes(QTextBoundaryFinder::Grapheme, text);
+        QTextBoundaryFinder words(QTextBoundaryFinder::Word, text);
+        QTextBoundaryFinder lines(QTextBoundaryFinder::Line, text);
+    }
+}
+
+void tst_QTextBoundaryFinder::layout_data()
+{
+    addTextData();
+}
+
+void tst_QTextBoundaryFinder::layout()
+{
+    QFETCH(QString, text);
+
+    QBENCHMARK {
+        QTextLayout layout(text);
+        layout.beginLayout();
+        forever {
+            QTextLine line = layout.createLine();
+            if (!line.isValid())
+                break;
+            line.setLineWidth(400);
+        }
+        layout.endLayout();
+    }
+}
+
+QTEST_MAIN(tst_QTextBoundaryFinder)
+
+#include "main.moc"
@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_QTextBoundaryFinder
+QT += testlib
+SOURCES += main.cpp
@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 SUBDIRS = \
         qfontmetrics \
         qtext \
+        qtextboundaryfinder \
         qtextdocument